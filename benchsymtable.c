@@ -0,0 +1,534 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: benchsymtable.c
+ *
+ *  Description: Benchmarks a SymTable implementation. The symbol
+ *  table is first built with a given number of bindings, then a
+ *  workload of gets, puts and removes is run against it, and finally
+ *  it is freed. For each phase, the number of operations, operations
+ *  per second and nanoseconds per operation are reported, together
+ *  with the peak resident set size of the process. Keys are computed
+ *  from their index as they are needed, so that the benchmark itself
+ *  holds no memory proportional to the size of the symbol table. In
+ *  profiling mode, each phase is also measured with hardware event
+ *  counters. The memory workload instead reports the bytes held per
+ *  binding by tables of growing size.
+ ******************************************************************* */
+#define _POSIX_C_SOURCE 200809L
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "symtable.h"
+#include "perfcounters.h"
+
+/* Declaring an enum to hold the number of hexadecimal digits at the
+   end of every key, and the longest key allowed. */
+enum{KEY_DIGITS = 16, MAX_KEY_LENGTH = 1024};
+
+/* The workloads run after the symbol table is built. The lifecycle
+   workload gets and then removes every binding, in two phases. The
+   memory workload builds tables itself, and times nothing. */
+enum Workload {WORKLOAD_UNIFORM, WORKLOAD_ZIPF, WORKLOAD_INSERT,
+               WORKLOAD_DELETE, WORKLOAD_LIFECYCLE, WORKLOAD_MEMORY};
+
+/* The names of the workloads, in the order of enum Workload. */
+static const char *workloadNames[] = {"uniform", "zipf", "insert",
+                                      "delete", "lifecycle", "memory"};
+
+/* The parameters of a benchmark run. */
+struct BenchConfig {
+   /* The number of bindings the symbol table is built with. */
+   unsigned long long size;
+
+   /* The number of operations in the workload. */
+   unsigned long long numOps;
+
+   /* The workload, and the fraction of its gets that miss. */
+   enum Workload workload;
+   double missRatio;
+
+   /* The length of every key. */
+   int keyLength;
+
+   /* The exponent of the Zipfian distribution. */
+   double zipfTheta;
+
+   /* The seed of the random number generator. */
+   unsigned long long seed;
+};
+
+/* The state of a Zipfian distribution over the ranks 0 to n-1, as
+   generated by Gray et al.'s method. */
+struct Zipf {
+   double n;
+   double theta;
+   double alpha;
+   double zetaN;
+   double eta;
+};
+
+/* The state of the xorshift64* random number generator. */
+static unsigned long long randomState;
+
+/* The value of every binding. */
+static int benchValue;
+
+/* The hardware event counters of each phase, or NULL if not
+   profiling. */
+static PerfCounters_T benchCounters;
+
+/* Returns the next pseudo-random 64-bit number. */
+static unsigned long long Bench_random(void) {
+   randomState ^= randomState >> 12;
+   randomState ^= randomState << 25;
+   randomState ^= randomState >> 27;
+   return randomState * 0x2545F4914F6CDD1DULL;
+}
+
+/* Returns a pseudo-random number uniformly distributed in [0, 1). */
+static double Bench_random01(void) {
+   return (double)(Bench_random() >> 11) / 9007199254740992.0;
+}
+
+/* Returns a pseudo-random number uniformly distributed in [0, n). */
+static unsigned long long Bench_randomBelow(unsigned long long n) {
+   return Bench_random() % n;
+}
+
+/* Initializes *zipf for ranks 0 to n-1 with exponent theta (between
+   0 and 1). Takes time proportional to n. */
+static void Bench_zipfInit(struct Zipf *zipf, unsigned long long n,
+                           double theta) {
+   unsigned long long i;
+   double zeta2;
+
+   zipf->n = (double)n;
+   zipf->theta = theta;
+   zipf->alpha = 1.0 / (1.0 - theta);
+   zipf->zetaN = 0.0;
+   for (i = 1; i <= n; i++) {
+      zipf->zetaN += 1.0 / pow((double)i, theta);
+   }
+   zeta2 = 1.0 + 1.0 / pow(2.0, theta);
+   zipf->eta = (1.0 - pow(2.0 / (double)n, 1.0 - theta)) /
+               (1.0 - zeta2 / zipf->zetaN);
+}
+
+/* Returns a rank drawn from the Zipfian distribution *zipf, rank 0
+   being the most frequent. */
+static unsigned long long Bench_zipfNext(const struct Zipf *zipf) {
+   double u = Bench_random01();
+   double uz = u * zipf->zetaN;
+   unsigned long long rank;
+
+   if (uz < 1.0) {
+      return 0;
+   }
+   if (uz < 1.0 + pow(0.5, zipf->theta)) {
+      return 1;
+   }
+   rank = (unsigned long long)
+      (zipf->n * pow(zipf->eta * u - zipf->eta + 1.0, zipf->alpha));
+   return rank < (unsigned long long)zipf->n ? rank :
+          (unsigned long long)zipf->n - 1;
+}
+
+/* Writes into key the key of index, keyLength characters long: a
+   fixed padding followed by the hexadecimal digits of a bijective
+   scrambling of index, so that distinct indices give distinct
+   keys. */
+static void Bench_makeKey(char *key, unsigned long long index,
+                          int keyLength) {
+   static const char digits[] = "0123456789abcdef";
+   unsigned long long h = index;
+   int i;
+
+   h = (h ^ (h >> 31)) * 0x7FB5D329728EA185ULL;
+   h = (h ^ (h >> 27)) * 0x81DADEF4BC2DD44DULL;
+   h ^= h >> 33;
+
+   for (i = keyLength - 1; i >= keyLength - KEY_DIGITS; i--) {
+      key[i] = digits[h & 0xF];
+      h >>= 4;
+   }
+   key[keyLength] = '\0';
+}
+
+/* Returns the present time in nanoseconds. */
+static unsigned long long Bench_now(void) {
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return (unsigned long long)now.tv_sec * 1000000000 +
+          (unsigned long long)now.tv_nsec;
+}
+
+/* Returns the peak resident set size of the process in kilobytes. */
+static long Bench_peakRSS(void) {
+   struct rusage usage;
+
+   getrusage(RUSAGE_SELF, &usage);
+   return usage.ru_maxrss;
+}
+
+/* Writes a line reporting that phase of the run configured by
+   *config performed numOps operations in nanos nanoseconds. */
+static void Bench_report(const char *program,
+                         const struct BenchConfig *config,
+                         const char *phase, unsigned long long numOps,
+                         unsigned long long nanos) {
+   double seconds = (double)nanos / 1e9;
+
+   if (seconds <= 0.0) {
+      seconds = 1e-9;
+   }
+   printf("%s size %llu keylen %d workload %s miss %.2f phase %-6s "
+          "ops %llu ops/sec %.0f ns/op %.1f peak-rss-kb %ld\n",
+          program, config->size, config->keyLength,
+          workloadNames[config->workload], config->missRatio, phase,
+          numOps, (double)numOps / seconds,
+          numOps == 0 ? 0.0 : (double)nanos / (double)numOps,
+          Bench_peakRSS());
+}
+
+/* Starts measuring a phase, and returns the time at which it
+   starts. */
+static unsigned long long Bench_startPhase(void) {
+   if (benchCounters != NULL) {
+      PerfCounters_start(benchCounters);
+   }
+   return Bench_now();
+}
+
+/* Finishes measuring phase of the run configured by *config, which
+   started at time startNanos and performed numOps operations, and
+   reports it. */
+static void Bench_endPhase(const char *program,
+                           const struct BenchConfig *config,
+                           const char *phase, unsigned long long numOps,
+                           unsigned long long startNanos) {
+   unsigned long long nanos = Bench_now() - startNanos;
+
+   if (benchCounters != NULL) {
+      PerfCounters_stop(benchCounters);
+   }
+   Bench_report(program, config, phase, numOps, nanos);
+   if (benchCounters != NULL) {
+      PerfCounters_print(benchCounters, stdout, "   counters", numOps);
+   }
+}
+
+/* Runs the workload of *config against symTable, which holds the
+   bindings of indices 0 to size-1, drawing the indices of a Zipfian
+   workload from *zipf (which is NULL for other workloads), and
+   returns the number of operations
+   performed. The keys of missing bindings have indices from size
+   up. */
+static unsigned long long Bench_runWorkload(SymTable_T symTable,
+                                            const struct BenchConfig
+                                            *config,
+                                            const struct Zipf *zipf,
+                                            char *key) {
+   unsigned long long i, index, nextIndex = config->size;
+   unsigned long long found = 0;
+   unsigned long long choice;
+
+   for (i = 0; i < config->numOps; i++) {
+      choice = Bench_randomBelow(100);
+      switch (config->workload) {
+         case WORKLOAD_UNIFORM:
+         case WORKLOAD_ZIPF:
+            /* Gets only. */
+            if (Bench_random01() < config->missRatio) {
+               index = config->size + Bench_randomBelow(config->size);
+            }
+            else if (config->workload == WORKLOAD_ZIPF) {
+               index = Bench_zipfNext(zipf);
+            }
+            else {
+               index = Bench_randomBelow(config->size);
+            }
+            Bench_makeKey(key, index, config->keyLength);
+            found += SymTable_get(symTable, key) != NULL;
+            break;
+
+         case WORKLOAD_INSERT:
+            /* 80% puts of new keys, 20% gets of present ones. */
+            if (choice < 80) {
+               Bench_makeKey(key, nextIndex++, config->keyLength);
+               found += (unsigned long long)
+                  SymTable_put(symTable, key, &benchValue);
+            }
+            else {
+               Bench_makeKey(key, Bench_randomBelow(nextIndex),
+                             config->keyLength);
+               found += SymTable_get(symTable, key) != NULL;
+            }
+            break;
+
+         case WORKLOAD_DELETE:
+            /* 50% removes, 30% puts and 20% gets, of random keys
+               of the original bindings. */
+            Bench_makeKey(key, Bench_randomBelow(config->size),
+                          config->keyLength);
+            if (choice < 50) {
+               found += SymTable_remove(symTable, key) != NULL;
+            }
+            else if (choice < 80) {
+               found += (unsigned long long)
+                  SymTable_put(symTable, key, &benchValue);
+            }
+            else {
+               found += SymTable_get(symTable, key) != NULL;
+            }
+            break;
+
+         case WORKLOAD_LIFECYCLE:
+         case WORKLOAD_MEMORY:
+            /* Run by Bench_runLifecycle and Bench_runMemory
+               instead. */
+            break;
+      }
+   }
+
+   /* Printing the count of successful operations keeps the
+      compiler from discarding them. */
+   fprintf(stderr, "%llu of %llu operations found or added a binding\n",
+           found, config->numOps);
+   return config->numOps;
+}
+
+/* Gets, and then removes, every binding of symTable, which holds the
+   bindings of indices 0 to size-1, as testLargeTable of
+   testsymtable.c does, measuring each as a phase. */
+static void Bench_runLifecycle(SymTable_T symTable, const char *program,
+                               const struct BenchConfig *config,
+                               char *key) {
+   unsigned long long i, startNanos, found = 0;
+
+   startNanos = Bench_startPhase();
+   for (i = 0; i < config->size; i++) {
+      Bench_makeKey(key, i, config->keyLength);
+      found += SymTable_get(symTable, key) != NULL;
+   }
+   Bench_endPhase(program, config, "get", config->size, startNanos);
+
+   startNanos = Bench_startPhase();
+   for (i = 0; i < config->size; i++) {
+      Bench_makeKey(key, i, config->keyLength);
+      found += SymTable_remove(symTable, key) != NULL;
+   }
+   Bench_endPhase(program, config, "remove", config->size, startNanos);
+
+   fprintf(stderr, "%llu of %llu operations found a binding\n",
+           found, 2 * config->size);
+}
+
+/* Builds symbol tables of 100, 1000, and so on up to size bindings,
+   and reports the bytes each holds per binding, split as
+   SymTable_memoryUsage splits them. Returns 0, or 1 if there is
+   insufficient memory available. */
+static int Bench_runMemory(const char *program,
+                           const struct BenchConfig *config, char *key) {
+   struct SymTable_MemoryUsage usage;
+   SymTable_T symTable;
+   unsigned long long i, n;
+   double perBinding;
+
+   for (n = 100; n <= config->size; n *= 10) {
+      symTable = SymTable_new();
+      if (symTable == NULL) {
+         return 1;
+      }
+      for (i = 0; i < n; i++) {
+         Bench_makeKey(key, i, config->keyLength);
+         if (!SymTable_put(symTable, key, &benchValue)) {
+            SymTable_free(symTable);
+            return 1;
+         }
+      }
+
+      (void)SymTable_memoryUsage(symTable, &usage);
+      perBinding = 1.0 / (double)n;
+      printf("%s size %llu keylen %d bytes/binding %.1f node %.1f "
+             "key %.1f bucket %.1f overhead %.1f total-bytes %lu\n",
+             program, n, config->keyLength,
+             (double)usage.totalBytes * perBinding,
+             (double)usage.nodeBytes * perBinding,
+             (double)usage.keyBytes * perBinding,
+             (double)usage.bucketBytes * perBinding,
+             (double)usage.overheadBytes * perBinding,
+             (unsigned long)usage.totalBytes);
+      SymTable_free(symTable);
+   }
+   return 0;
+}
+
+/* Writes the usage of program to stderr. */
+static void Bench_usage(const char *program) {
+   fprintf(stderr,
+           "Usage: %s [-n size] [-o ops] [-m missratio] [-k keylength]\n"
+           "          [-w uniform|zipf|insert|delete|lifecycle|memory]\n"
+           "          [-z theta] [-s seed] [-p]\n",
+           program);
+}
+
+/* Builds a symbol table of the configured size, runs the configured
+   workload against it and frees it, reporting each phase. Returns 0,
+   or 1 if the arguments are invalid or there is insufficient memory
+   available. */
+int main(int argc, char *argv[]) {
+   struct BenchConfig config;
+   struct Zipf zipf;
+   SymTable_T symTable;
+   char key[MAX_KEY_LENGTH + 1];
+   const char *program;
+   unsigned long long i, startNanos, numOps;
+   int arg, workload, isKnown, isProfiling = 0;
+
+   program = strrchr(argv[0], '/') != NULL ? strrchr(argv[0], '/') + 1
+                                           : argv[0];
+
+   config.size = 1000000;
+   config.numOps = 0;
+   config.workload = WORKLOAD_UNIFORM;
+   config.missRatio = 0.0;
+   config.keyLength = KEY_DIGITS;
+   config.zipfTheta = 0.99;
+   config.seed = 1;
+
+   /* Reading the options. All but -p take a value. */
+   for (arg = 1; arg < argc; arg += 2) {
+      if (argv[arg][0] != '-' || argv[arg][1] == '\0' ||
+          argv[arg][2] != '\0') {
+         Bench_usage(program);
+         return 1;
+      }
+      if (argv[arg][1] == 'p') {
+         isProfiling = 1;
+         arg--;
+         continue;
+      }
+      if (arg + 1 >= argc) {
+         Bench_usage(program);
+         return 1;
+      }
+      switch (argv[arg][1]) {
+         case 'n':
+            config.size = strtoull(argv[arg + 1], NULL, 10);
+            break;
+         case 'o':
+            config.numOps = strtoull(argv[arg + 1], NULL, 10);
+            break;
+         case 'm':
+            config.missRatio = atof(argv[arg + 1]);
+            break;
+         case 'k':
+            config.keyLength = atoi(argv[arg + 1]);
+            break;
+         case 'z':
+            config.zipfTheta = atof(argv[arg + 1]);
+            break;
+         case 's':
+            config.seed = strtoull(argv[arg + 1], NULL, 10);
+            break;
+         case 'w':
+            isKnown = 0;
+            for (workload = 0; workload <= WORKLOAD_MEMORY;
+                 workload++) {
+               if (strcmp(argv[arg + 1], workloadNames[workload]) == 0) {
+                  config.workload = (enum Workload)workload;
+                  isKnown = 1;
+               }
+            }
+            if (!isKnown) {
+               Bench_usage(program);
+               return 1;
+            }
+            break;
+         default:
+            Bench_usage(program);
+            return 1;
+      }
+   }
+   if (config.size == 0 || config.keyLength < KEY_DIGITS ||
+       config.keyLength > MAX_KEY_LENGTH || config.missRatio < 0.0 ||
+       config.missRatio > 1.0 || config.zipfTheta <= 0.0 ||
+       config.zipfTheta >= 1.0) {
+      Bench_usage(program);
+      return 1;
+   }
+   if (config.numOps == 0) {
+      config.numOps = config.size;
+   }
+   randomState = config.seed != 0 ? config.seed : 1;
+
+   /* Opening the hardware event counters, if profiling. Events the
+      machine cannot count are reported as n/a. */
+   if (isProfiling) {
+      benchCounters = PerfCounters_new();
+      if (benchCounters == NULL) {
+         fprintf(stderr, "%s: insufficient memory\n", program);
+         return 1;
+      }
+   }
+
+   /* Filling the fixed padding of every key. */
+   memset(key, 'k', sizeof(key));
+
+   if (config.workload == WORKLOAD_MEMORY) {
+      if (Bench_runMemory(program, &config, key)) {
+         fprintf(stderr, "%s: insufficient memory\n", program);
+         return 1;
+      }
+      return 0;
+   }
+
+   /* Building the symbol table. */
+   symTable = SymTable_new();
+   if (symTable == NULL) {
+      fprintf(stderr, "%s: insufficient memory\n", program);
+      return 1;
+   }
+   startNanos = Bench_startPhase();
+   for (i = 0; i < config.size; i++) {
+      Bench_makeKey(key, i, config.keyLength);
+      if (!SymTable_put(symTable, key, &benchValue)) {
+         fprintf(stderr, "%s: insufficient memory\n", program);
+         return 1;
+      }
+   }
+   Bench_endPhase(program, &config, "build", config.size, startNanos);
+
+   /* Running the workload, after setting up its distribution. */
+   if (config.workload == WORKLOAD_LIFECYCLE) {
+      Bench_runLifecycle(symTable, program, &config, key);
+   }
+   else {
+      if (config.workload == WORKLOAD_ZIPF) {
+         Bench_zipfInit(&zipf, config.size, config.zipfTheta);
+      }
+      startNanos = Bench_startPhase();
+      numOps = Bench_runWorkload(symTable, &config,
+                                 config.workload == WORKLOAD_ZIPF ?
+                                 &zipf : NULL, key);
+      Bench_endPhase(program, &config, workloadNames[config.workload],
+                     numOps, startNanos);
+   }
+
+   /* Freeing the symbol table. */
+   numOps = SymTable_getLength(symTable);
+   startNanos = Bench_startPhase();
+   SymTable_free(symTable);
+   Bench_endPhase(program, &config, "free", numOps, startNanos);
+
+   if (benchCounters != NULL) {
+      PerfCounters_free(benchCounters);
+   }
+   return 0;
+}
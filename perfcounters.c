@@ -0,0 +1,237 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: perfcounters.c
+ *
+ *  Description: Implements a PerfCounters data type, which counts
+ *  cycles, instructions, L1 data cache misses, last level cache
+ *  misses, branch misses and data TLB misses over a section of a
+ *  program. Each event is opened separately, so that an event the
+ *  machine cannot count (as in many virtual machines, or when
+ *  perf_event_paranoid forbids it) leaves the others usable. Where
+ *  perf_event_open does not exist, every event is unavailable.
+ ******************************************************************* */
+#define _GNU_SOURCE
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "perfcounters.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+/* A PerfCounters structure holds, for each event, the file
+   descriptor counting it (-1 if it is unavailable) and its count
+   over the last section measured. */
+struct PerfCounters {
+   /* The file descriptors of the events. */
+   int fds[PERF_NUM_EVENTS];
+
+   /* The counts of the events, scaled up if the kernel counted an
+      event for only part of the section. */
+   unsigned long long counts[PERF_NUM_EVENTS];
+};
+
+/* The names of the events, in the order of enum PerfCounters_Event. */
+static const char *eventNames[PERF_NUM_EVENTS] =
+   {"cycles", "instructions", "L1d-misses", "LLC-misses",
+    "branch-misses", "dTLB-misses"};
+
+#ifdef __linux__
+/* Returns a file descriptor counting event in user space for the
+   calling thread, disabled, or -1 if event cannot be counted. */
+static int PerfCounters_open(enum PerfCounters_Event event) {
+   struct perf_event_attr attr;
+
+   memset(&attr, 0, sizeof(attr));
+   attr.size = sizeof(attr);
+   attr.disabled = 1;
+   attr.exclude_kernel = 1;
+   attr.exclude_hv = 1;
+   attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                      PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+   switch (event) {
+      case PERF_CYCLES:
+         attr.type = PERF_TYPE_HARDWARE;
+         attr.config = PERF_COUNT_HW_CPU_CYCLES;
+         break;
+      case PERF_INSTRUCTIONS:
+         attr.type = PERF_TYPE_HARDWARE;
+         attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+         break;
+      case PERF_L1D_MISSES:
+         attr.type = PERF_TYPE_HW_CACHE;
+         attr.config = PERF_COUNT_HW_CACHE_L1D |
+                       (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+         break;
+      case PERF_LLC_MISSES:
+         attr.type = PERF_TYPE_HARDWARE;
+         attr.config = PERF_COUNT_HW_CACHE_MISSES;
+         break;
+      case PERF_BRANCH_MISSES:
+         attr.type = PERF_TYPE_HARDWARE;
+         attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+         break;
+      case PERF_DTLB_MISSES:
+         attr.type = PERF_TYPE_HW_CACHE;
+         attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                       (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+         break;
+      default:
+         return -1;
+   }
+
+   return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+/* Returns a new PerfCounters object, with every event the machine
+   can count opened, or NULL if there is insufficient memory
+   available. */
+PerfCounters_T PerfCounters_new(void) {
+   PerfCounters_T counters;
+   int i;
+
+   counters = (PerfCounters_T)calloc(1, sizeof(struct PerfCounters));
+   if (counters == NULL) {
+      return NULL;
+   }
+   for (i = 0; i < PERF_NUM_EVENTS; i++) {
+#ifdef __linux__
+      counters->fds[i] = PerfCounters_open((enum PerfCounters_Event)i);
+#else
+      counters->fds[i] = -1;
+#endif
+   }
+   return counters;
+}
+
+/* Frees all memory and file descriptors occupied by counters. */
+void PerfCounters_free(PerfCounters_T counters) {
+   int i;
+
+   assert(counters != NULL);
+
+#ifdef __linux__
+   for (i = 0; i < PERF_NUM_EVENTS; i++) {
+      if (counters->fds[i] >= 0) {
+         close(counters->fds[i]);
+      }
+   }
+#else
+   (void)i;
+#endif
+   free(counters);
+}
+
+/* Returns 1 if counters can count event, or 0 otherwise. */
+int PerfCounters_isAvailable(PerfCounters_T counters,
+                             enum PerfCounters_Event event) {
+   assert(counters != NULL);
+   assert((int)event >= 0 && event < PERF_NUM_EVENTS);
+   return counters->fds[event] >= 0;
+}
+
+/* Resets every available event of counters to 0 and starts counting
+   it. */
+void PerfCounters_start(PerfCounters_T counters) {
+   int i;
+
+   assert(counters != NULL);
+
+   for (i = 0; i < PERF_NUM_EVENTS; i++) {
+      counters->counts[i] = 0;
+#ifdef __linux__
+      if (counters->fds[i] >= 0) {
+         ioctl(counters->fds[i], PERF_EVENT_IOC_RESET, 0);
+         ioctl(counters->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+      }
+#endif
+   }
+}
+
+/* Stops counting the events of counters, and records their counts
+   since PerfCounters_start. An event that cannot be read becomes
+   unavailable. */
+void PerfCounters_stop(PerfCounters_T counters) {
+   int i;
+#ifdef __linux__
+   unsigned long long values[3];
+#endif
+
+   assert(counters != NULL);
+
+   for (i = 0; i < PERF_NUM_EVENTS; i++) {
+#ifdef __linux__
+      if (counters->fds[i] < 0) {
+         continue;
+      }
+      ioctl(counters->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+      if (read(counters->fds[i], values, sizeof(values)) !=
+          (ssize_t)sizeof(values)) {
+         close(counters->fds[i]);
+         counters->fds[i] = -1;
+         continue;
+      }
+
+      /* Scaling the count up if the event shared its counter with
+         others for part of the section. */
+      if (values[2] != 0 && values[2] < values[1]) {
+         values[0] = (unsigned long long)
+            ((double)values[0] * (double)values[1] / (double)values[2]);
+      }
+      counters->counts[i] = values[0];
+#endif
+   }
+}
+
+/* Returns the count of event over the last section measured by
+   counters, or 0 if event is unavailable. */
+unsigned long long PerfCounters_get(PerfCounters_T counters,
+                                    enum PerfCounters_Event event) {
+   assert(counters != NULL);
+   assert((int)event >= 0 && event < PERF_NUM_EVENTS);
+   return counters->counts[event];
+}
+
+/* Writes to stream a line, starting with label, giving the count of
+   each available event of counters over the last section measured
+   and its count per operation over numOps operations, together with
+   the instructions per cycle. Unavailable events are written as
+   "n/a". */
+void PerfCounters_print(PerfCounters_T counters, FILE *stream,
+                        const char *label, unsigned long long numOps) {
+   int i;
+
+   assert(counters != NULL);
+   assert(stream != NULL);
+   assert(label != NULL);
+
+   fprintf(stream, "%s", label);
+   for (i = 0; i < PERF_NUM_EVENTS; i++) {
+      if (counters->fds[i] < 0) {
+         fprintf(stream, " %s n/a", eventNames[i]);
+      }
+      else {
+         fprintf(stream, " %s %llu (%.2f/op)", eventNames[i],
+                 counters->counts[i], numOps == 0 ? 0.0 :
+                 (double)counters->counts[i] / (double)numOps);
+      }
+   }
+   if (counters->fds[PERF_CYCLES] >= 0 &&
+       counters->fds[PERF_INSTRUCTIONS] >= 0 &&
+       counters->counts[PERF_CYCLES] != 0) {
+      fprintf(stream, " IPC %.2f",
+              (double)counters->counts[PERF_INSTRUCTIONS] /
+              (double)counters->counts[PERF_CYCLES]);
+   }
+   fprintf(stream, "\n");
+}
@@ -0,0 +1,34 @@
+#ifndef PERFCOUNTERS_INCLUDED
+#define PERFCOUNTERS_INCLUDED
+
+#include <stdio.h>
+
+/* A PerfCounters object counts hardware events of the calling thread
+   between PerfCounters_start and PerfCounters_stop, using the Linux
+   perf_event_open interface. Events that the kernel or the processor
+   cannot count are reported as unavailable. */
+
+enum PerfCounters_Event {PERF_CYCLES, PERF_INSTRUCTIONS, PERF_L1D_MISSES,
+                         PERF_LLC_MISSES, PERF_BRANCH_MISSES,
+                         PERF_DTLB_MISSES, PERF_NUM_EVENTS};
+
+typedef struct PerfCounters *PerfCounters_T;
+
+PerfCounters_T PerfCounters_new(void);
+
+void PerfCounters_free(PerfCounters_T counters);
+
+int PerfCounters_isAvailable(PerfCounters_T counters,
+                             enum PerfCounters_Event event);
+
+void PerfCounters_start(PerfCounters_T counters);
+
+void PerfCounters_stop(PerfCounters_T counters);
+
+unsigned long long PerfCounters_get(PerfCounters_T counters,
+                                    enum PerfCounters_Event event);
+
+void PerfCounters_print(PerfCounters_T counters, FILE *stream,
+                        const char *label, unsigned long long numOps);
+
+#endif
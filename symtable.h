@@ -2,9 +2,18 @@
 #define SYMTABLE_INCLUDED
 
 #include <stdlib.h>
+#include "symtablebackend.h"
 
 typedef struct SymTable *SymTable_T;
 
+struct SymTable_MemoryUsage {
+   size_t nodeBytes;
+   size_t keyBytes;
+   size_t bucketBytes;
+   size_t overheadBytes;
+   size_t totalBytes;
+};
+
 SymTable_T SymTable_new(void);
 
 void SymTable_free (SymTable_T symTable);
@@ -23,8 +32,11 @@ void *SymTable_get(SymTable_T symTable, const char *key);
 
 void *SymTable_remove(SymTable_T symTable, const char *key);
 
-void SynTable_map(SymTable_T symTable, void (functionApply)
+void SymTable_map(SymTable_T symTable, void (*functionApply)
                   (const char *key, void *value, void *extra),
                   const void *extra);
 
+size_t SymTable_memoryUsage(SymTable_T symTable,
+                            struct SymTable_MemoryUsage *usage);
+
 #endif
@@ -0,0 +1,103 @@
+#ifndef SYMTABLEARRAY_INCLUDED
+#define SYMTABLEARRAY_INCLUDED
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "symtableutil.h"
+
+/* Large arrays shared by the hash table implementations
+   (symtablehash.c and symtablecompact.c): an array of at least
+   MAP_THRESHOLD bytes is mapped directly from the system, with a hint
+   to back it with huge pages so that lookups take fewer TLB misses,
+   and is grown with mremap, which moves pages rather than copying
+   bytes. A smaller array comes from malloc. A file including this
+   header must define _GNU_SOURCE before its first include, for
+   mremap. */
+
+/* Declaring an enum to hold the size in bytes (that of a huge page)
+   from which arrays are mapped from the system rather than allocated
+   with malloc. */
+enum{MAP_THRESHOLD = 2 * 1024 * 1024};
+
+/* Returns the address of a new array of bytes bytes, mapped from the
+   system if it is large, or NULL if there is insufficient memory
+   available. */
+static SYMTABLE_INLINE void *SymTable_allocArray(size_t bytes) {
+   void *block;
+
+   if (bytes < MAP_THRESHOLD) {
+      return malloc(bytes);
+   }
+   block = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if (block == MAP_FAILED) {
+      return NULL;
+   }
+#ifdef MADV_HUGEPAGE
+   (void)madvise(block, bytes, MADV_HUGEPAGE);
+#endif
+   return block;
+}
+
+/* Frees block, an array of bytes bytes from SymTable_allocArray or
+   SymTable_resizeArray (or from malloc, if it is small). */
+static SYMTABLE_INLINE void SymTable_freeArray(void *block,
+                                               size_t bytes) {
+   if (bytes < MAP_THRESHOLD) {
+      free(block);
+   }
+   else {
+      (void)munmap(block, bytes);
+   }
+}
+
+/* Returns the address of an array of newBytes bytes (newBytes being
+   larger than oldBytes) beginning with the oldBytes bytes of block,
+   an array from SymTable_allocArray or SymTable_resizeArray (or from
+   malloc, if it is small), which it replaces. Returns NULL (leaving
+   block unchanged) if there is insufficient memory available. */
+static SYMTABLE_INLINE void *SymTable_resizeArray(void *block,
+                                                  size_t oldBytes,
+                                                  size_t newBytes) {
+   void *newBlock;
+
+   if (newBytes < MAP_THRESHOLD) {
+      return realloc(block, newBytes);
+   }
+
+   /* Letting the system move the pages of a mapped array. */
+   if (oldBytes >= MAP_THRESHOLD) {
+      newBlock = mremap(block, oldBytes, newBytes, MREMAP_MAYMOVE);
+      if (newBlock == MAP_FAILED) {
+         return NULL;
+      }
+#ifdef MADV_HUGEPAGE
+      (void)madvise(newBlock, newBytes, MADV_HUGEPAGE);
+#endif
+      return newBlock;
+   }
+
+   newBlock = SymTable_allocArray(newBytes);
+   if (newBlock == NULL) {
+      return NULL;
+   }
+   memcpy(newBlock, block, oldBytes);
+   free(block);
+   return newBlock;
+}
+
+/* Adds to *overhead the bytes used for block, an array of requested
+   bytes from SymTable_allocArray or SymTable_resizeArray (or from
+   malloc, if it is small), beyond the requested bytes, and returns
+   requested. */
+static SYMTABLE_INLINE size_t SymTable_arrayBytes(const void *block,
+                                                  size_t requested,
+                                                  size_t *overhead) {
+   if (requested < MAP_THRESHOLD) {
+      return SymTable_blockBytes(block, requested, overhead);
+   }
+   return requested;
+}
+
+#endif
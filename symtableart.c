@@ -0,0 +1,1074 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: symtableart.c
+ *
+ *  Description: Implements a SymTable data type (collection of key-
+ *  -value bindings) as an adaptive radix tree, with functions to
+ *  allow its client to insert (put) new bindings, to retrieve (get)
+ *  the values of bindings with specified keys, and to remove
+ *  bindings with specified keys. This ADT additionally allows for a
+ *  SymTable structure to be freed if it is no longer to be used, for
+ *  a function to be applied to all key-value pairs or to those whose
+ *  keys start with a given prefix, for all bindings under a prefix
+ *  to be removed at once, for the value for a specified key to be
+ *  replaced, and for checking if a SymTable contains a given key.
+ *
+ *  The bytes shared by the keys under an inner node are stored once,
+ *  in that node, so that a lookup compares each byte of its key only
+ *  once on the way down. Each leaf holds the defensive copy of its
+ *  whole key, which is the key passed to the functions applied to
+ *  bindings. The terminating null byte of a key takes part in the
+ *  tree like any other byte, so no key ends inside another key's
+ *  path.
+ ******************************************************************* */
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "symtableart.h"
+#include "symtableutil.h"
+
+/* Declaring an enum to hold the kinds of inner nodes, each able to
+   hold up to the given number of children. */
+enum{NODE4, NODE16, NODE48, NODE256};
+
+/* Declaring an enum to hold the number of children below which a
+   node is shrunk into the next smaller kind. */
+enum{SHRINK16 = 3, SHRINK48 = 12, SHRINK256 = 37};
+
+/* Every inner node starts with an ARTNode header. The bytes of the
+   node's compressed path (its prefix) are stored directly after the
+   kind-specific part of the node. */
+struct ARTNode {
+   /* The kind of node, NODE4 through NODE256. */
+   unsigned char type;
+
+   /* The number of children presently in the node. */
+   unsigned short numChildren;
+
+   /* The number of prefix bytes stored after the node. */
+   size_t prefixLen;
+};
+
+/* An inner node with up to 4 children, whose bytes are kept sorted. */
+struct ARTNode4 {
+   struct ARTNode header;
+   unsigned char keys[4];
+   void *children[4];
+};
+
+/* An inner node with up to 16 children, whose bytes are kept
+   sorted. */
+struct ARTNode16 {
+   struct ARTNode header;
+   unsigned char keys[16];
+   void *children[16];
+};
+
+/* An inner node with up to 48 children, indexed through a table of
+   256 bytes holding one more than the position of each child. */
+struct ARTNode48 {
+   struct ARTNode header;
+   unsigned char childIndex[256];
+   void *children[48];
+};
+
+/* An inner node with one child slot for each possible byte. */
+struct ARTNode256 {
+   struct ARTNode header;
+   void *children[256];
+};
+
+/* Each binding is stored in an ARTLeaf, followed by the bytes of its
+   key. Addresses of leaves are tagged by setting their lowest bit. */
+struct ARTLeaf {
+   /* The address of the value. */
+   const void *value;
+};
+
+/* A SymTable structure is a 'manager' structure that contains the
+   root of the tree and the total number of bindings. */
+struct SymTable {
+   /* The address of the root, an inner node or a tagged leaf. */
+   void *root;
+
+   /* The number of bindings (key-value pairs) presently in
+      the symbol table. */
+   int numBindings;
+};
+
+/* The sizes of the kinds of inner nodes, without their prefixes. */
+static const size_t nodeSizes[] = {sizeof(struct ARTNode4),
+                                   sizeof(struct ARTNode16),
+                                   sizeof(struct ARTNode48),
+                                   sizeof(struct ARTNode256)};
+
+/* Returns 1 if the address p refers to a leaf, or 0 if it refers to
+   an inner node. */
+static int SymTable_isLeaf(const void *p) {
+   return (int)((uintptr_t)p & 1);
+}
+
+/* Returns the leaf referred to by the tagged address p. */
+static struct ARTLeaf *SymTable_leaf(const void *p) {
+   return (struct ARTLeaf *)((uintptr_t)p & ~(uintptr_t)1);
+}
+
+/* Returns the key of leaf. */
+static char *SymTable_leafKey(struct ARTLeaf *leaf) {
+   return (char *)(leaf + 1);
+}
+
+/* Returns the prefix bytes of the inner node node. */
+static char *SymTable_prefix(struct ARTNode *node) {
+   return (char *)node + nodeSizes[node->type];
+}
+
+/* Returns a new leaf holding value and a copy of key, tagged as a
+   leaf, or NULL if there is insufficient memory available. */
+static void *SymTable_newLeaf(const char *key, const void *value) {
+   struct ARTLeaf *leaf;
+
+   leaf = (struct ARTLeaf *)malloc(sizeof(struct ARTLeaf) +
+                                   strlen(key) + 1);
+   if (leaf == NULL) {
+      return NULL;
+   }
+   leaf->value = value;
+   strcpy(SymTable_leafKey(leaf), key);
+   return (void *)((uintptr_t)leaf | 1);
+}
+
+/* Returns a new inner node of kind type with no children, whose
+   prefix is the prefixLen bytes at prefix, or NULL if there is
+   insufficient memory available. */
+static struct ARTNode *SymTable_newNode(int type, const char *prefix,
+                                        size_t prefixLen) {
+   struct ARTNode *node;
+
+   node = (struct ARTNode *)calloc(1, nodeSizes[type] + prefixLen);
+   if (node == NULL) {
+      return NULL;
+   }
+   node->type = (unsigned char)type;
+   node->numChildren = 0;
+   node->prefixLen = prefixLen;
+   memcpy(SymTable_prefix(node), prefix, prefixLen);
+   return node;
+}
+
+/* Returns the address of the slot of node holding the child for
+   byte, or NULL if node has no such child. */
+static void **SymTable_findChild(struct ARTNode *node,
+                                 unsigned char byte) {
+   int i;
+
+   switch (node->type) {
+   case NODE4: {
+      struct ARTNode4 *node4 = (struct ARTNode4 *)node;
+      for (i = 0; i < node->numChildren; i++) {
+         if (node4->keys[i] == byte) {
+            return &node4->children[i];
+         }
+      }
+      return NULL;
+   }
+   case NODE16: {
+      struct ARTNode16 *node16 = (struct ARTNode16 *)node;
+#ifdef __SSE2__
+      /* Comparing byte with all 16 keys at once, and keeping only
+         the matches among the keys in use. */
+      __m128i matches = _mm_cmpeq_epi8(
+         _mm_set1_epi8((char)byte),
+         _mm_loadu_si128((const __m128i *)node16->keys));
+      int bits = _mm_movemask_epi8(matches) &
+                 ((1 << node->numChildren) - 1);
+      if (bits != 0) {
+         return &node16->children[__builtin_ctz((unsigned int)bits)];
+      }
+#else
+      for (i = 0; i < node->numChildren; i++) {
+         if (node16->keys[i] == byte) {
+            return &node16->children[i];
+         }
+      }
+#endif
+      return NULL;
+   }
+   case NODE48: {
+      struct ARTNode48 *node48 = (struct ARTNode48 *)node;
+      if (node48->childIndex[byte] != 0) {
+         return &node48->children[node48->childIndex[byte] - 1];
+      }
+      return NULL;
+   }
+   default: {
+      struct ARTNode256 *node256 = (struct ARTNode256 *)node;
+      if (node256->children[byte] != NULL) {
+         return &node256->children[byte];
+      }
+      return NULL;
+   }
+   }
+}
+
+/* Inserts child for byte into the sorted keys and children of a
+   NODE4 or NODE16 that has room for it. */
+static void SymTable_insertSorted(unsigned char *keys, void **children,
+                                  int numChildren, unsigned char byte,
+                                  void *child) {
+   int i = 0;
+
+   while (i < numChildren && keys[i] < byte) {
+      i++;
+   }
+   memmove(keys + i + 1, keys + i, (size_t)(numChildren - i));
+   memmove(children + i + 1, children + i,
+           (size_t)(numChildren - i) * sizeof(void *));
+   keys[i] = byte;
+   children[i] = child;
+}
+
+/* Copies the children of node into newNode, a node of a different
+   kind with room for them all. */
+static void SymTable_copyChildren(struct ARTNode *newNode,
+                                  struct ARTNode *node) {
+   unsigned char keys[256];
+   void *children[256];
+   int n = 0;
+   int i;
+
+   /* Gathering the children of node in byte order. */
+   switch (node->type) {
+   case NODE4:
+      memcpy(keys, ((struct ARTNode4 *)node)->keys, node->numChildren);
+      memcpy(children, ((struct ARTNode4 *)node)->children,
+             node->numChildren * sizeof(void *));
+      n = node->numChildren;
+      break;
+   case NODE16:
+      memcpy(keys, ((struct ARTNode16 *)node)->keys, node->numChildren);
+      memcpy(children, ((struct ARTNode16 *)node)->children,
+             node->numChildren * sizeof(void *));
+      n = node->numChildren;
+      break;
+   case NODE48:
+      for (i = 0; i < 256; i++) {
+         if (((struct ARTNode48 *)node)->childIndex[i] != 0) {
+            keys[n] = (unsigned char)i;
+            children[n] = ((struct ARTNode48 *)node)->children
+               [((struct ARTNode48 *)node)->childIndex[i] - 1];
+            n++;
+         }
+      }
+      break;
+   default:
+      for (i = 0; i < 256; i++) {
+         if (((struct ARTNode256 *)node)->children[i] != NULL) {
+            keys[n] = (unsigned char)i;
+            children[n] = ((struct ARTNode256 *)node)->children[i];
+            n++;
+         }
+      }
+      break;
+   }
+
+   /* Storing them in newNode. */
+   switch (newNode->type) {
+   case NODE4:
+      memcpy(((struct ARTNode4 *)newNode)->keys, keys, (size_t)n);
+      memcpy(((struct ARTNode4 *)newNode)->children, children,
+             (size_t)n * sizeof(void *));
+      break;
+   case NODE16:
+      memcpy(((struct ARTNode16 *)newNode)->keys, keys, (size_t)n);
+      memcpy(((struct ARTNode16 *)newNode)->children, children,
+             (size_t)n * sizeof(void *));
+      break;
+   case NODE48:
+      for (i = 0; i < n; i++) {
+         ((struct ARTNode48 *)newNode)->childIndex[keys[i]] =
+            (unsigned char)(i + 1);
+         ((struct ARTNode48 *)newNode)->children[i] = children[i];
+      }
+      break;
+   default:
+      for (i = 0; i < n; i++) {
+         ((struct ARTNode256 *)newNode)->children[keys[i]] = children[i];
+      }
+      break;
+   }
+   newNode->numChildren = (unsigned short)n;
+}
+
+/* Replaces node, whose address is stored at *nodeRef, with a node of
+   kind type holding the same prefix and children. Returns the new
+   node, or NULL (leaving node in place) if there is insufficient
+   memory available. */
+static struct ARTNode *SymTable_resize(void **nodeRef,
+                                       struct ARTNode *node, int type) {
+   struct ARTNode *newNode;
+
+   newNode = SymTable_newNode(type, SymTable_prefix(node),
+                              node->prefixLen);
+   if (newNode == NULL) {
+      return NULL;
+   }
+   SymTable_copyChildren(newNode, node);
+   *nodeRef = newNode;
+   free(node);
+   return newNode;
+}
+
+/* Adds child for byte to node, whose address is stored at *nodeRef,
+   growing node into a larger kind if it is full. Returns 1, or 0
+   (leaving node unchanged) if there is insufficient memory
+   available. */
+static int SymTable_addChild(void **nodeRef, struct ARTNode *node,
+                             unsigned char byte, void *child) {
+   struct ARTNode48 *node48;
+   int i;
+
+   switch (node->type) {
+   case NODE4:
+      if (node->numChildren < 4) {
+         SymTable_insertSorted(((struct ARTNode4 *)node)->keys,
+                               ((struct ARTNode4 *)node)->children,
+                               node->numChildren, byte, child);
+         break;
+      }
+      node = SymTable_resize(nodeRef, node, NODE16);
+      return node != NULL && SymTable_addChild(nodeRef, node, byte,
+                                               child);
+   case NODE16:
+      if (node->numChildren < 16) {
+         SymTable_insertSorted(((struct ARTNode16 *)node)->keys,
+                               ((struct ARTNode16 *)node)->children,
+                               node->numChildren, byte, child);
+         break;
+      }
+      node = SymTable_resize(nodeRef, node, NODE48);
+      return node != NULL && SymTable_addChild(nodeRef, node, byte,
+                                               child);
+   case NODE48:
+      if (node->numChildren < 48) {
+         node48 = (struct ARTNode48 *)node;
+         for (i = 0; node48->children[i] != NULL; i++) {
+         }
+         node48->children[i] = child;
+         node48->childIndex[byte] = (unsigned char)(i + 1);
+         break;
+      }
+      node = SymTable_resize(nodeRef, node, NODE256);
+      return node != NULL && SymTable_addChild(nodeRef, node, byte,
+                                               child);
+   default:
+      ((struct ARTNode256 *)node)->children[byte] = child;
+      break;
+   }
+   node->numChildren++;
+   return 1;
+}
+
+/* Replaces node, a NODE4 whose address is stored at *nodeRef and
+   which has a single child left, with that child, moving node's
+   prefix and the child's byte to the front of the child's prefix if
+   the child is an inner node (a leaf holds its whole key already).
+   Leaves node in place if there is insufficient memory available. */
+static void SymTable_collapse(void **nodeRef, struct ARTNode *node) {
+   struct ARTNode4 *node4 = (struct ARTNode4 *)node;
+   void *child = node4->children[0];
+   unsigned char byte = node4->keys[0];
+   size_t prefixLen = node->prefixLen;
+   struct ARTNode *inner;
+   char *prefix;
+
+   if (SymTable_isLeaf(child)) {
+      *nodeRef = child;
+   }
+   else {
+      inner = (struct ARTNode *)child;
+      inner = (struct ARTNode *)realloc(inner, nodeSizes[inner->type] +
+                                        prefixLen + 1 +
+                                        inner->prefixLen);
+      if (inner == NULL) {
+         return;
+      }
+      prefix = SymTable_prefix(inner);
+      memmove(prefix + prefixLen + 1, prefix, inner->prefixLen);
+      memcpy(prefix, SymTable_prefix(node), prefixLen);
+      prefix[prefixLen] = (char)byte;
+      inner->prefixLen += prefixLen + 1;
+      *nodeRef = inner;
+   }
+   free(node);
+}
+
+/* Removes the child for byte from node, whose address is stored at
+   *nodeRef, shrinking node into a smaller kind, or replacing it by
+   its only remaining child, when it holds few enough children. */
+static void SymTable_removeChild(void **nodeRef, struct ARTNode *node,
+                                 unsigned char byte) {
+   struct ARTNode4 *node4;
+   struct ARTNode16 *node16;
+   struct ARTNode48 *node48;
+   int i, n = node->numChildren;
+
+   switch (node->type) {
+   case NODE4:
+      node4 = (struct ARTNode4 *)node;
+      for (i = 0; node4->keys[i] != byte; i++) {
+      }
+      memmove(node4->keys + i, node4->keys + i + 1, (size_t)(n - i - 1));
+      memmove(node4->children + i, node4->children + i + 1,
+              (size_t)(n - i - 1) * sizeof(void *));
+      node->numChildren--;
+      if (node->numChildren == 1) {
+         SymTable_collapse(nodeRef, node);
+      }
+      break;
+   case NODE16:
+      node16 = (struct ARTNode16 *)node;
+      for (i = 0; node16->keys[i] != byte; i++) {
+      }
+      memmove(node16->keys + i, node16->keys + i + 1,
+              (size_t)(n - i - 1));
+      memmove(node16->children + i, node16->children + i + 1,
+              (size_t)(n - i - 1) * sizeof(void *));
+      node->numChildren--;
+      if (node->numChildren <= SHRINK16) {
+         (void)SymTable_resize(nodeRef, node, NODE4);
+      }
+      break;
+   case NODE48:
+      node48 = (struct ARTNode48 *)node;
+      node48->children[node48->childIndex[byte] - 1] = NULL;
+      node48->childIndex[byte] = 0;
+      node->numChildren--;
+      if (node->numChildren <= SHRINK48) {
+         (void)SymTable_resize(nodeRef, node, NODE16);
+      }
+      break;
+   default:
+      ((struct ARTNode256 *)node)->children[byte] = NULL;
+      node->numChildren--;
+      if (node->numChildren <= SHRINK256) {
+         (void)SymTable_resize(nodeRef, node, NODE48);
+      }
+      break;
+   }
+}
+
+/* Returns 1 if leaf, reached at position depth of key, holds key,
+   or 0 otherwise. */
+static int SymTable_leafMatches(struct ARTLeaf *leaf, const char *key,
+                                size_t depth) {
+   /* A leaf reached through the null byte of key holds key. */
+   if (depth > 0 && key[depth - 1] == '\0') {
+      return 1;
+   }
+   return strcmp(key + depth, SymTable_leafKey(leaf) + depth) == 0;
+}
+
+/* Returns the number of leading bytes of the prefix of node that
+   match the bytes of key starting at position depth. */
+static size_t SymTable_matchPrefix(struct ARTNode *node,
+                                   const char *key, size_t depth) {
+   const char *prefix = SymTable_prefix(node);
+   size_t i;
+
+   /* Prefixes never contain a null byte, so the end of key is
+      always a mismatch. */
+   for (i = 0; i < node->prefixLen && prefix[i] == key[depth + i]; i++) {
+   }
+   return i;
+}
+
+/* Returns the leaf of symTable that holds key, or NULL if there is
+   none. */
+static struct ARTLeaf *SymTable_find(SymTable_T symTable,
+                                     const char *key) {
+   void *node = symTable->root;
+   void **slot;
+   size_t depth = 0;
+
+   while (node != NULL) {
+      if (SymTable_isLeaf(node)) {
+         if (SymTable_leafMatches(SymTable_leaf(node), key, depth)) {
+            return SymTable_leaf(node);
+         }
+         return NULL;
+      }
+
+      if (SymTable_matchPrefix((struct ARTNode *)node, key, depth) !=
+          ((struct ARTNode *)node)->prefixLen) {
+         return NULL;
+      }
+      depth += ((struct ARTNode *)node)->prefixLen;
+
+      slot = SymTable_findChild((struct ARTNode *)node,
+                                (unsigned char)key[depth]);
+      if (slot == NULL) {
+         return NULL;
+      }
+      node = *slot;
+      depth++;
+   }
+   return NULL;
+}
+
+/* Applies functionApply to every binding in the subtree rooted at
+   node, in key order. */
+static void SymTable_mapNode(void *node, void (*functionApply)
+                             (const char *key, void *value, void *extra),
+                             const void *extra) {
+   struct ARTNode *inner;
+   struct ARTLeaf *leaf;
+   void *child;
+   int i, numSlots;
+
+   if (SymTable_isLeaf(node)) {
+      leaf = SymTable_leaf(node);
+      (*functionApply)(SymTable_leafKey(leaf), (void *)leaf->value,
+                       (void *)extra);
+      return;
+   }
+
+   /* Sorted nodes are walked by position, the others by byte. */
+   inner = (struct ARTNode *)node;
+   numSlots = (inner->type == NODE4 || inner->type == NODE16) ?
+              inner->numChildren : 256;
+   for (i = 0; i < numSlots; i++) {
+      switch (inner->type) {
+      case NODE4:
+         child = ((struct ARTNode4 *)inner)->children[i];
+         break;
+      case NODE16:
+         child = ((struct ARTNode16 *)inner)->children[i];
+         break;
+      case NODE48:
+         child = ((struct ARTNode48 *)inner)->childIndex[i] == 0 ? NULL :
+                 ((struct ARTNode48 *)inner)->children
+                    [((struct ARTNode48 *)inner)->childIndex[i] - 1];
+         break;
+      default:
+         child = ((struct ARTNode256 *)inner)->children[i];
+         break;
+      }
+      if (child != NULL) {
+         SymTable_mapNode(child, functionApply, extra);
+      }
+   }
+}
+
+/* Frees the subtree rooted at node. */
+static void SymTable_freeNode(void *node) {
+   struct ARTNode *inner;
+   void **slot;
+   int i;
+
+   if (SymTable_isLeaf(node)) {
+      free(SymTable_leaf(node));
+      return;
+   }
+
+   inner = (struct ARTNode *)node;
+   for (i = 0; i < 256; i++) {
+      slot = SymTable_findChild(inner, (unsigned char)i);
+      if (slot != NULL) {
+         SymTable_freeNode(*slot);
+      }
+   }
+   free(inner);
+}
+
+/* Adds the bytes held by the subtree rooted at node to *usage. The
+   bytes of leaves that hold keys count as key bytes. */
+static void SymTable_nodeUsage(void *node,
+                               struct SymTable_MemoryUsage *usage) {
+   struct ARTNode *inner;
+   struct ARTLeaf *leaf;
+   size_t keyBytes;
+   void **slot;
+   int i;
+
+   if (SymTable_isLeaf(node)) {
+      leaf = SymTable_leaf(node);
+      keyBytes = strlen(SymTable_leafKey(leaf)) + 1;
+      usage->nodeBytes += SymTable_blockBytes
+         (leaf, sizeof(struct ARTLeaf) + keyBytes,
+          &usage->overheadBytes) - keyBytes;
+      usage->keyBytes += keyBytes;
+      return;
+   }
+
+   inner = (struct ARTNode *)node;
+   usage->nodeBytes += SymTable_blockBytes
+      (inner, nodeSizes[inner->type] + inner->prefixLen,
+       &usage->overheadBytes);
+   for (i = 0; i < 256; i++) {
+      slot = SymTable_findChild(inner, (unsigned char)i);
+      if (slot != NULL) {
+         SymTable_nodeUsage(*slot, usage);
+      }
+   }
+}
+
+/* Counts the bindings in the subtree rooted at node. */
+static size_t SymTable_countNode(void *node) {
+   void **slot;
+   size_t count = 0;
+   int i;
+
+   if (SymTable_isLeaf(node)) {
+      return 1;
+   }
+   for (i = 0; i < 256; i++) {
+      slot = SymTable_findChild((struct ARTNode *)node, (unsigned char)i);
+      if (slot != NULL) {
+         count += SymTable_countNode(*slot);
+      }
+   }
+   return count;
+}
+
+/* Finds the subtree of symTable holding exactly the bindings whose
+   keys start with prefix. Returns the address of the slot referring
+   to it, or NULL if there are no such bindings. Stores the number of
+   key bytes above the subtree in *depth, and the node holding the
+   slot and the byte of the slot in *parent and *byte (*parent is
+   NULL if the slot is the root). */
+static void **SymTable_findPrefix(SymTable_T symTable,
+                                  const char *prefix, size_t *depth,
+                                  struct ARTNode **parent,
+                                  unsigned char *byte) {
+   void **nodeRef = &symTable->root;
+   struct ARTNode *inner;
+   struct ARTLeaf *leaf;
+   size_t matched, rest;
+   void **slot;
+
+   *depth = 0;
+   *parent = NULL;
+   while (*nodeRef != NULL) {
+      if (SymTable_isLeaf(*nodeRef)) {
+         leaf = SymTable_leaf(*nodeRef);
+         rest = strlen(prefix + *depth);
+         if (strncmp(SymTable_leafKey(leaf) + *depth, prefix + *depth,
+                     rest) == 0) {
+            return nodeRef;
+         }
+         return NULL;
+      }
+
+      /* The whole subtree matches once prefix runs out, whether in
+         the node's own prefix or right after it. */
+      inner = (struct ARTNode *)*nodeRef;
+      matched = SymTable_matchPrefix(inner, prefix, *depth);
+      if (prefix[*depth + matched] == '\0') {
+         return nodeRef;
+      }
+      if (matched != inner->prefixLen) {
+         return NULL;
+      }
+
+      slot = SymTable_findChild(inner,
+                                (unsigned char)prefix[*depth + matched]);
+      if (slot == NULL) {
+         return NULL;
+      }
+      *parent = inner;
+      *byte = (unsigned char)prefix[*depth + matched];
+      *depth += matched + 1;
+      nodeRef = slot;
+   }
+   return NULL;
+}
+
+/* Returns a new SymTable object that contains no bindings,
+   or NULL if there is insufficient memory available. */
+SymTable_T SymTable_new(void) {
+   SymTable_T symTable;
+
+   /* Allocating memory for the SymTable structure, returning
+      NULL if there isn't enough memory available. */
+   symTable = (SymTable_T)malloc(sizeof(struct SymTable));
+   if (symTable == NULL) {
+      return NULL;
+   }
+
+   symTable->root = NULL;
+   symTable->numBindings = 0;
+   return symTable;
+}
+
+/* Frees all memory occupied by symTable. */
+void SymTable_free(SymTable_T symTable) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   if (symTable->root != NULL) {
+      SymTable_freeNode(symTable->root);
+   }
+   free(symTable);
+}
+
+/* Returns number of bindings (key-value pairs) in symTable. */
+size_t SymTable_getLength(SymTable_T symTable) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   return (size_t)symTable->numBindings;
+}
+
+/* If key is already in symTable, leaves symTable unchanged
+   and returns 0. If insufficient memory is available,
+   returns 0. If symTable does not contain a binding
+   with key, then adds a new binding to symTable consisting
+   of key and value, and returns 1. */
+int SymTable_put(SymTable_T symTable, const char *key,
+                 const void *value) {
+   void **nodeRef;
+   void **slot;
+   void *newLeaf;
+   struct ARTNode *inner, *newNode;
+   struct ARTLeaf *leaf;
+   char *suffix;
+   size_t depth = 0;
+   size_t matched;
+   unsigned char byte;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   nodeRef = &symTable->root;
+   if (*nodeRef == NULL) {
+      newLeaf = SymTable_newLeaf(key, value);
+      if (newLeaf == NULL) {
+         return 0;
+      }
+      *nodeRef = newLeaf;
+      symTable->numBindings++;
+      return 1;
+   }
+
+   for (;;) {
+      if (SymTable_isLeaf(*nodeRef)) {
+         leaf = SymTable_leaf(*nodeRef);
+         if (SymTable_leafMatches(leaf, key, depth)) {
+            return 0;
+         }
+
+         /* Splitting the leaf: a new node takes the bytes the two
+            keys share below depth, and branches on the first that
+            differs. */
+         suffix = SymTable_leafKey(leaf) + depth;
+         for (matched = 0; suffix[matched] == key[depth + matched];
+              matched++) {
+         }
+         newNode = SymTable_newNode(NODE4, suffix, matched);
+         if (newNode == NULL) {
+            return 0;
+         }
+         byte = (unsigned char)key[depth + matched];
+         newLeaf = SymTable_newLeaf(key, value);
+         if (newLeaf == NULL) {
+            free(newNode);
+            return 0;
+         }
+
+         (void)SymTable_addChild(nodeRef, newNode,
+                                 (unsigned char)suffix[matched],
+                                 *nodeRef);
+         (void)SymTable_addChild(nodeRef, newNode, byte, newLeaf);
+         *nodeRef = newNode;
+         break;
+      }
+
+      inner = (struct ARTNode *)*nodeRef;
+      matched = SymTable_matchPrefix(inner, key, depth);
+      if (matched < inner->prefixLen) {
+         /* Splitting the prefix of the node: a new node takes the
+            bytes that match, and branches on the first that
+            differs. */
+         newNode = SymTable_newNode(NODE4, SymTable_prefix(inner),
+                                    matched);
+         if (newNode == NULL) {
+            return 0;
+         }
+         byte = (unsigned char)key[depth + matched];
+         newLeaf = SymTable_newLeaf(key, value);
+         if (newLeaf == NULL) {
+            free(newNode);
+            return 0;
+         }
+
+         (void)SymTable_addChild(nodeRef, newNode,
+                                 (unsigned char)
+                                 SymTable_prefix(inner)[matched],
+                                 inner);
+         (void)SymTable_addChild(nodeRef, newNode, byte, newLeaf);
+         memmove(SymTable_prefix(inner),
+                 SymTable_prefix(inner) + matched + 1,
+                 inner->prefixLen - matched - 1);
+         inner->prefixLen -= matched + 1;
+         *nodeRef = newNode;
+         break;
+      }
+
+      depth += inner->prefixLen;
+      byte = (unsigned char)key[depth];
+      slot = SymTable_findChild(inner, byte);
+      if (slot == NULL) {
+         /* Adding a new leaf below the node. */
+         newLeaf = SymTable_newLeaf(key, value);
+         if (newLeaf == NULL) {
+            return 0;
+         }
+         if (!SymTable_addChild(nodeRef, inner, byte, newLeaf)) {
+            free(SymTable_leaf(newLeaf));
+            return 0;
+         }
+         break;
+      }
+      nodeRef = slot;
+      depth++;
+   }
+
+   symTable->numBindings++;
+   return 1;
+}
+
+/* If symTable contains a binding whose key is input parameter key, return
+   its corresponding value and replace the value with input parameter value.
+   Else if there is no binding whose key is input parameter key, leave
+   symTable unchanged and return NULL. */
+void *SymTable_replace(SymTable_T symTable, const char *key,
+                       const void *value) {
+   struct ARTLeaf *leaf;
+   void *oldValue;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   leaf = SymTable_find(symTable, key);
+   if (leaf == NULL) {
+      return NULL;
+   }
+   oldValue = (void *)leaf->value;
+   leaf->value = value;
+   return oldValue;
+}
+
+/* If symTable contains a binding whose key is input parameter key,
+   return 1. Else if there is no binding whose key is input
+   parameter key, return 0. symTable is unchanged. */
+int SymTable_contains(SymTable_T symTable, const char *key) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   return SymTable_find(symTable, key) != NULL;
+}
+
+/* If symTable contains a binding whose key is input parameter key,
+   return corresponding value. Else, return NULL. symTable is unchanged. */
+void *SymTable_get(SymTable_T symTable, const char *key) {
+   struct ARTLeaf *leaf;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   leaf = SymTable_find(symTable, key);
+   if (leaf == NULL) {
+      return NULL;
+   }
+   return (void *)leaf->value;
+}
+
+/* If symTable contains a binding with input key, remove that
+   binding from symTable and return the binding's value. Else,
+   leave symTable unchanged and return NULL. */
+void *SymTable_remove(SymTable_T symTable, const char *key) {
+   void **nodeRef = &symTable->root;
+   void **parentRef = NULL;
+   struct ARTNode *inner;
+   struct ARTLeaf *leaf;
+   void **slot;
+   void *value;
+   size_t depth = 0;
+   unsigned char byte = 0;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   /* Finding the leaf holding key, remembering the slot that refers
+      to its parent. */
+   while (*nodeRef != NULL && !SymTable_isLeaf(*nodeRef)) {
+      inner = (struct ARTNode *)*nodeRef;
+      if (SymTable_matchPrefix(inner, key, depth) != inner->prefixLen) {
+         return NULL;
+      }
+      depth += inner->prefixLen;
+      byte = (unsigned char)key[depth];
+      slot = SymTable_findChild(inner, byte);
+      if (slot == NULL) {
+         return NULL;
+      }
+      parentRef = nodeRef;
+      nodeRef = slot;
+      depth++;
+   }
+
+   if (*nodeRef == NULL) {
+      return NULL;
+   }
+   leaf = SymTable_leaf(*nodeRef);
+   if (!SymTable_leafMatches(leaf, key, depth)) {
+      return NULL;
+   }
+
+   /* Unlinking and freeing the leaf. */
+   value = (void *)leaf->value;
+   if (parentRef == NULL) {
+      symTable->root = NULL;
+   }
+   else {
+      SymTable_removeChild(parentRef, (struct ARTNode *)*parentRef,
+                           byte);
+   }
+   free(leaf);
+
+   /* Decrementing the number of bindings in symTable. */
+   symTable->numBindings--;
+   return value;
+}
+
+/* Applying the function functionApply to each binding in symTable,
+   in ascending order of keys, passing extra as an extra parameter. */
+void SymTable_map(SymTable_T symTable,
+                  void (*functionApply)(const char *key, void *value,
+                                        void *extra), const void *extra) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(functionApply != NULL);
+
+   if (symTable->root != NULL) {
+      SymTable_mapNode(symTable->root, functionApply, extra);
+   }
+}
+
+/* Applying the function functionApply to each binding in symTable
+   whose key starts with prefix, in ascending order of keys, passing
+   extra as an extra parameter. Only the subtree below prefix is
+   visited. */
+void SymTable_mapPrefix(SymTable_T symTable, const char *prefix,
+                        void (*functionApply)
+                        (const char *key, void *value, void *extra),
+                        const void *extra) {
+   struct ARTNode *parent;
+   unsigned char byte;
+   size_t depth;
+   void **nodeRef;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(prefix != NULL);
+   assert(functionApply != NULL);
+
+   nodeRef = SymTable_findPrefix(symTable, prefix, &depth, &parent,
+                                 &byte);
+   if (nodeRef == NULL) {
+      return;
+   }
+
+   SymTable_mapNode(*nodeRef, functionApply, extra);
+}
+
+/* Removes each binding in symTable whose key starts with prefix,
+   first applying the function functionApply to it (if functionApply
+   is not NULL) so that its value may be released, passing extra as
+   an extra parameter. The whole subtree below prefix is unlinked at
+   once. Returns the number of bindings removed. */
+size_t SymTable_removePrefix(SymTable_T symTable, const char *prefix,
+                             void (*functionApply)
+                             (const char *key, void *value, void *extra),
+                             const void *extra) {
+   struct ARTNode *parent, *inner;
+   unsigned char byte;
+   size_t depth, parentDepth, count;
+   void **nodeRef, **parentRef;
+   void *subtree;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(prefix != NULL);
+
+   nodeRef = SymTable_findPrefix(symTable, prefix, &depth, &parent,
+                                 &byte);
+   if (nodeRef == NULL) {
+      return 0;
+   }
+
+   subtree = *nodeRef;
+   if (functionApply != NULL) {
+      SymTable_mapNode(subtree, functionApply, extra);
+   }
+   count = SymTable_countNode(subtree);
+
+   /* Unlinking the subtree from its parent, then freeing it. */
+   if (parent == NULL) {
+      symTable->root = NULL;
+   }
+   else {
+      /* Finding the slot that refers to parent, since removing a
+         child may replace parent. */
+      parentRef = &symTable->root;
+      parentDepth = 0;
+      while (*parentRef != parent) {
+         inner = (struct ARTNode *)*parentRef;
+         parentDepth += inner->prefixLen;
+         parentRef = SymTable_findChild(inner, (unsigned char)
+                                        prefix[parentDepth]);
+         parentDepth++;
+      }
+      SymTable_removeChild(parentRef, parent, byte);
+   }
+   SymTable_freeNode(subtree);
+
+   symTable->numBindings -= (int)count;
+   return count;
+}
+
+/* Returns the number of bytes of memory held by symTable, and fills
+   in *usage (unless usage is NULL) with those bytes split into
+   inner nodes and leaves, the keys held by leaves, the SymTable
+   structure, and allocator overhead. */
+size_t SymTable_memoryUsage(SymTable_T symTable,
+                            struct SymTable_MemoryUsage *usage) {
+   struct SymTable_MemoryUsage localUsage;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   if (usage == NULL) {
+      usage = &localUsage;
+   }
+   memset(usage, 0, sizeof(*usage));
+   usage->bucketBytes += SymTable_blockBytes
+      (symTable, sizeof(struct SymTable), &usage->overheadBytes);
+   if (symTable->root != NULL) {
+      SymTable_nodeUsage(symTable->root, usage);
+   }
+
+   usage->totalBytes = usage->nodeBytes + usage->keyBytes +
+                       usage->bucketBytes + usage->overheadBytes;
+   return usage->totalBytes;
+}
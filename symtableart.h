@@ -0,0 +1,22 @@
+#ifndef SYMTABLEART_INCLUDED
+#define SYMTABLEART_INCLUDED
+
+#include "symtable.h"
+
+/* Prefix extensions of the SymTable interface, provided by the
+   adaptive radix tree implementation (symtableart.c). SymTable_map
+   visits bindings in ascending strcmp order of their keys. As in the
+   other implementations, the key passed to functionApply is the
+   defensive copy held by the SymTable. */
+
+void SymTable_mapPrefix(SymTable_T symTable, const char *prefix,
+                        void (*functionApply)
+                        (const char *key, void *value, void *extra),
+                        const void *extra);
+
+size_t SymTable_removePrefix(SymTable_T symTable, const char *prefix,
+                             void (*functionApply)
+                             (const char *key, void *value, void *extra),
+                             const void *extra);
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef SYMTABLEBACKEND_INCLUDED
+#define SYMTABLEBACKEND_INCLUDED
+
+/* When an implementation is compiled for libsymtable, SYMTABLE_BACKEND
+   is defined to its prefix (SymTableList, SymTableHash, SymTableBTree,
+   SymTableArt, SymTableCompact or SymTableCuckoo), and every public
+   name it defines is given that prefix instead of SymTable, so that
+   all implementations can be linked into one library. symtablelib.c
+   dispatches to them. */
+
+#ifdef SYMTABLE_BACKEND
+
+#define SYMTABLE_PASTE2(prefix, suffix) prefix##suffix
+#define SYMTABLE_PASTE(prefix, suffix) SYMTABLE_PASTE2(prefix, suffix)
+#define SYMTABLE_RENAME(suffix) SYMTABLE_PASTE(SYMTABLE_BACKEND, suffix)
+
+/* The structure and the functions of the SymTable interface. */
+#define SymTable SYMTABLE_BACKEND
+#define SymTable_T SYMTABLE_RENAME(_T)
+#define SymTable_new SYMTABLE_RENAME(_new)
+#define SymTable_free SYMTABLE_RENAME(_free)
+#define SymTable_getLength SYMTABLE_RENAME(_getLength)
+#define SymTable_put SYMTABLE_RENAME(_put)
+#define SymTable_replace SYMTABLE_RENAME(_replace)
+#define SymTable_contains SYMTABLE_RENAME(_contains)
+#define SymTable_get SYMTABLE_RENAME(_get)
+#define SymTable_remove SYMTABLE_RENAME(_remove)
+#define SymTable_map SYMTABLE_RENAME(_map)
+#define SymTable_memoryUsage SYMTABLE_RENAME(_memoryUsage)
+
+/* The extensions of the individual implementations. */
+#define SymTable_setOrganization SYMTABLE_RENAME(_setOrganization)
+#define SymTable_newBounded SYMTABLE_RENAME(_newBounded)
+#define SymTable_newLike SYMTABLE_RENAME(_newLike)
+#define SymTable_setBloomFilter SYMTABLE_RENAME(_setBloomFilter)
+#define SymTable_putWithTTL SYMTABLE_RENAME(_putWithTTL)
+#define SymTable_setExpireFunction SYMTABLE_RENAME(_setExpireFunction)
+#define SymTable_expire SYMTABLE_RENAME(_expire)
+#define SymTable_clear SYMTABLE_RENAME(_clear)
+#define SymTable_removeIf SYMTABLE_RENAME(_removeIf)
+#define SymTable_getStats SYMTABLE_RENAME(_getStats)
+#define SymTable_setInstrumentation SYMTABLE_RENAME(_setInstrumentation)
+#define SymTable_getLatency SYMTABLE_RENAME(_getLatency)
+#define SymTable_dumpLatency SYMTABLE_RENAME(_dumpLatency)
+#define SymTable_merge SYMTABLE_RENAME(_merge)
+#define SymTable_intersect SYMTABLE_RENAME(_intersect)
+#define SymTable_difference SYMTABLE_RENAME(_difference)
+#define SymTable_mapRange SYMTABLE_RENAME(_mapRange)
+#define SymTable_mapPrefix SYMTABLE_RENAME(_mapPrefix)
+#define SymTable_removePrefix SYMTABLE_RENAME(_removePrefix)
+
+#endif
+
+#endif
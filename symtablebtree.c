@@ -0,0 +1,849 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: symtablebtree.c
+ *
+ *  Description: Implements a SymTable data type (collection of key-
+ *  -value bindings) as a B+tree, with functions to allow its client
+ *  to insert (put) new bindings, to retrieve (get) the values of
+ *  bindings with specified keys, and to remove bindings with
+ *  specified keys. This ADT additionally allows for a SymTable
+ *  structure to be freed if it is no longer to be used, for a
+ *  function to be applied to all key-value pairs in key order or
+ *  to those whose keys lie in a given range, for the value for a
+ *  specified key to be replaced, and for checking if a SymTable
+ *  contains a given key.
+ ******************************************************************* */
+#include <assert.h>
+#include <string.h>
+#include "symtablebtree.h"
+#include "symtableutil.h"
+
+/* Declaring an enum to hold the maximum and minimum number of keys
+   in a node other than the root, and the number of leading key
+   bytes cached alongside each key. */
+enum{MAX_KEYS = 32, MIN_KEYS = MAX_KEYS / 2, PREFIX_BYTES = 4};
+
+/* Each node of the B+tree is stored in a BTNode. Leaves hold the
+   bindings and are linked in key order; internal nodes hold
+   separator keys and the addresses of their children. Every node
+   has room for one key more than MAX_KEYS so that it may overflow
+   briefly before being split. */
+struct BTNode {
+   /* 1 if the node is a leaf, 0 if it is an internal node. */
+   int isLeaf;
+
+   /* The number of keys presently in the node. */
+   int numKeys;
+
+   /* The first PREFIX_BYTES bytes of each key, packed so that
+      comparing two prefixes as integers orders them like strcmp.
+      Most comparisons are settled here without touching the key. */
+   unsigned int prefixes[MAX_KEYS + 1];
+
+   /* The keys, in ascending order. Leaves own their keys; the
+      separators of internal nodes point to keys owned by leaves. */
+   const char *keys[MAX_KEYS + 1];
+
+   union {
+      /* The addresses of the children of an internal node. */
+      struct BTNode *children[MAX_KEYS + 2];
+
+      /* The addresses of the values of a leaf. */
+      const void *values[MAX_KEYS + 1];
+   } u;
+
+   /* The address of the next leaf in key order, or of the next
+      spare node when the node is unused. */
+   struct BTNode *next;
+};
+
+/* A SymTable structure is a 'manager' structure that contains the
+   root of the B+tree, the total number of bindings, the height of
+   the tree, and a small list of spare nodes that are set aside
+   before an insertion so that splitting a node cannot fail. */
+struct SymTable {
+   /* The address of the root node. */
+   struct BTNode *root;
+
+   /* The number of bindings (key-value pairs) presently in
+      the symbol table. */
+   int numBindings;
+
+   /* The number of levels in the tree; 1 if the root is a leaf. */
+   int height;
+
+   /* The addresses of the first spare node, and the number of
+      spare nodes. */
+   struct BTNode *spareNodes;
+   int numSpareNodes;
+};
+
+/* Returns the first PREFIX_BYTES bytes of key packed into an
+   unsigned int, most significant byte first, padded with zeros. */
+static unsigned int SymTable_prefix(const char *key) {
+   unsigned int prefix = 0;
+   int i;
+
+   assert(key != NULL);
+
+   for (i = 0; i < PREFIX_BYTES; i++) {
+      prefix = prefix << 8;
+      if (*key != '\0') {
+         prefix |= (unsigned int)(unsigned char)*key;
+         key++;
+      }
+   }
+   return prefix;
+}
+
+/* Compares key, whose prefix is prefix, with the key at index i of
+   node. Returns a negative number, 0 or a positive number as key is
+   less than, equal to or greater than that key. */
+static int SymTable_compare(unsigned int prefix, const char *key,
+                            const struct BTNode *node, int i) {
+   if (prefix != node->prefixes[i]) {
+      return (prefix < node->prefixes[i]) ? -1 : 1;
+   }
+
+   /* Equal prefixes that end in a null byte mean that both keys
+      ended within the prefix. */
+   if ((prefix & 0xFF) == 0) {
+      return 0;
+   }
+   return strcmp(key + PREFIX_BYTES, node->keys[i] + PREFIX_BYTES);
+}
+
+/* Returns the index of the first key of node that is not less than
+   key, using binary search. Sets *found to 1 if that key is equal
+   to key, and to 0 otherwise. */
+static int SymTable_search(const struct BTNode *node,
+                           unsigned int prefix, const char *key,
+                           int *found) {
+   int low = 0;
+   int high = node->numKeys;
+   int middle, result;
+
+   *found = 0;
+   while (low < high) {
+      middle = (low + high) / 2;
+      result = SymTable_compare(prefix, key, node, middle);
+      if (result > 0) {
+         low = middle + 1;
+      }
+      else {
+         if (result == 0) {
+            *found = 1;
+            return middle;
+         }
+         high = middle;
+      }
+   }
+   return low;
+}
+
+/* Returns the index of the child of internal node node whose
+   subtree may contain key. */
+static int SymTable_childIndex(const struct BTNode *node,
+                               unsigned int prefix, const char *key) {
+   int found;
+   int i = SymTable_search(node, prefix, key, &found);
+
+   /* A key equal to a separator lies in the right subtree. */
+   return found ? i + 1 : i;
+}
+
+/* Returns the leaf of symTable whose range contains key. */
+static struct BTNode *SymTable_findLeaf(SymTable_T symTable,
+                                        unsigned int prefix,
+                                        const char *key) {
+   struct BTNode *node = symTable->root;
+
+   while (!node->isLeaf) {
+      node = node->u.children[SymTable_childIndex(node, prefix, key)];
+   }
+   return node;
+}
+
+/* Returns the leftmost leaf of the subtree rooted at node. */
+static struct BTNode *SymTable_firstLeaf(struct BTNode *node) {
+   while (!node->isLeaf) {
+      node = node->u.children[0];
+   }
+   return node;
+}
+
+/* Makes sure that symTable holds enough spare nodes for the deepest
+   possible chain of splits caused by one insertion. Returns 1 if
+   so, or 0 if there is insufficient memory available. */
+static int SymTable_reserveNodes(SymTable_T symTable) {
+   struct BTNode *node;
+
+   while (symTable->numSpareNodes < symTable->height + 1) {
+      node = (struct BTNode *)malloc(sizeof(struct BTNode));
+      if (node == NULL) {
+         return 0;
+      }
+      node->next = symTable->spareNodes;
+      symTable->spareNodes = node;
+      symTable->numSpareNodes++;
+   }
+   return 1;
+}
+
+/* Removes and returns one of the spare nodes of symTable, which
+   must have been reserved beforehand. */
+static struct BTNode *SymTable_takeNode(SymTable_T symTable,
+                                        int isLeaf) {
+   struct BTNode *node = symTable->spareNodes;
+
+   assert(node != NULL);
+   symTable->spareNodes = node->next;
+   symTable->numSpareNodes--;
+
+   node->isLeaf = isLeaf;
+   node->numKeys = 0;
+   node->next = NULL;
+   return node;
+}
+
+/* Splits the overfull node of symTable into two, moving its upper
+   half into a new node. Stores the address of the new node in
+   *splitNode, and the key (and its prefix) that separates the two
+   nodes in *splitKey and *splitPrefix. */
+static void SymTable_split(SymTable_T symTable, struct BTNode *node,
+                           const char **splitKey,
+                           unsigned int *splitPrefix,
+                           struct BTNode **splitNode) {
+   struct BTNode *right = SymTable_takeNode(symTable, node->isLeaf);
+   int middle = node->numKeys / 2;
+   int numMoved;
+
+   if (node->isLeaf) {
+      /* The upper half of the bindings moves to the new leaf, and
+         the first of them becomes the separator. */
+      numMoved = node->numKeys - middle;
+      memcpy(right->keys, node->keys + middle,
+             (size_t)numMoved * sizeof(const char *));
+      memcpy(right->prefixes, node->prefixes + middle,
+             (size_t)numMoved * sizeof(unsigned int));
+      memcpy(right->u.values, node->u.values + middle,
+             (size_t)numMoved * sizeof(const void *));
+      right->numKeys = numMoved;
+      node->numKeys = middle;
+
+      right->next = node->next;
+      node->next = right;
+
+      *splitKey = right->keys[0];
+      *splitPrefix = right->prefixes[0];
+   }
+   else {
+      /* The middle separator moves up to the parent, and the
+         separators and children above it move to the new node. */
+      numMoved = node->numKeys - middle - 1;
+      memcpy(right->keys, node->keys + middle + 1,
+             (size_t)numMoved * sizeof(const char *));
+      memcpy(right->prefixes, node->prefixes + middle + 1,
+             (size_t)numMoved * sizeof(unsigned int));
+      memcpy(right->u.children, node->u.children + middle + 1,
+             (size_t)(numMoved + 1) * sizeof(struct BTNode *));
+      right->numKeys = numMoved;
+      node->numKeys = middle;
+
+      *splitKey = node->keys[middle];
+      *splitPrefix = node->prefixes[middle];
+   }
+   *splitNode = right;
+}
+
+/* Inserts a binding of key (whose prefix is prefix) and value into
+   the subtree of symTable rooted at node. Returns 1 if the binding
+   was added, 0 if key was already present, or -1 if there is
+   insufficient memory available. If node had to be split, stores
+   the new node and its separator in *splitNode, *splitKey and
+   *splitPrefix; otherwise sets *splitNode to NULL. */
+static int SymTable_insert(SymTable_T symTable, struct BTNode *node,
+                           unsigned int prefix, const char *key,
+                           const void *value, const char **splitKey,
+                           unsigned int *splitPrefix,
+                           struct BTNode **splitNode) {
+   struct BTNode *childSplitNode;
+   const char *childSplitKey;
+   unsigned int childSplitPrefix;
+   char *keyCopy;
+   int i, found, result;
+   size_t numShifted;
+
+   *splitNode = NULL;
+
+   if (node->isLeaf) {
+      i = SymTable_search(node, prefix, key, &found);
+      if (found) {
+         return 0;
+      }
+
+      /* Dynamically allocating memory for the defensive copy of
+         the key. */
+      keyCopy = (char *)malloc(strlen(key) + 1);
+      if (keyCopy == NULL) {
+         return -1;
+      }
+      strcpy(keyCopy, key);
+
+      /* Shifting the greater bindings up to make room. */
+      numShifted = (size_t)(node->numKeys - i);
+      memmove(node->keys + i + 1, node->keys + i,
+              numShifted * sizeof(const char *));
+      memmove(node->prefixes + i + 1, node->prefixes + i,
+              numShifted * sizeof(unsigned int));
+      memmove(node->u.values + i + 1, node->u.values + i,
+              numShifted * sizeof(const void *));
+      node->keys[i] = keyCopy;
+      node->prefixes[i] = prefix;
+      node->u.values[i] = value;
+      node->numKeys++;
+   }
+   else {
+      i = SymTable_childIndex(node, prefix, key);
+      result = SymTable_insert(symTable, node->u.children[i], prefix,
+                               key, value, &childSplitKey,
+                               &childSplitPrefix, &childSplitNode);
+      if (result != 1 || childSplitNode == NULL) {
+         return result;
+      }
+
+      /* Adding the separator and the new child that resulted from
+         splitting child i. */
+      numShifted = (size_t)(node->numKeys - i);
+      memmove(node->keys + i + 1, node->keys + i,
+              numShifted * sizeof(const char *));
+      memmove(node->prefixes + i + 1, node->prefixes + i,
+              numShifted * sizeof(unsigned int));
+      memmove(node->u.children + i + 2, node->u.children + i + 1,
+              numShifted * sizeof(struct BTNode *));
+      node->keys[i] = childSplitKey;
+      node->prefixes[i] = childSplitPrefix;
+      node->u.children[i + 1] = childSplitNode;
+      node->numKeys++;
+   }
+
+   if (node->numKeys > MAX_KEYS) {
+      SymTable_split(symTable, node, splitKey, splitPrefix, splitNode);
+   }
+   return 1;
+}
+
+/* Moves one binding (or, for internal nodes, one child) from the
+   sibling on the left of child i of parent into child i, rotating
+   the separator between them through parent. */
+static void SymTable_borrowLeft(struct BTNode *parent, int i) {
+   struct BTNode *child = parent->u.children[i];
+   struct BTNode *left = parent->u.children[i - 1];
+   size_t numShifted = (size_t)child->numKeys;
+
+   memmove(child->keys + 1, child->keys,
+           numShifted * sizeof(const char *));
+   memmove(child->prefixes + 1, child->prefixes,
+           numShifted * sizeof(unsigned int));
+
+   if (child->isLeaf) {
+      memmove(child->u.values + 1, child->u.values,
+              numShifted * sizeof(const void *));
+      child->keys[0] = left->keys[left->numKeys - 1];
+      child->prefixes[0] = left->prefixes[left->numKeys - 1];
+      child->u.values[0] = left->u.values[left->numKeys - 1];
+      parent->keys[i - 1] = child->keys[0];
+      parent->prefixes[i - 1] = child->prefixes[0];
+   }
+   else {
+      memmove(child->u.children + 1, child->u.children,
+              (numShifted + 1) * sizeof(struct BTNode *));
+      child->keys[0] = parent->keys[i - 1];
+      child->prefixes[0] = parent->prefixes[i - 1];
+      child->u.children[0] = left->u.children[left->numKeys];
+      parent->keys[i - 1] = left->keys[left->numKeys - 1];
+      parent->prefixes[i - 1] = left->prefixes[left->numKeys - 1];
+   }
+
+   left->numKeys--;
+   child->numKeys++;
+}
+
+/* Moves one binding (or, for internal nodes, one child) from the
+   sibling on the right of child i of parent into child i, rotating
+   the separator between them through parent. */
+static void SymTable_borrowRight(struct BTNode *parent, int i) {
+   struct BTNode *child = parent->u.children[i];
+   struct BTNode *right = parent->u.children[i + 1];
+   size_t numShifted = (size_t)(right->numKeys - 1);
+   int n = child->numKeys;
+
+   if (child->isLeaf) {
+      child->keys[n] = right->keys[0];
+      child->prefixes[n] = right->prefixes[0];
+      child->u.values[n] = right->u.values[0];
+      memmove(right->u.values, right->u.values + 1,
+              numShifted * sizeof(const void *));
+   }
+   else {
+      child->keys[n] = parent->keys[i];
+      child->prefixes[n] = parent->prefixes[i];
+      child->u.children[n + 1] = right->u.children[0];
+      parent->keys[i] = right->keys[0];
+      parent->prefixes[i] = right->prefixes[0];
+      memmove(right->u.children, right->u.children + 1,
+              (numShifted + 1) * sizeof(struct BTNode *));
+   }
+
+   memmove(right->keys, right->keys + 1,
+           numShifted * sizeof(const char *));
+   memmove(right->prefixes, right->prefixes + 1,
+           numShifted * sizeof(unsigned int));
+   right->numKeys--;
+   child->numKeys++;
+
+   if (child->isLeaf) {
+      parent->keys[i] = right->keys[0];
+      parent->prefixes[i] = right->prefixes[0];
+   }
+}
+
+/* Merges child i + 1 of parent into child i, removing the separator
+   between them from parent, and frees child i + 1. */
+static void SymTable_merge(struct BTNode *parent, int i) {
+   struct BTNode *left = parent->u.children[i];
+   struct BTNode *right = parent->u.children[i + 1];
+   int n = left->numKeys;
+   size_t numShifted;
+
+   if (left->isLeaf) {
+      memcpy(left->keys + n, right->keys,
+             (size_t)right->numKeys * sizeof(const char *));
+      memcpy(left->prefixes + n, right->prefixes,
+             (size_t)right->numKeys * sizeof(unsigned int));
+      memcpy(left->u.values + n, right->u.values,
+             (size_t)right->numKeys * sizeof(const void *));
+      left->numKeys = n + right->numKeys;
+      left->next = right->next;
+   }
+   else {
+      /* The separator moves down between the two sets of keys. */
+      left->keys[n] = parent->keys[i];
+      left->prefixes[n] = parent->prefixes[i];
+      memcpy(left->keys + n + 1, right->keys,
+             (size_t)right->numKeys * sizeof(const char *));
+      memcpy(left->prefixes + n + 1, right->prefixes,
+             (size_t)right->numKeys * sizeof(unsigned int));
+      memcpy(left->u.children + n + 1, right->u.children,
+             (size_t)(right->numKeys + 1) * sizeof(struct BTNode *));
+      left->numKeys = n + 1 + right->numKeys;
+   }
+
+   /* Removing the separator and the address of the right node. */
+   numShifted = (size_t)(parent->numKeys - i - 1);
+   memmove(parent->keys + i, parent->keys + i + 1,
+           numShifted * sizeof(const char *));
+   memmove(parent->prefixes + i, parent->prefixes + i + 1,
+           numShifted * sizeof(unsigned int));
+   memmove(parent->u.children + i + 1, parent->u.children + i + 2,
+           numShifted * sizeof(struct BTNode *));
+   parent->numKeys--;
+
+   free(right);
+}
+
+/* Restores the minimum number of keys in child i of parent by
+   borrowing from a sibling that can spare one, or else by merging
+   it with a sibling. */
+static void SymTable_rebalance(struct BTNode *parent, int i) {
+   if (i > 0 && parent->u.children[i - 1]->numKeys > MIN_KEYS) {
+      SymTable_borrowLeft(parent, i);
+   }
+   else if (i < parent->numKeys &&
+            parent->u.children[i + 1]->numKeys > MIN_KEYS) {
+      SymTable_borrowRight(parent, i);
+   }
+   else if (i > 0) {
+      SymTable_merge(parent, i - 1);
+   }
+   else {
+      SymTable_merge(parent, i);
+   }
+}
+
+/* Removes the binding whose key is key (and whose prefix is prefix)
+   from the subtree rooted at node, storing its value in *value.
+   Returns the address of the removed key, which the caller must
+   free, or NULL if key is not present. */
+static const char *SymTable_delete(struct BTNode *node,
+                                   unsigned int prefix, const char *key,
+                                   void **value) {
+   const char *removedKey;
+   size_t numShifted;
+   int i, found;
+
+   if (node->isLeaf) {
+      i = SymTable_search(node, prefix, key, &found);
+      if (!found) {
+         return NULL;
+      }
+
+      removedKey = node->keys[i];
+      *value = (void *)node->u.values[i];
+
+      numShifted = (size_t)(node->numKeys - i - 1);
+      memmove(node->keys + i, node->keys + i + 1,
+              numShifted * sizeof(const char *));
+      memmove(node->prefixes + i, node->prefixes + i + 1,
+              numShifted * sizeof(unsigned int));
+      memmove(node->u.values + i, node->u.values + i + 1,
+              numShifted * sizeof(const void *));
+      node->numKeys--;
+      return removedKey;
+   }
+
+   i = SymTable_childIndex(node, prefix, key);
+   removedKey = SymTable_delete(node->u.children[i], prefix, key, value);
+   if (removedKey == NULL) {
+      return NULL;
+   }
+
+   /* If the removed key was the smallest of child i, it is also the
+      separator to the left of child i, and must be replaced by the
+      new smallest key before it is freed. */
+   if (i > 0 && node->keys[i - 1] == removedKey) {
+      struct BTNode *leaf = SymTable_firstLeaf(node->u.children[i]);
+      node->keys[i - 1] = leaf->keys[0];
+      node->prefixes[i - 1] = leaf->prefixes[0];
+   }
+
+   if (node->u.children[i]->numKeys < MIN_KEYS) {
+      SymTable_rebalance(node, i);
+   }
+   return removedKey;
+}
+
+/* Frees the subtree rooted at node, including the keys its leaves
+   own. */
+static void SymTable_freeNode(struct BTNode *node) {
+   int i;
+
+   if (node->isLeaf) {
+      for (i = 0; i < node->numKeys; i++) {
+         free((char *)node->keys[i]);
+      }
+   }
+   else {
+      for (i = 0; i <= node->numKeys; i++) {
+         SymTable_freeNode(node->u.children[i]);
+      }
+   }
+   free(node);
+}
+
+/* Adds the bytes held by the subtree rooted at node, and by the
+   keys its leaves own, to *usage. */
+static void SymTable_nodeUsage(const struct BTNode *node,
+                               struct SymTable_MemoryUsage *usage) {
+   int i;
+
+   usage->nodeBytes += SymTable_blockBytes(node, sizeof(struct BTNode),
+                                           &usage->overheadBytes);
+   if (node->isLeaf) {
+      for (i = 0; i < node->numKeys; i++) {
+         usage->keyBytes += SymTable_blockBytes
+            (node->keys[i], strlen(node->keys[i]) + 1,
+             &usage->overheadBytes);
+      }
+   }
+   else {
+      for (i = 0; i <= node->numKeys; i++) {
+         SymTable_nodeUsage(node->u.children[i], usage);
+      }
+   }
+}
+
+/* Returns a new SymTable object that contains no bindings,
+   or NULL if there is insufficient memory available. */
+SymTable_T SymTable_new(void) {
+   SymTable_T symTable;
+
+   /* Allocating memory for the SymTable structure, returning
+      NULL if there isn't enough memory available. */
+   symTable = (SymTable_T)malloc(sizeof(struct SymTable));
+   if (symTable == NULL) {
+      return NULL;
+   }
+
+   symTable->spareNodes = NULL;
+   symTable->numSpareNodes = 0;
+   symTable->height = 0;
+
+   /* Allocating memory for the root, an empty leaf, freeing the
+      symTable structure and returning NULL if there isn't enough
+      memory available. */
+   if (!SymTable_reserveNodes(symTable)) {
+      free(symTable);
+      return NULL;
+   }
+   symTable->root = SymTable_takeNode(symTable, 1);
+   symTable->height = 1;
+   symTable->numBindings = 0;
+
+   return symTable;
+}
+
+/* Frees all memory occupied by symTable. */
+void SymTable_free(SymTable_T symTable) {
+   struct BTNode *node;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   SymTable_freeNode(symTable->root);
+
+   /* Freeing the spare nodes. */
+   while (symTable->spareNodes != NULL) {
+      node = symTable->spareNodes;
+      symTable->spareNodes = node->next;
+      free(node);
+   }
+
+   free(symTable);
+}
+
+/* Returns number of bindings (key-value pairs) in symTable. */
+size_t SymTable_getLength(SymTable_T symTable) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   return (size_t)symTable->numBindings;
+}
+
+/* If key is already in symTable, leaves symTable unchanged
+   and returns 0. If insufficient memory is available,
+   returns 0. If symTable does not contain a binding
+   with key, then adds a new binding to symTable consisting
+   of key and value, and returns 1. */
+int SymTable_put(SymTable_T symTable, const char *key,
+                 const void *value) {
+   struct BTNode *splitNode, *newRoot;
+   const char *splitKey;
+   unsigned int splitPrefix;
+   int result;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   /* Setting aside the nodes that splits may need, so that the
+      tree is never left half-modified. */
+   if (!SymTable_reserveNodes(symTable)) {
+      return 0;
+   }
+
+   result = SymTable_insert(symTable, symTable->root,
+                            SymTable_prefix(key), key, value,
+                            &splitKey, &splitPrefix, &splitNode);
+   if (result != 1) {
+      return 0;
+   }
+
+   /* Growing the tree by one level if the root was split. */
+   if (splitNode != NULL) {
+      newRoot = SymTable_takeNode(symTable, 0);
+      newRoot->numKeys = 1;
+      newRoot->keys[0] = splitKey;
+      newRoot->prefixes[0] = splitPrefix;
+      newRoot->u.children[0] = symTable->root;
+      newRoot->u.children[1] = splitNode;
+      symTable->root = newRoot;
+      symTable->height++;
+   }
+
+   symTable->numBindings++;
+   return 1;
+}
+
+/* If symTable contains a binding whose key is input parameter key, return
+   its corresponding value and replace the value with input parameter value.
+   Else if there is no binding whose key is input parameter key, leave
+   symTable unchanged and return NULL. */
+void *SymTable_replace(SymTable_T symTable, const char *key,
+                       const void *value) {
+   struct BTNode *leaf;
+   unsigned int prefix;
+   void *oldValue;
+   int i, found;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   prefix = SymTable_prefix(key);
+   leaf = SymTable_findLeaf(symTable, prefix, key);
+   i = SymTable_search(leaf, prefix, key, &found);
+   if (!found) {
+      return NULL;
+   }
+
+   oldValue = (void *)leaf->u.values[i];
+   leaf->u.values[i] = value;
+   return oldValue;
+}
+
+/* If symTable contains a binding whose key is input parameter key,
+   return 1. Else if there is no binding whose key is input
+   parameter key, return 0. symTable is unchanged. */
+int SymTable_contains(SymTable_T symTable, const char *key) {
+   struct BTNode *leaf;
+   unsigned int prefix;
+   int found;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   prefix = SymTable_prefix(key);
+   leaf = SymTable_findLeaf(symTable, prefix, key);
+   (void)SymTable_search(leaf, prefix, key, &found);
+   return found;
+}
+
+/* If symTable contains a binding whose key is input parameter key,
+   return corresponding value. Else, return NULL. symTable is unchanged. */
+void *SymTable_get(SymTable_T symTable, const char *key) {
+   struct BTNode *leaf;
+   unsigned int prefix;
+   int i, found;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   prefix = SymTable_prefix(key);
+   leaf = SymTable_findLeaf(symTable, prefix, key);
+   i = SymTable_search(leaf, prefix, key, &found);
+   if (!found) {
+      return NULL;
+   }
+   return (void *)leaf->u.values[i];
+}
+
+/* If symTable contains a binding with input key, remove that
+   binding from symTable and return the binding's value. Else,
+   leave symTable unchanged and return NULL. */
+void *SymTable_remove(SymTable_T symTable, const char *key) {
+   struct BTNode *oldRoot;
+   const char *removedKey;
+   void *value;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   removedKey = SymTable_delete(symTable->root, SymTable_prefix(key),
+                                key, &value);
+   if (removedKey == NULL) {
+      return NULL;
+   }
+   free((char *)removedKey);
+
+   /* Shrinking the tree by one level if the root has been left
+      with a single child. */
+   if (!symTable->root->isLeaf && symTable->root->numKeys == 0) {
+      oldRoot = symTable->root;
+      symTable->root = oldRoot->u.children[0];
+      free(oldRoot);
+      symTable->height--;
+   }
+
+   /* Decrementing the number of bindings in symTable. */
+   symTable->numBindings--;
+   return value;
+}
+
+/* Applying the function functionApply to each binding in symTable,
+   in ascending order of keys, passing extra as an extra parameter. */
+void SymTable_map(SymTable_T symTable,
+                  void (*functionApply)(const char *key, void *value,
+                                        void *extra), const void *extra) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(functionApply != NULL);
+
+   SymTable_mapRange(symTable, NULL, NULL, functionApply, extra);
+}
+
+/* Applying the function functionApply to each binding in symTable
+   whose key is at least lo and less than hi, in ascending order of
+   keys, passing extra as an extra parameter. A NULL lo or hi leaves
+   the range unbounded on that side. Finding the first binding takes
+   O(log n) time, after which the leaves are walked in order. */
+void SymTable_mapRange(SymTable_T symTable, const char *lo,
+                       const char *hi, void (*functionApply)
+                       (const char *key, void *value, void *extra),
+                       const void *extra) {
+   struct BTNode *leaf;
+   unsigned int hiPrefix = 0;
+   int i, found;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(functionApply != NULL);
+
+   /* Finding the first binding whose key is at least lo. */
+   if (lo == NULL) {
+      leaf = SymTable_firstLeaf(symTable->root);
+      i = 0;
+   }
+   else {
+      leaf = SymTable_findLeaf(symTable, SymTable_prefix(lo), lo);
+      i = SymTable_search(leaf, SymTable_prefix(lo), lo, &found);
+   }
+
+   if (hi != NULL) {
+      hiPrefix = SymTable_prefix(hi);
+   }
+
+   /* Walking the leaves in order until a key reaches hi. */
+   for (; leaf != NULL; leaf = leaf->next, i = 0) {
+      for (; i < leaf->numKeys; i++) {
+         if (hi != NULL && SymTable_compare(hiPrefix, hi, leaf, i) <= 0) {
+            return;
+         }
+         (*functionApply)(leaf->keys[i], (void *)leaf->u.values[i],
+                          (void *)extra);
+      }
+   }
+}
+
+/* Returns the number of bytes of memory held by symTable, and fills
+   in *usage (unless usage is NULL) with those bytes split into
+   BTNodes (spare nodes included), keys, the SymTable structure, and
+   allocator overhead. */
+size_t SymTable_memoryUsage(SymTable_T symTable,
+                            struct SymTable_MemoryUsage *usage) {
+   struct SymTable_MemoryUsage localUsage;
+   struct BTNode *node;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   if (usage == NULL) {
+      usage = &localUsage;
+   }
+   memset(usage, 0, sizeof(*usage));
+   usage->bucketBytes += SymTable_blockBytes
+      (symTable, sizeof(struct SymTable), &usage->overheadBytes);
+   SymTable_nodeUsage(symTable->root, usage);
+   for (node = symTable->spareNodes; node != NULL; node = node->next) {
+      usage->nodeBytes += SymTable_blockBytes
+         (node, sizeof(struct BTNode), &usage->overheadBytes);
+   }
+
+   usage->totalBytes = usage->nodeBytes + usage->keyBytes +
+                       usage->bucketBytes + usage->overheadBytes;
+   return usage->totalBytes;
+}
@@ -0,0 +1,15 @@
+#ifndef SYMTABLEBTREE_INCLUDED
+#define SYMTABLEBTREE_INCLUDED
+
+#include "symtable.h"
+
+/* Ordered extensions of the SymTable interface, provided by the
+   B+tree implementation (symtablebtree.c). SymTable_map visits
+   bindings in ascending strcmp order of their keys. */
+
+void SymTable_mapRange(SymTable_T symTable, const char *lo,
+                       const char *hi, void (*functionApply)
+                       (const char *key, void *value, void *extra),
+                       const void *extra);
+
+#endif
@@ -0,0 +1,519 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: symtablecompact.c
+ *
+ *  Description: Implements a SymTable data type (collection of key-
+ *  -value bindings) as a hash table laid out to use little memory
+ *  per binding, with functions to allow its client to insert (put)
+ *  new bindings, to retrieve (get) the values of bindings with
+ *  specified keys, and to remove bindings with specified keys. This
+ *  ADT additionally allows for a SymTable structure to be freed if
+ *  it is no longer to be used, for a function to be applied to all
+ *  key-value pairs, for the value for a specified key to be replaced,
+ *  and for checking if a SymTable contains a given key.
+ *
+ *  The STNodes of a SymTable live in one contiguous pool and refer
+ *  to each other by 32-bit indices into it, and the defensive copies
+ *  of the keys are packed one after another into one key heap, to
+ *  which STNodes refer by 32-bit offsets. A binding thus takes a
+ *  16-byte STNode, a 4-byte bucket and the bytes of its key, with no
+ *  allocation of its own, and walking a list stays within the pool.
+ *
+ *  The bucket array, the pool and the key heap of a large SymTable
+ *  are mapped directly from the system, with a hint to back them
+ *  with huge pages so that lookups take fewer TLB misses, and are
+ *  grown with mremap, which moves pages rather than copying bytes.
+ *  Doubling the bucket array splits each list in place.
+ ******************************************************************* */
+#define _GNU_SOURCE
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+#include "symtablecompact.h"
+#include "symtablearray.h"
+
+/* Declaring an enum to hold the index standing for no STNode (index
+   0 of the pool is never used, so that a zeroed bucket is empty),
+   and the number of buckets, STNodes and key heap bytes of a new
+   symbol table. */
+enum{NIL = 0, INITIAL_BUCKETS = 16, INITIAL_NODES = 16,
+     INITIAL_HEAP_BYTES = 256};
+
+/* Each item is stored in an STNode. STNodes are linked (by index) to
+   form a list. */
+struct STNode {
+   /* The address of the value. */
+   const void *value;
+
+   /* The offset of the key in the key heap. */
+   uint32_t keyOffset;
+
+   /* The index of the next STNode in the list, or of the next free
+      STNode for an STNode that is not in use. */
+   uint32_t next;
+};
+
+/* A SymTable structure is a 'manager' structure that contains the
+   array of buckets, the pool of STNodes and the key heap. */
+struct SymTable {
+   /* The indices of the first STNodes of each list, and the number
+      of buckets (a power of 2). */
+   uint32_t *buckets;
+   size_t numBuckets;
+
+   /* The pool of STNodes, the number of STNodes it has room for, the
+      number of STNodes ever used from it (including index NIL), and
+      the index of the first STNode freed for reuse. */
+   struct STNode *nodes;
+   size_t nodeCapacity;
+   size_t numNodesUsed;
+   uint32_t freeNode;
+
+   /* The key heap, its size in bytes, the number of bytes used from
+      it, and the number of those bytes holding keys of removed
+      bindings. */
+   char *heap;
+   size_t heapCapacity;
+   size_t heapUsed;
+   size_t heapDeadBytes;
+
+   /* The number of bindings (key-value pairs) presently in the
+      symbol table. */
+   size_t numBindings;
+};
+
+/* Returns a hash code for pcKey, with its bits mixed so that reducing
+   it modulo a power of 2 gives a good bucket index. */
+static size_t SymTable_hash(const char *pcKey) {
+   assert(pcKey != NULL);
+
+   return (size_t)SymTable_stringHash(pcKey, NULL);
+}
+
+/* Returns the index of the STNode of symTable holding key, or NIL,
+   storing in *linkRef the address of the link referring to it (or
+   to NIL at the end of its list). */
+static uint32_t SymTable_find(SymTable_T symTable, const char *key,
+                              uint32_t **linkRef) {
+   uint32_t *link;
+
+   link = &symTable->buckets[SymTable_hash(key) &
+                             (symTable->numBuckets - 1)];
+   while (*link != NIL &&
+          strcmp(symTable->heap + symTable->nodes[*link].keyOffset,
+                 key) != 0) {
+      link = &symTable->nodes[*link].next;
+   }
+   *linkRef = link;
+   return *link;
+}
+
+/* Doubles the number of buckets of symTable, leaving it unchanged if
+   there is insufficient memory available. Since the number of
+   buckets is a power of 2, the STNodes of bucket i go either to
+   bucket i or to bucket i plus the old number of buckets, so each
+   list is split in place rather than copied into a new array. */
+static void SymTable_rehash(SymTable_T symTable) {
+   uint32_t *newBuckets;
+   uint32_t *lowLink, *highLink;
+   size_t oldNumBuckets, newNumBuckets, i;
+   uint32_t index, nextIndex;
+
+   oldNumBuckets = symTable->numBuckets;
+   newNumBuckets = oldNumBuckets * 2;
+   newBuckets = (uint32_t *)SymTable_resizeArray
+      (symTable->buckets, oldNumBuckets * sizeof(uint32_t),
+       newNumBuckets * sizeof(uint32_t));
+   if (newBuckets == NULL) {
+      return;
+   }
+   symTable->buckets = newBuckets;
+   symTable->numBuckets = newNumBuckets;
+
+   /* Splitting each list, keeping the order of its STNodes, into
+      the list of its own bucket and that of the bucket in the new
+      half of the array. */
+   for (i = 0; i < oldNumBuckets; i++) {
+      index = newBuckets[i];
+      lowLink = &newBuckets[i];
+      highLink = &newBuckets[i + oldNumBuckets];
+      for (; index != NIL; index = nextIndex) {
+         nextIndex = symTable->nodes[index].next;
+         if (SymTable_hash(symTable->heap +
+                           symTable->nodes[index].keyOffset) &
+             oldNumBuckets) {
+            *highLink = index;
+            highLink = &symTable->nodes[index].next;
+         }
+         else {
+            *lowLink = index;
+            lowLink = &symTable->nodes[index].next;
+         }
+      }
+      *lowLink = NIL;
+      *highLink = NIL;
+   }
+}
+
+/* Copies the keys of the bindings of symTable into a new key heap of
+   capacity bytes, dropping the keys of removed bindings. Returns 1,
+   or 0 (leaving symTable unchanged) if there is insufficient memory
+   available. */
+static int SymTable_rebuildHeap(SymTable_T symTable, size_t capacity) {
+   char *newHeap;
+   size_t used = 0, i, keyLength;
+   uint32_t index;
+   const char *key;
+
+   newHeap = (char *)SymTable_allocArray(capacity);
+   if (newHeap == NULL) {
+      return 0;
+   }
+   for (i = 0; i < symTable->numBuckets; i++) {
+      for (index = symTable->buckets[i]; index != NIL;
+           index = symTable->nodes[index].next) {
+         key = symTable->heap + symTable->nodes[index].keyOffset;
+         keyLength = strlen(key) + 1;
+         memcpy(newHeap + used, key, keyLength);
+         symTable->nodes[index].keyOffset = (uint32_t)used;
+         used += keyLength;
+      }
+   }
+
+   SymTable_freeArray(symTable->heap, symTable->heapCapacity);
+   symTable->heap = newHeap;
+   symTable->heapCapacity = capacity;
+   symTable->heapUsed = used;
+   symTable->heapDeadBytes = 0;
+   return 1;
+}
+
+/* Makes room for keyLength more bytes in the key heap of symTable,
+   dropping the keys of removed bindings if they take at least half
+   of it and doubling it otherwise. Returns 1, or 0 if the key heap
+   would need more than 2^32 bytes or if there is insufficient
+   memory available. */
+static int SymTable_reserveHeap(SymTable_T symTable, size_t keyLength) {
+   size_t capacity;
+   char *newHeap;
+
+   if (symTable->heapUsed + keyLength <= symTable->heapCapacity) {
+      return 1;
+   }
+
+   /* Dropping the keys of removed bindings, if that frees enough
+      room, and keeps the heap at most half full. */
+   if (symTable->heapDeadBytes * 2 >= symTable->heapUsed &&
+       (symTable->heapUsed - symTable->heapDeadBytes + keyLength) * 2 <=
+       symTable->heapCapacity) {
+      return SymTable_rebuildHeap(symTable, symTable->heapCapacity);
+   }
+
+   capacity = symTable->heapCapacity;
+   while (capacity < symTable->heapUsed + keyLength) {
+      capacity *= 2;
+   }
+   if (capacity - 1 > UINT32_MAX) {
+      return 0;
+   }
+   newHeap = (char *)SymTable_resizeArray(symTable->heap,
+                                          symTable->heapCapacity,
+                                          capacity);
+   if (newHeap == NULL) {
+      return 0;
+   }
+   symTable->heap = newHeap;
+   symTable->heapCapacity = capacity;
+   return 1;
+}
+
+/* Returns the index of an unused STNode of symTable, doubling the
+   pool if none is left, or NIL if the pool would need more than
+   2^32 STNodes or if there is insufficient memory available. */
+static uint32_t SymTable_allocateNode(SymTable_T symTable) {
+   struct STNode *newNodes;
+   size_t capacity;
+   uint32_t index;
+
+   if (symTable->freeNode != NIL) {
+      index = symTable->freeNode;
+      symTable->freeNode = symTable->nodes[index].next;
+      return index;
+   }
+
+   if (symTable->numNodesUsed == symTable->nodeCapacity) {
+      capacity = symTable->nodeCapacity * 2;
+      if (capacity - 1 > UINT32_MAX) {
+         return NIL;
+      }
+      newNodes = (struct STNode *)SymTable_resizeArray
+         (symTable->nodes, symTable->nodeCapacity * sizeof(struct STNode),
+          capacity * sizeof(struct STNode));
+      if (newNodes == NULL) {
+         return NIL;
+      }
+      symTable->nodes = newNodes;
+      symTable->nodeCapacity = capacity;
+   }
+   return (uint32_t)symTable->numNodesUsed++;
+}
+
+/* Returns a new SymTable object that contains no bindings,
+   or NULL if there is insufficient memory available. */
+SymTable_T SymTable_new(void) {
+   SymTable_T symTable;
+
+   symTable = (SymTable_T)malloc(sizeof(struct SymTable));
+   if (symTable == NULL) {
+      return NULL;
+   }
+
+   symTable->buckets = (uint32_t *)calloc(INITIAL_BUCKETS,
+                                          sizeof(uint32_t));
+   symTable->nodes = (struct STNode *)malloc(INITIAL_NODES *
+                                             sizeof(struct STNode));
+   symTable->heap = (char *)malloc(INITIAL_HEAP_BYTES);
+   if (symTable->buckets == NULL || symTable->nodes == NULL ||
+       symTable->heap == NULL) {
+      free(symTable->buckets);
+      free(symTable->nodes);
+      free(symTable->heap);
+      free(symTable);
+      return NULL;
+   }
+
+   symTable->numBuckets = INITIAL_BUCKETS;
+   symTable->nodeCapacity = INITIAL_NODES;
+   symTable->numNodesUsed = 1;
+   symTable->freeNode = NIL;
+   symTable->heapCapacity = INITIAL_HEAP_BYTES;
+   symTable->heapUsed = 0;
+   symTable->heapDeadBytes = 0;
+   symTable->numBindings = 0;
+   return symTable;
+}
+
+/* Frees all memory occupied by symTable. */
+void SymTable_free(SymTable_T symTable) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   SymTable_freeArray(symTable->buckets,
+                      symTable->numBuckets * sizeof(uint32_t));
+   SymTable_freeArray(symTable->nodes,
+                      symTable->nodeCapacity * sizeof(struct STNode));
+   SymTable_freeArray(symTable->heap, symTable->heapCapacity);
+   free(symTable);
+}
+
+/* Removes every binding from symTable, passing each to freeFunction
+   (if it is not NULL) with extra, so that its value may be released.
+   symTable keeps its buckets, its pool of STNodes and its key heap at
+   their present sizes, so that refilling it allocates nothing. */
+void SymTable_clear(SymTable_T symTable,
+                    void (*freeFunction)
+                    (const char *key, void *value, void *extra),
+                    const void *extra) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   if (freeFunction != NULL) {
+      SymTable_map(symTable, freeFunction, extra);
+   }
+   memset(symTable->buckets, 0, symTable->numBuckets * sizeof(uint32_t));
+   symTable->numNodesUsed = 1;
+   symTable->freeNode = NIL;
+   symTable->heapUsed = 0;
+   symTable->heapDeadBytes = 0;
+   symTable->numBindings = 0;
+}
+
+/* Returns number of bindings (key-value pairs) in symTable. */
+size_t SymTable_getLength(SymTable_T symTable) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   return symTable->numBindings;
+}
+
+/* If symTable does not contain a binding with key, adds a new
+   binding of key and value to symTable and returns 1. Else, leaves
+   symTable unchanged and returns 0, as it also does if insufficient
+   memory is available. */
+int SymTable_put(SymTable_T symTable, const char *key,
+                 const void *value) {
+   uint32_t *link;
+   uint32_t index;
+   size_t keyLength;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   if (SymTable_find(symTable, key, &link) != NIL) {
+      return 0;
+   }
+
+   /* Making room for the key and taking an STNode before changing
+      anything else, so that symTable is unchanged on failure. */
+   keyLength = strlen(key) + 1;
+   if (!SymTable_reserveHeap(symTable, keyLength)) {
+      return 0;
+   }
+   index = SymTable_allocateNode(symTable);
+   if (index == NIL) {
+      return 0;
+   }
+
+   /* Appending the key to the key heap, and adding the STNode to the
+      end of the list for the key's bucket (found again, since
+      growing the pool may have moved the link to it). */
+   memcpy(symTable->heap + symTable->heapUsed, key, keyLength);
+   symTable->nodes[index].keyOffset = (uint32_t)symTable->heapUsed;
+   symTable->nodes[index].value = value;
+   symTable->nodes[index].next = NIL;
+   symTable->heapUsed += keyLength;
+   (void)SymTable_find(symTable, key, &link);
+   *link = index;
+   symTable->numBindings++;
+
+   if (symTable->numBindings > symTable->numBuckets) {
+      SymTable_rehash(symTable);
+   }
+   return 1;
+}
+
+/* If symTable contains a binding with key, returns its value and
+   replaces it with value. Else, leaves symTable unchanged and
+   returns NULL. */
+void *SymTable_replace(SymTable_T symTable, const char *key,
+                       const void *value) {
+   uint32_t *link;
+   uint32_t index;
+   void *oldValue;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   index = SymTable_find(symTable, key, &link);
+   if (index == NIL) {
+      return NULL;
+   }
+   oldValue = (void *)symTable->nodes[index].value;
+   symTable->nodes[index].value = value;
+   return oldValue;
+}
+
+/* Returns 1 if symTable contains a binding with key, or 0
+   otherwise. */
+int SymTable_contains(SymTable_T symTable, const char *key) {
+   uint32_t *link;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   return SymTable_find(symTable, key, &link) != NIL;
+}
+
+/* If symTable contains a binding with key, returns its value. Else,
+   returns NULL. */
+void *SymTable_get(SymTable_T symTable, const char *key) {
+   uint32_t *link;
+   uint32_t index;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   index = SymTable_find(symTable, key, &link);
+   if (index == NIL) {
+      return NULL;
+   }
+   return (void *)symTable->nodes[index].value;
+}
+
+/* If symTable contains a binding with key, removes it from symTable
+   and returns its value. Else, leaves symTable unchanged and returns
+   NULL. The bytes of its key are reclaimed when the key heap next
+   needs room. */
+void *SymTable_remove(SymTable_T symTable, const char *key) {
+   uint32_t *link;
+   uint32_t index;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   index = SymTable_find(symTable, key, &link);
+   if (index == NIL) {
+      return NULL;
+   }
+
+   /* Unlinking the STNode and adding it to the list of free
+      STNodes. */
+   *link = symTable->nodes[index].next;
+   symTable->nodes[index].next = symTable->freeNode;
+   symTable->freeNode = index;
+   symTable->heapDeadBytes += strlen(key) + 1;
+   symTable->numBindings--;
+   return (void *)symTable->nodes[index].value;
+}
+
+/* Applies functionApply to each binding in symTable, passing extra
+   as an extra parameter, that is, calls
+   (*functionApply)(key, (void*)value, (void*)extra) for each
+   key-value binding in symTable. */
+void SymTable_map(SymTable_T symTable, void (*functionApply)
+                  (const char *key, void *value, void *extra),
+                  const void *extra) {
+   size_t i;
+   uint32_t index;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(functionApply != NULL);
+
+   for (i = 0; i < symTable->numBuckets; i++) {
+      for (index = symTable->buckets[i]; index != NIL;
+           index = symTable->nodes[index].next) {
+         (*functionApply)(symTable->heap +
+                          symTable->nodes[index].keyOffset,
+                          (void *)symTable->nodes[index].value,
+                          (void *)extra);
+      }
+   }
+}
+
+/* Fills in *usage (unless usage is NULL) with the bytes allocated for
+   symTable: its pool of STNodes, its key heap (including the room not
+   yet used), and its buckets and SymTable structure, together with
+   the allocator's overhead. Returns the total. */
+size_t SymTable_memoryUsage(SymTable_T symTable,
+                            struct SymTable_MemoryUsage *usage) {
+   struct SymTable_MemoryUsage localUsage;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   if (usage == NULL) {
+      usage = &localUsage;
+   }
+   memset(usage, 0, sizeof(*usage));
+   usage->bucketBytes += SymTable_blockBytes
+      (symTable, sizeof(struct SymTable), &usage->overheadBytes);
+   usage->bucketBytes += SymTable_arrayBytes
+      (symTable->buckets, symTable->numBuckets * sizeof(uint32_t),
+       &usage->overheadBytes);
+   usage->nodeBytes += SymTable_arrayBytes
+      (symTable->nodes, symTable->nodeCapacity * sizeof(struct STNode),
+       &usage->overheadBytes);
+   usage->keyBytes += SymTable_arrayBytes
+      (symTable->heap, symTable->heapCapacity, &usage->overheadBytes);
+
+   usage->totalBytes = usage->nodeBytes + usage->keyBytes +
+                       usage->bucketBytes + usage->overheadBytes;
+   return usage->totalBytes;
+}
@@ -0,0 +1,14 @@
+#ifndef SYMTABLECOMPACT_INCLUDED
+#define SYMTABLECOMPACT_INCLUDED
+
+#include "symtable.h"
+
+/* Extensions of the SymTable interface, provided by the compact hash
+   table implementation (symtablecompact.c). */
+
+void SymTable_clear(SymTable_T symTable,
+                    void (*freeFunction)
+                    (const char *key, void *value, void *extra),
+                    const void *extra);
+
+#endif
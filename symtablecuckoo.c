@@ -0,0 +1,625 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: symtablecuckoo.c
+ *
+ *  Description: Implements a SymTable data type (collection of key-
+ *  -value bindings) as a bucketized cuckoo hash table, with functions
+ *  to allow its client to insert (put) new bindings, to retrieve
+ *  (get) the values of bindings with specified keys, and to remove
+ *  bindings with specified keys. This ADT additionally allows for a
+ *  SymTable structure to be freed if it is no longer to be used, for
+ *  a function to be applied to all key-value pairs, for the value for
+ *  a specified key to be replaced, and for checking if a SymTable
+ *  contains a given key.
+ *
+ *  Each binding lives in one of two buckets, given by two hash
+ *  functions of its key (taken from the two halves of one 64-bit
+ *  hash code, keyed with a random seed of its own in each table),
+ *  and each bucket holds up to four bindings in one cache
+ *  line: their hash codes and the addresses of their STEntries. A
+ *  lookup thus reads at most two buckets however full the table is,
+ *  and compares keys only with the STEntries whose hash codes match.
+ *  When both buckets of a new key are full, a breadth-first search
+ *  over the other buckets of the bindings in them finds the shortest
+ *  chain of bindings to move, each into its other bucket, that frees
+ *  a slot. If there is none while the table is still lightly loaded,
+ *  its keys have more likely collided than filled it, so they are
+ *  rehashed under a fresh seed into a bucket array of the same size;
+ *  otherwise the bucket array is doubled. A binding that does not
+ *  fit even so is not added, and the table is left as it was.
+ ******************************************************************* */
+#define _GNU_SOURCE
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "symtable.h"
+#include "symtableutil.h"
+
+/* Declaring an enum to hold the number of slots in a bucket, the
+   number of buckets of a new symbol table, the size in bytes of a
+   cache line (to which buckets are aligned), the largest percentage
+   of the slots that may be in use before the bucket array is
+   doubled, the largest percentage in use at which a binding that
+   finds no free slot has the keys rehashed under a fresh seed rather
+   than the bucket array doubled, the most buckets the search for a
+   free slot visits, and the most fresh seeds tried for one
+   binding. */
+enum{SLOTS = 4, INITIAL_BUCKETS = 16, CACHE_LINE = 64,
+     MAX_LOAD_PERCENT = 90, RESEED_LOAD_PERCENT = 50,
+     MAX_SEARCH_BUCKETS = 128, MAX_RESEEDS = 8};
+
+/* Each binding is stored in an STEntry, which holds the value and
+   the defensive copy of the key in one block. */
+struct STEntry {
+   /* The address of the value. */
+   const void *value;
+
+   /* The bytes of the key, ending with '\0'. */
+   char key[];
+};
+
+/* An STBucket holds up to SLOTS bindings, filling one cache line. */
+struct STBucket {
+   /* The hash codes of the keys of the bindings. */
+   uint64_t hashCodes[SLOTS];
+
+   /* The STEntries of the bindings, NULL for an empty slot. */
+   struct STEntry *entries[SLOTS];
+};
+
+/* A step of the search for a free slot: a bucket, reached by moving
+   the binding in a slot of the bucket of an earlier step into it. */
+struct STSearchStep {
+   /* The index of the bucket. */
+   size_t bucket;
+
+   /* The index of the earlier step (-1 for the two buckets of the
+      new key), and the slot of its bucket holding the binding. */
+   int parent;
+   int slot;
+};
+
+/* A SymTable structure is a 'manager' structure that contains the
+   array of buckets, its length, and the number of bindings. */
+struct SymTable {
+   /* The array of buckets, whose length is a power of 2. */
+   struct STBucket *buckets;
+
+   /* The number of buckets, less 1, used to reduce a hash code to a
+      bucket index. */
+   size_t bucketMask;
+
+   /* The number of bindings (key-value pairs) presently in the
+      symbol table. */
+   size_t numBindings;
+
+   /* The random seed of the hash function. */
+   uint64_t seed;
+};
+
+/* The random seed from which the seed of each symbol table's hash
+   function is derived, read once per process, and the control of
+   that reading. */
+static uint64_t processSeed;
+static pthread_once_t processSeedOnce = PTHREAD_ONCE_INIT;
+
+/* Reads processSeed from /dev/urandom or, failing that, derives it
+   from the time and the process ID. */
+static void SymTable_readProcessSeed(void) {
+   int fd;
+
+   fd = open("/dev/urandom", O_RDONLY);
+   if (fd < 0 || read(fd, &processSeed, sizeof(processSeed)) !=
+       (ssize_t)sizeof(processSeed)) {
+      processSeed = SymTable_mix((uint64_t)time(NULL) ^
+                                 SymTable_mix((uint64_t)getpid()));
+   }
+   if (fd >= 0) {
+      close(fd);
+   }
+}
+
+/* Returns a new seed for a hash function, derived from the random
+   seed of the process, salt and the time, so that no two calls are
+   likely to return the same one. */
+static uint64_t SymTable_newSeed(uint64_t salt) {
+   struct timespec now;
+
+   (void)pthread_once(&processSeedOnce, SymTable_readProcessSeed);
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return SymTable_mix(processSeed ^
+                       SymTable_mix(salt ^ (uint64_t)now.tv_sec ^
+                                    ((uint64_t)now.tv_nsec << 32)));
+}
+
+/* Returns a 64-bit hash code for pcKey under seed, whose low and high
+   halves serve as two independent hash functions. Each 8 bytes of
+   pcKey, and then the rest of them together with its length, are
+   mixed into the seed in turn, so that which keys collide depends on
+   the seed. */
+static uint64_t SymTable_hash(uint64_t seed, const char *pcKey) {
+   uint64_t uHash = seed;
+   uint64_t word;
+   size_t u, uLength;
+
+   assert(pcKey != NULL);
+
+   uLength = strlen(pcKey);
+   for (u = 0; u + 8 <= uLength; u += 8) {
+      memcpy(&word, pcKey + u, sizeof(word));
+      uHash = SymTable_mix(uHash ^ word);
+   }
+   word = (uint64_t)uLength << 56;
+   for (; u < uLength; u++) {
+      word |= (uint64_t)(unsigned char)pcKey[u] << (8 * (u % 8));
+   }
+   return SymTable_mix(uHash ^ word);
+}
+
+/* Returns the index of the first bucket of hashCode in a bucket
+   array of bucketMask + 1 buckets. */
+static size_t SymTable_firstBucket(uint64_t hashCode, size_t bucketMask) {
+   return (size_t)hashCode & bucketMask;
+}
+
+/* Returns the index of the second bucket of hashCode in a bucket
+   array of bucketMask + 1 buckets, which differs from its first. */
+static size_t SymTable_secondBucket(uint64_t hashCode,
+                                    size_t bucketMask) {
+   size_t first = (size_t)hashCode & bucketMask;
+   size_t second = (size_t)(hashCode >> 32) & bucketMask;
+
+   return second != first ? second : first ^ 1;
+}
+
+/* Returns the index of the bucket, other than bucket, in which a
+   binding with hashCode may live. */
+static size_t SymTable_otherBucket(uint64_t hashCode, size_t bucket,
+                                   size_t bucketMask) {
+   size_t first = SymTable_firstBucket(hashCode, bucketMask);
+
+   return bucket != first ? first :
+          SymTable_secondBucket(hashCode, bucketMask);
+}
+
+/* Returns the address of the slot of symTable holding the STEntry of
+   key, whose hash code is hashCode, or NULL if there is none. */
+static struct STEntry **SymTable_find(SymTable_T symTable,
+                                      const char *key,
+                                      uint64_t hashCode) {
+   struct STBucket *bucket;
+   int i;
+
+   bucket = &symTable->buckets[SymTable_firstBucket
+                               (hashCode, symTable->bucketMask)];
+   for (i = 0; i < SLOTS; i++) {
+      if (bucket->entries[i] != NULL && bucket->hashCodes[i] == hashCode &&
+          strcmp(bucket->entries[i]->key, key) == 0) {
+         return &bucket->entries[i];
+      }
+   }
+
+   bucket = &symTable->buckets[SymTable_secondBucket
+                               (hashCode, symTable->bucketMask)];
+   for (i = 0; i < SLOTS; i++) {
+      if (bucket->entries[i] != NULL && bucket->hashCodes[i] == hashCode &&
+          strcmp(bucket->entries[i]->key, key) == 0) {
+         return &bucket->entries[i];
+      }
+   }
+   return NULL;
+}
+
+/* Returns the index of an empty slot of bucket, or -1 if it is
+   full. */
+static int SymTable_freeSlot(const struct STBucket *bucket) {
+   int i;
+
+   for (i = 0; i < SLOTS; i++) {
+      if (bucket->entries[i] == NULL) {
+         return i;
+      }
+   }
+   return -1;
+}
+
+/* Adds entry, whose key has hashCode and has no binding, to the
+   bucketMask + 1 buckets at buckets, moving other bindings to their
+   other buckets if its own are full. Returns 1, or 0 (leaving the
+   buckets unchanged) if no chain of at most MAX_SEARCH_BUCKETS
+   buckets frees a slot. */
+static int SymTable_insert(struct STBucket *buckets, size_t bucketMask,
+                           struct STEntry *entry, uint64_t hashCode) {
+   struct STSearchStep steps[MAX_SEARCH_BUCKETS];
+   struct STBucket *from, *to;
+   int numSteps, head, i, slot, freeSlot;
+   size_t other;
+
+   /* Searching breadth first from the two buckets of the key, so
+      that the chain of moves found is a shortest one, until a bucket
+      with a free slot is reached. No bucket is visited twice. */
+   steps[0].bucket = SymTable_firstBucket(hashCode, bucketMask);
+   steps[1].bucket = SymTable_secondBucket(hashCode, bucketMask);
+   steps[0].parent = steps[1].parent = -1;
+   steps[0].slot = steps[1].slot = -1;
+   numSteps = 2;
+   freeSlot = -1;
+   for (head = 0; head < numSteps; head++) {
+      freeSlot = SymTable_freeSlot(&buckets[steps[head].bucket]);
+      if (freeSlot >= 0) {
+         break;
+      }
+      for (slot = 0; slot < SLOTS && numSteps < MAX_SEARCH_BUCKETS;
+           slot++) {
+         other = SymTable_otherBucket
+            (buckets[steps[head].bucket].hashCodes[slot],
+             steps[head].bucket, bucketMask);
+         for (i = 0; i < numSteps && steps[i].bucket != other; i++) {
+         }
+         if (i == numSteps) {
+            steps[numSteps].bucket = other;
+            steps[numSteps].parent = head;
+            steps[numSteps].slot = slot;
+            numSteps++;
+         }
+      }
+   }
+   if (freeSlot < 0) {
+      return 0;
+   }
+
+   /* Moving each binding of the chain, from the last, into the slot
+      the binding after it has left. */
+   while (steps[head].parent >= 0) {
+      from = &buckets[steps[steps[head].parent].bucket];
+      to = &buckets[steps[head].bucket];
+      slot = steps[head].slot;
+      to->hashCodes[freeSlot] = from->hashCodes[slot];
+      to->entries[freeSlot] = from->entries[slot];
+      from->entries[slot] = NULL;
+      freeSlot = slot;
+      head = steps[head].parent;
+   }
+
+   buckets[steps[head].bucket].hashCodes[freeSlot] = hashCode;
+   buckets[steps[head].bucket].entries[freeSlot] = entry;
+   return 1;
+}
+
+/* Returns the address of a new array of numBuckets empty buckets,
+   aligned to a cache line, or NULL if there is insufficient memory
+   available. */
+static struct STBucket *SymTable_allocBuckets(size_t numBuckets) {
+   void *buckets;
+
+   if (posix_memalign(&buckets, CACHE_LINE,
+                      numBuckets * sizeof(struct STBucket)) != 0) {
+      return NULL;
+   }
+   memset(buckets, 0, numBuckets * sizeof(struct STBucket));
+   return (struct STBucket *)buckets;
+}
+
+/* Moves the bindings of symTable, together with entry (whose key has
+   no binding), into a new array of newMask + 1 buckets, hashing
+   their keys under seed. Returns 1, or 0 (leaving symTable unchanged)
+   if there is insufficient memory available or they do not all
+   fit. */
+static int SymTable_rebuild(SymTable_T symTable, size_t newMask,
+                            uint64_t seed, struct STEntry *entry) {
+   struct STBucket *newBuckets;
+   struct STBucket *bucket;
+   uint64_t hashCode;
+   size_t b;
+   int i, isPlaced;
+
+   newBuckets = SymTable_allocBuckets(newMask + 1);
+   if (newBuckets == NULL) {
+      return 0;
+   }
+
+   isPlaced = 1;
+   for (b = 0; b <= symTable->bucketMask && isPlaced; b++) {
+      bucket = &symTable->buckets[b];
+      for (i = 0; i < SLOTS && isPlaced; i++) {
+         if (bucket->entries[i] != NULL) {
+            hashCode = seed == symTable->seed ? bucket->hashCodes[i] :
+                       SymTable_hash(seed, bucket->entries[i]->key);
+            isPlaced = SymTable_insert(newBuckets, newMask,
+                                       bucket->entries[i], hashCode);
+         }
+      }
+   }
+   if (isPlaced) {
+      isPlaced = SymTable_insert(newBuckets, newMask, entry,
+                                 SymTable_hash(seed, entry->key));
+   }
+   if (!isPlaced) {
+      free(newBuckets);
+      return 0;
+   }
+
+   free(symTable->buckets);
+   symTable->buckets = newBuckets;
+   symTable->bucketMask = newMask;
+   symTable->seed = seed;
+   return 1;
+}
+
+/* Adds entry, whose key has no binding, to symTable in a new array of
+   newMask + 1 buckets, keeping the seed of the hash function if the
+   array is larger than the present one, and otherwise, or if the
+   bindings do not fit, trying up to MAX_RESEEDS fresh seeds. Returns
+   1, or 0 (leaving symTable unchanged) if none fits. */
+static int SymTable_rebuildWith(SymTable_T symTable, size_t newMask,
+                                struct STEntry *entry) {
+   uint64_t seed = symTable->seed;
+   int attempt;
+
+   if (newMask != symTable->bucketMask &&
+       SymTable_rebuild(symTable, newMask, seed, entry)) {
+      return 1;
+   }
+   for (attempt = 0; attempt < MAX_RESEEDS; attempt++) {
+      seed = SymTable_newSeed(seed);
+      if (SymTable_rebuild(symTable, newMask, seed, entry)) {
+         return 1;
+      }
+   }
+   return 0;
+}
+
+/* Returns a new SymTable object that contains no bindings,
+   or NULL if there is insufficient memory available. */
+SymTable_T SymTable_new(void) {
+   SymTable_T symTable;
+
+   symTable = (SymTable_T)malloc(sizeof(struct SymTable));
+   if (symTable == NULL) {
+      return NULL;
+   }
+
+   symTable->buckets = SymTable_allocBuckets(INITIAL_BUCKETS);
+   if (symTable->buckets == NULL) {
+      free(symTable);
+      return NULL;
+   }
+   symTable->bucketMask = INITIAL_BUCKETS - 1;
+   symTable->numBindings = 0;
+
+   /* Choosing the seed of the hash function from the random seed of
+      the process, the address of symTable and the time, so that
+      each SymTable has its own. */
+   symTable->seed = SymTable_newSeed((uint64_t)(uintptr_t)symTable);
+   return symTable;
+}
+
+/* Frees all memory occupied by symTable. */
+void SymTable_free(SymTable_T symTable) {
+   size_t b;
+   int i;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   for (b = 0; b <= symTable->bucketMask; b++) {
+      for (i = 0; i < SLOTS; i++) {
+         free(symTable->buckets[b].entries[i]);
+      }
+   }
+   free(symTable->buckets);
+   free(symTable);
+}
+
+/* Returns number of bindings (key-value pairs) in symTable. */
+size_t SymTable_getLength(SymTable_T symTable) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   return symTable->numBindings;
+}
+
+/* If symTable does not contain a binding with key, adds a new
+   binding of key and value to symTable and returns 1. Else, leaves
+   symTable unchanged and returns 0, as it also does if insufficient
+   memory is available. */
+int SymTable_put(SymTable_T symTable, const char *key,
+                 const void *value) {
+   struct STEntry *entry;
+   uint64_t hashCode;
+   size_t keyLength, numSlots, newLoad;
+   int isAdded;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   hashCode = SymTable_hash(symTable->seed, key);
+   if (SymTable_find(symTable, key, hashCode) != NULL) {
+      return 0;
+   }
+
+   keyLength = strlen(key) + 1;
+   entry = (struct STEntry *)malloc(sizeof(struct STEntry) + keyLength);
+   if (entry == NULL) {
+      return 0;
+   }
+   entry->value = value;
+   memcpy(entry->key, key, keyLength);
+
+   /* Doubling the bucket array if the new binding would load it past
+      its maximum. Else, if no chain of moves frees a slot for the
+      binding while the array is lightly loaded, rehashing the keys
+      under a fresh seed into an array of the same size, and doubling
+      it only if they still do not fit. */
+   numSlots = (symTable->bucketMask + 1) * SLOTS;
+   newLoad = (symTable->numBindings + 1) * 100;
+   if (newLoad > numSlots * MAX_LOAD_PERCENT) {
+      isAdded = SymTable_rebuildWith(symTable,
+                                     symTable->bucketMask * 2 + 1, entry);
+   }
+   else {
+      isAdded = SymTable_insert(symTable->buckets, symTable->bucketMask,
+                                entry, hashCode) ||
+                (newLoad <= numSlots * RESEED_LOAD_PERCENT &&
+                 SymTable_rebuildWith(symTable, symTable->bucketMask,
+                                      entry)) ||
+                SymTable_rebuildWith(symTable,
+                                     symTable->bucketMask * 2 + 1, entry);
+   }
+   if (!isAdded) {
+      free(entry);
+      return 0;
+   }
+   symTable->numBindings++;
+   return 1;
+}
+
+/* If symTable contains a binding with key, returns its value and
+   replaces it with value. Else, leaves symTable unchanged and
+   returns NULL. */
+void *SymTable_replace(SymTable_T symTable, const char *key,
+                       const void *value) {
+   struct STEntry **slot;
+   void *oldValue;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   slot = SymTable_find(symTable, key,
+                        SymTable_hash(symTable->seed, key));
+   if (slot == NULL) {
+      return NULL;
+   }
+   oldValue = (void *)(*slot)->value;
+   (*slot)->value = value;
+   return oldValue;
+}
+
+/* Returns 1 if symTable contains a binding with key, or 0
+   otherwise. */
+int SymTable_contains(SymTable_T symTable, const char *key) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   return SymTable_find(symTable, key,
+                        SymTable_hash(symTable->seed, key)) != NULL;
+}
+
+/* If symTable contains a binding with key, returns its value. Else,
+   returns NULL. */
+void *SymTable_get(SymTable_T symTable, const char *key) {
+   struct STEntry **slot;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   slot = SymTable_find(symTable, key,
+                        SymTable_hash(symTable->seed, key));
+   if (slot == NULL) {
+      return NULL;
+   }
+   return (void *)(*slot)->value;
+}
+
+/* If symTable contains a binding with key, removes it from symTable
+   and returns its value. Else, leaves symTable unchanged and returns
+   NULL. */
+void *SymTable_remove(SymTable_T symTable, const char *key) {
+   struct STEntry **slot;
+   struct STEntry *entry;
+   void *value;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   slot = SymTable_find(symTable, key,
+                        SymTable_hash(symTable->seed, key));
+   if (slot == NULL) {
+      return NULL;
+   }
+   entry = *slot;
+   *slot = NULL;
+   value = (void *)entry->value;
+   free(entry);
+   symTable->numBindings--;
+   return value;
+}
+
+/* Applies functionApply to each binding in symTable, passing extra
+   as an extra parameter, that is, calls
+   (*functionApply)(key, (void*)value, (void*)extra) for each
+   key-value binding in symTable. */
+void SymTable_map(SymTable_T symTable, void (*functionApply)
+                  (const char *key, void *value, void *extra),
+                  const void *extra) {
+   struct STEntry *entry;
+   size_t b;
+   int i;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(functionApply != NULL);
+
+   for (b = 0; b <= symTable->bucketMask; b++) {
+      for (i = 0; i < SLOTS; i++) {
+         entry = symTable->buckets[b].entries[i];
+         if (entry != NULL) {
+            (*functionApply)(entry->key, (void *)entry->value,
+                             (void *)extra);
+         }
+      }
+   }
+}
+
+/* Fills in *usage (unless usage is NULL) with the bytes allocated for
+   symTable: its STEntries (the bytes of their keys counted apart),
+   and its buckets and SymTable structure, together with the
+   allocator's overhead. Returns the total. */
+size_t SymTable_memoryUsage(SymTable_T symTable,
+                            struct SymTable_MemoryUsage *usage) {
+   struct SymTable_MemoryUsage localUsage;
+   struct STEntry *entry;
+   size_t b, keyLength;
+   int i;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   if (usage == NULL) {
+      usage = &localUsage;
+   }
+   memset(usage, 0, sizeof(*usage));
+   usage->bucketBytes += SymTable_blockBytes
+      (symTable, sizeof(struct SymTable), &usage->overheadBytes);
+   usage->bucketBytes += SymTable_blockBytes
+      (symTable->buckets,
+       (symTable->bucketMask + 1) * sizeof(struct STBucket),
+       &usage->overheadBytes);
+
+   for (b = 0; b <= symTable->bucketMask; b++) {
+      for (i = 0; i < SLOTS; i++) {
+         entry = symTable->buckets[b].entries[i];
+         if (entry != NULL) {
+            keyLength = strlen(entry->key) + 1;
+            usage->nodeBytes += SymTable_blockBytes
+               (entry, sizeof(struct STEntry) + keyLength,
+                &usage->overheadBytes) - keyLength;
+            usage->keyBytes += keyLength;
+         }
+      }
+   }
+
+   usage->totalBytes = usage->nodeBytes + usage->keyBytes +
+                       usage->bucketBytes + usage->overheadBytes;
+   return usage->totalBytes;
+}
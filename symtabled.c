@@ -0,0 +1,626 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: symtabled.c
+ *
+ *  Description: A server that holds one SymTable and lets the
+ *  processes of the machine share it through a Unix domain socket,
+ *  speaking the protocol of symtabled.h. A single thread waits on
+ *  every connection with epoll. Whatever a connection has sent is
+ *  read in one go, every complete request in it is executed in turn,
+ *  and the responses are written back together, so that a client
+ *  which pipelines its requests pays for a system call per batch
+ *  rather than per request. The table stores a copy of the bytes of
+ *  each value. The implementation used is chosen by the environment
+ *  variable SYMTABLE_DEFAULT_BACKEND (see symtablelib.h).
+ ******************************************************************* */
+#define _GNU_SOURCE
+#include <assert.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "symtable.h"
+#include "symtabled.h"
+
+/* Declaring an enum to hold the most events taken from epoll at
+   once, the bytes asked of each read, the most reads made for a
+   connection before turning to the others, and the most bytes of
+   responses a connection may have waiting before its requests stop
+   being read. */
+enum{MAX_EVENTS = 64, READ_CHUNK = 65536, MAX_READS = 16,
+     MAX_PENDING_OUTPUT = 4194304};
+
+/* A growable array of bytes, of which those from start to length
+   are yet to be consumed. */
+struct SDBuffer {
+   char *bytes;
+   size_t start;
+   size_t length;
+   size_t capacity;
+};
+
+/* Each client is served through an SDConnection. */
+struct SDConnection {
+   /* The socket. */
+   int fd;
+
+   /* The bytes of requests received but not yet executed, and of
+      responses not yet sent. */
+   struct SDBuffer input;
+   struct SDBuffer output;
+
+   /* The events epoll is waiting for, and whether the client has
+      stopped sending (so that the connection is closed once its
+      responses are sent). */
+   unsigned events;
+   int isClosing;
+
+   /* The neighboring connections in the list of all of them. */
+   struct SDConnection *prev;
+   struct SDConnection *next;
+};
+
+/* Each value is stored as an SDValue holding a copy of its bytes. */
+struct SDValue {
+   size_t length;
+   char bytes[];
+};
+
+/* Whether a signal has asked the server to stop. */
+static volatile sig_atomic_t isStopping;
+
+/* Records that the server should stop. */
+static void SymTabled_handleSignal(int signalNumber) {
+   (void)signalNumber;
+   isStopping = 1;
+}
+
+/* Makes room in *buffer for at least extra more bytes, first moving
+   its unconsumed bytes to its beginning. Returns 1, or 0 if there is
+   insufficient memory available. */
+static int SymTabled_reserve(struct SDBuffer *buffer, size_t extra) {
+   size_t newCapacity;
+   char *newBytes;
+
+   assert(buffer != NULL);
+
+   if (buffer->start > 0) {
+      memmove(buffer->bytes, buffer->bytes + buffer->start,
+              buffer->length - buffer->start);
+      buffer->length -= buffer->start;
+      buffer->start = 0;
+   }
+   if (buffer->capacity - buffer->length > extra) {
+      return 1;
+   }
+
+   newCapacity = buffer->capacity == 0 ? READ_CHUNK : buffer->capacity;
+   while (newCapacity - buffer->length <= extra) {
+      newCapacity *= 2;
+   }
+   newBytes = (char *)realloc(buffer->bytes, newCapacity);
+   if (newBytes == NULL) {
+      return 0;
+   }
+   buffer->bytes = newBytes;
+   buffer->capacity = newCapacity;
+   return 1;
+}
+
+/* Appends to the output of connection a response of status holding
+   the bytes of value (if it is not NULL). Returns 1, or 0 if there
+   is insufficient memory available. */
+static int SymTabled_respond(struct SDConnection *connection,
+                             enum SymTabled_Status status,
+                             const struct SDValue *value) {
+   struct SymTabled_Response response;
+   struct SDBuffer *output;
+   size_t valueLength;
+
+   assert(connection != NULL);
+
+   output = &connection->output;
+   valueLength = value != NULL ? value->length : 0;
+   if (output->capacity - output->length < sizeof(response) +
+       valueLength &&
+       !SymTabled_reserve(output, sizeof(response) + valueLength)) {
+      return 0;
+   }
+
+   memset(&response, 0, sizeof(response));
+   response.status = (uint8_t)status;
+   response.valueLength = (uint32_t)valueLength;
+   memcpy(output->bytes + output->length, &response, sizeof(response));
+   output->length += sizeof(response);
+   if (value != NULL) {
+      memcpy(output->bytes + output->length, value->bytes, valueLength);
+      output->length += valueLength;
+   }
+   return 1;
+}
+
+/* Returns a new SDValue holding the valueLength bytes at value, or
+   NULL if there is insufficient memory available. */
+static struct SDValue *SymTabled_copyValue(const char *value,
+                                           size_t valueLength) {
+   struct SDValue *copy;
+
+   copy = (struct SDValue *)malloc(sizeof(struct SDValue) + valueLength);
+   if (copy == NULL) {
+      return NULL;
+   }
+   copy->length = valueLength;
+   memcpy(copy->bytes, value, valueLength);
+   return copy;
+}
+
+/* Executes on symTable the request of the given operation on key
+   (a string) and the valueLength bytes at value, appending its
+   response to the output of connection. Returns 1, or 0 if there is
+   insufficient memory available for the response. */
+static int SymTabled_execute(SymTable_T symTable,
+                             struct SDConnection *connection,
+                             int operation, const char *key,
+                             const char *value, size_t valueLength) {
+   struct SDValue *copy, *oldValue;
+   int isDone;
+
+   assert(symTable != NULL);
+   assert(connection != NULL);
+   assert(key != NULL);
+
+   switch (operation) {
+      case SYMTABLED_PUT:
+         copy = SymTabled_copyValue(value, valueLength);
+         if (copy == NULL) {
+            return SymTabled_respond(connection, SYMTABLED_NO_MEMORY,
+                                     NULL);
+         }
+         if (SymTable_put(symTable, key, copy)) {
+            return SymTabled_respond(connection, SYMTABLED_OK, NULL);
+         }
+         free(copy);
+         return SymTabled_respond(connection,
+                                  SymTable_contains(symTable, key) ?
+                                  SYMTABLED_FAILED :
+                                  SYMTABLED_NO_MEMORY, NULL);
+
+      case SYMTABLED_GET:
+         oldValue = (struct SDValue *)SymTable_get(symTable, key);
+         return SymTabled_respond(connection, oldValue != NULL ?
+                                  SYMTABLED_OK : SYMTABLED_FAILED,
+                                  oldValue);
+
+      case SYMTABLED_REMOVE:
+         oldValue = (struct SDValue *)SymTable_remove(symTable, key);
+         isDone = SymTabled_respond(connection, oldValue != NULL ?
+                                    SYMTABLED_OK : SYMTABLED_FAILED,
+                                    oldValue);
+         free(oldValue);
+         return isDone;
+
+      case SYMTABLED_REPLACE:
+         if (!SymTable_contains(symTable, key)) {
+            return SymTabled_respond(connection, SYMTABLED_FAILED, NULL);
+         }
+         copy = SymTabled_copyValue(value, valueLength);
+         if (copy == NULL) {
+            return SymTabled_respond(connection, SYMTABLED_NO_MEMORY,
+                                     NULL);
+         }
+         oldValue = (struct SDValue *)SymTable_replace(symTable, key,
+                                                       copy);
+         isDone = SymTabled_respond(connection, SYMTABLED_OK, oldValue);
+         free(oldValue);
+         return isDone;
+
+      default:
+         return SymTabled_respond(connection,
+                                  SymTable_contains(symTable, key) ?
+                                  SYMTABLED_OK : SYMTABLED_FAILED, NULL);
+   }
+}
+
+/* Returns the number of bytes of responses waiting to be sent on
+   connection. */
+static size_t SymTabled_pending(const struct SDConnection *connection) {
+   return connection->output.length - connection->output.start;
+}
+
+/* Returns 1 if input holds a whole request, which
+   SymTabled_executeAll has left for want of room for its response,
+   or 0 otherwise. */
+static int SymTabled_hasRequest(const struct SDBuffer *input) {
+   struct SymTabled_Request request;
+
+   if (input->length - input->start < sizeof(request)) {
+      return 0;
+   }
+   memcpy(&request, input->bytes + input->start, sizeof(request));
+   return input->length - input->start >=
+          sizeof(request) + (size_t)request.keyLength +
+          (size_t)request.valueLength;
+}
+
+/* Executes the complete requests in the input of connection on
+   symTable, in order, appending their responses to its output,
+   until MAX_PENDING_OUTPUT bytes of responses are waiting. The
+   requests left stay in the input, for SymTabled_serve to execute
+   once their responses have room. Returns 1, or 0 if a request is
+   malformed or there is insufficient memory available, in which
+   case the connection should be closed. */
+static int SymTabled_executeAll(SymTable_T symTable,
+                                struct SDConnection *connection) {
+   struct SymTabled_Request request;
+   struct SDBuffer *input;
+   size_t requestLength;
+   char *key, *value;
+
+   assert(symTable != NULL);
+   assert(connection != NULL);
+
+   input = &connection->input;
+   while (input->length - input->start >= sizeof(request) &&
+          SymTabled_pending(connection) < MAX_PENDING_OUTPUT) {
+      memcpy(&request, input->bytes + input->start, sizeof(request));
+      if (request.operation < SYMTABLED_PUT ||
+          request.operation > SYMTABLED_CONTAINS ||
+          request.keyLength > SYMTABLED_MAX_KEY_LENGTH ||
+          request.valueLength > SYMTABLED_MAX_VALUE_LENGTH) {
+         return 0;
+      }
+      requestLength = sizeof(request) + request.keyLength +
+                      request.valueLength;
+      if (input->length - input->start < requestLength) {
+         break;
+      }
+
+      /* Moving the key back a byte, over the header already copied
+         out, so that it may be terminated without touching the
+         value. */
+      value = input->bytes + input->start + sizeof(request) +
+              request.keyLength;
+      key = value - request.keyLength - 1;
+      memmove(key, key + 1, request.keyLength);
+      key[request.keyLength] = '\0';
+      if (memchr(key, '\0', request.keyLength) != NULL ||
+          !SymTabled_execute(symTable, connection, request.operation,
+                             key, value, request.valueLength)) {
+         return 0;
+      }
+      input->start += requestLength;
+   }
+
+   if (input->start == input->length) {
+      input->start = 0;
+      input->length = 0;
+   }
+   return 1;
+}
+
+/* Reads what connection has sent, up to MAX_READS chunks. Returns 1,
+   or 0 if the connection has failed or there is insufficient memory
+   available. Sets isClosing if the client has stopped sending. */
+static int SymTabled_receive(struct SDConnection *connection) {
+   struct SDBuffer *input;
+   ssize_t numRead;
+   int i;
+
+   assert(connection != NULL);
+
+   input = &connection->input;
+   for (i = 0; i < MAX_READS; i++) {
+      if (!SymTabled_reserve(input, READ_CHUNK)) {
+         return 0;
+      }
+      numRead = read(connection->fd, input->bytes + input->length,
+                     input->capacity - input->length);
+      if (numRead > 0) {
+         input->length += (size_t)numRead;
+         continue;
+      }
+      if (numRead == 0) {
+         connection->isClosing = 1;
+         return 1;
+      }
+      if (errno == EINTR) {
+         continue;
+      }
+      return errno == EAGAIN || errno == EWOULDBLOCK;
+   }
+   return 1;
+}
+
+/* Sends as much of the output of connection as its socket takes.
+   Returns 1, or 0 if the connection has failed. */
+static int SymTabled_send(struct SDConnection *connection) {
+   struct SDBuffer *output;
+   ssize_t numSent;
+
+   assert(connection != NULL);
+
+   output = &connection->output;
+   while (output->start < output->length) {
+      numSent = send(connection->fd, output->bytes + output->start,
+                     output->length - output->start, MSG_NOSIGNAL);
+      if (numSent < 0) {
+         if (errno == EINTR) {
+            continue;
+         }
+         return errno == EAGAIN || errno == EWOULDBLOCK;
+      }
+      output->start += (size_t)numSent;
+   }
+   output->start = 0;
+   output->length = 0;
+   return 1;
+}
+
+/* Closes connection, removing it from the list at *connections, and
+   frees it. */
+static void SymTabled_close(struct SDConnection **connections,
+                            struct SDConnection *connection) {
+   assert(connections != NULL);
+   assert(connection != NULL);
+
+   if (connection->prev != NULL) {
+      connection->prev->next = connection->next;
+   }
+   else {
+      *connections = connection->next;
+   }
+   if (connection->next != NULL) {
+      connection->next->prev = connection->prev;
+   }
+   close(connection->fd);
+   free(connection->input.bytes);
+   free(connection->output.bytes);
+   free(connection);
+}
+
+/* Has epollFd wait for the events connection now needs: input while
+   the client is sending, not too many responses are waiting and no
+   request is waiting for room for its response, and output while any
+   responses are waiting. Returns 1, or 0 if epoll fails. */
+static int SymTabled_watch(int epollFd, struct SDConnection *connection) {
+   struct epoll_event event;
+   unsigned events = 0;
+   size_t pending;
+
+   assert(connection != NULL);
+
+   pending = SymTabled_pending(connection);
+   if (!connection->isClosing && pending < MAX_PENDING_OUTPUT &&
+       !SymTabled_hasRequest(&connection->input)) {
+      events |= EPOLLIN;
+   }
+   if (pending > 0) {
+      events |= EPOLLOUT;
+   }
+   if (events == connection->events) {
+      return 1;
+   }
+
+   event.events = events;
+   event.data.ptr = connection;
+   if (epoll_ctl(epollFd, EPOLL_CTL_MOD, connection->fd, &event) < 0) {
+      return 0;
+   }
+   connection->events = events;
+   return 1;
+}
+
+/* Accepts every connection waiting on listenFd, watching each for
+   input with epollFd and adding it to the list at *connections. */
+static void SymTabled_accept(int epollFd, int listenFd,
+                             struct SDConnection **connections) {
+   struct SDConnection *connection;
+   struct epoll_event event;
+   int fd;
+
+   assert(connections != NULL);
+
+   for (;;) {
+      fd = accept4(listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+      if (fd < 0) {
+         if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            perror("symtabled: accept");
+         }
+         return;
+      }
+
+      connection = (struct SDConnection *)
+         calloc(1, sizeof(struct SDConnection));
+      if (connection == NULL) {
+         close(fd);
+         continue;
+      }
+      connection->fd = fd;
+      connection->events = EPOLLIN;
+      event.events = EPOLLIN;
+      event.data.ptr = connection;
+      if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+         close(fd);
+         free(connection);
+         continue;
+      }
+      connection->next = *connections;
+      if (*connections != NULL) {
+         (*connections)->prev = connection;
+      }
+      *connections = connection;
+   }
+}
+
+/* Serves connection, for which epoll reported events: reads and
+   executes its requests on symTable, and sends their responses,
+   executing the requests left waiting for room as their responses
+   are sent. Returns 1, or 0 if the connection should be closed. */
+static int SymTabled_serve(SymTable_T symTable, int epollFd,
+                           struct SDConnection *connection,
+                           unsigned events) {
+   int isBlocked;
+
+   assert(symTable != NULL);
+   assert(connection != NULL);
+
+   if ((events & (EPOLLIN | EPOLLHUP | EPOLLERR)) &&
+       !connection->isClosing &&
+       !SymTabled_hasRequest(&connection->input)) {
+      if (!SymTabled_receive(connection)) {
+         return 0;
+      }
+   }
+
+   /* Executing and sending in turn while the socket takes every
+      response and requests are left. */
+   do {
+      if (!SymTabled_executeAll(symTable, connection)) {
+         return 0;
+      }
+      isBlocked = SymTabled_pending(connection) >= MAX_PENDING_OUTPUT;
+      if (!SymTabled_send(connection)) {
+         return 0;
+      }
+   } while (isBlocked && SymTabled_pending(connection) == 0);
+
+   if (connection->isClosing &&
+       connection->output.start == connection->output.length) {
+      return 0;
+   }
+   return SymTabled_watch(epollFd, connection);
+}
+
+/* Returns a socket listening at path, replacing any socket left
+   there, or -1 if it cannot be created. */
+static int SymTabled_listen(const char *path) {
+   struct sockaddr_un address;
+   int fd;
+
+   assert(path != NULL);
+
+   if (strlen(path) >= sizeof(address.sun_path)) {
+      fprintf(stderr, "symtabled: socket path too long: %s\n", path);
+      return -1;
+   }
+   fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+   if (fd < 0) {
+      perror("symtabled: socket");
+      return -1;
+   }
+
+   memset(&address, 0, sizeof(address));
+   address.sun_family = AF_UNIX;
+   strcpy(address.sun_path, path);
+   (void)unlink(path);
+   if (bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0 ||
+       listen(fd, SOMAXCONN) < 0) {
+      perror("symtabled: bind");
+      close(fd);
+      return -1;
+   }
+   return fd;
+}
+
+/* Frees the value of a binding. */
+static void SymTabled_freeValue(const char *key, void *value,
+                                void *extra) {
+   (void)key;
+   (void)extra;
+   free(value);
+}
+
+/* Serves a SymTable at the socket given by "-s path" (or
+   SYMTABLED_SOCKET_PATH) until interrupted or terminated. Returns 0,
+   or 1 if the arguments are invalid or the server cannot start. */
+int main(int argc, char *argv[]) {
+   struct epoll_event events[MAX_EVENTS];
+   struct epoll_event event;
+   struct sigaction action;
+   struct SDConnection *connections = NULL;
+   struct SDConnection *connection;
+   SymTable_T symTable;
+   const char *path = SYMTABLED_SOCKET_PATH;
+   int listenFd, epollFd, numEvents, i, status = 0;
+
+   for (i = 1; i < argc; i++) {
+      if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+         path = argv[++i];
+      }
+      else {
+         fprintf(stderr, "Usage: %s [-s socketpath]\n", argv[0]);
+         return 1;
+      }
+   }
+
+   /* Stopping on SIGINT and SIGTERM, which interrupt epoll_wait, and
+      leaving SIGPIPE to the checks of send. */
+   memset(&action, 0, sizeof(action));
+   action.sa_handler = SymTabled_handleSignal;
+   sigemptyset(&action.sa_mask);
+   sigaction(SIGINT, &action, NULL);
+   sigaction(SIGTERM, &action, NULL);
+   signal(SIGPIPE, SIG_IGN);
+
+   symTable = SymTable_new();
+   if (symTable == NULL) {
+      fprintf(stderr, "symtabled: insufficient memory\n");
+      return 1;
+   }
+   listenFd = SymTabled_listen(path);
+   if (listenFd < 0) {
+      SymTable_free(symTable);
+      return 1;
+   }
+   epollFd = epoll_create1(EPOLL_CLOEXEC);
+   event.events = EPOLLIN;
+   event.data.ptr = NULL;
+   if (epollFd < 0 ||
+       epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event) < 0) {
+      perror("symtabled: epoll");
+      close(listenFd);
+      (void)unlink(path);
+      SymTable_free(symTable);
+      return 1;
+   }
+   fprintf(stderr, "symtabled: listening on %s\n", path);
+
+   while (!isStopping) {
+      numEvents = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+      if (numEvents < 0) {
+         if (errno == EINTR) {
+            continue;
+         }
+         perror("symtabled: epoll_wait");
+         status = 1;
+         break;
+      }
+      for (i = 0; i < numEvents; i++) {
+         connection = (struct SDConnection *)events[i].data.ptr;
+         if (connection == NULL) {
+            SymTabled_accept(epollFd, listenFd, &connections);
+         }
+         else if (!SymTabled_serve(symTable, epollFd, connection,
+                                   events[i].events)) {
+            SymTabled_close(&connections, connection);
+         }
+      }
+   }
+
+   while (connections != NULL) {
+      SymTabled_close(&connections, connections);
+   }
+   close(epollFd);
+   close(listenFd);
+   (void)unlink(path);
+   SymTable_map(symTable, SymTabled_freeValue, NULL);
+   SymTable_free(symTable);
+   return status;
+}
@@ -0,0 +1,47 @@
+#ifndef SYMTABLED_INCLUDED
+#define SYMTABLED_INCLUDED
+
+#include <stdint.h>
+
+/* The protocol spoken over the Unix domain socket of symtabled
+   (symtabled.c). A client sends a stream of requests, each a
+   SymTabled_Request followed by keyLength bytes of key (holding no
+   '\0') and valueLength bytes of value, and may send any number of
+   requests before reading the responses. The server answers each
+   request, in order, with a SymTabled_Response followed by
+   valueLength bytes of value. Lengths are in the byte order of the
+   host, since both ends run on it. */
+
+/* The default path of the socket. */
+#define SYMTABLED_SOCKET_PATH "/tmp/symtabled.sock"
+
+/* The operations a request may ask for. A put answers
+   SYMTABLED_OK if it added the binding; a get, remove or replace
+   answers SYMTABLED_OK with the value the binding had. */
+enum SymTabled_Operation {SYMTABLED_PUT = 1, SYMTABLED_GET,
+                          SYMTABLED_REMOVE, SYMTABLED_REPLACE,
+                          SYMTABLED_CONTAINS};
+
+/* The status of a response. SYMTABLED_FAILED means that the key had
+   no binding (or, for a put, already had one). */
+enum SymTabled_Status {SYMTABLED_OK, SYMTABLED_FAILED,
+                       SYMTABLED_NO_MEMORY};
+
+/* The longest key and value a request may hold. */
+enum {SYMTABLED_MAX_KEY_LENGTH = 65535,
+      SYMTABLED_MAX_VALUE_LENGTH = 16777216};
+
+struct SymTabled_Request {
+   uint8_t operation;
+   uint8_t reserved[3];
+   uint32_t keyLength;
+   uint32_t valueLength;
+};
+
+struct SymTabled_Response {
+   uint8_t status;
+   uint8_t reserved[3];
+   uint32_t valueLength;
+};
+
+#endif
@@ -0,0 +1,438 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: symtabledload.c
+ *
+ *  Description: Generates load on a symtabled server and measures
+ *  it. The client first puts a number of bindings, then runs a mix
+ *  of gets and replaces of random keys, sending its requests in
+ *  batches of a given depth and reading the whole batch of responses
+ *  before sending the next. Responses are read as they arrive while
+ *  a batch is being sent, since the server stops reading requests
+ *  while too many of its responses wait to be read. It reports the operations per second of
+ *  each phase and, for the mixed phase, percentiles of the latency
+ *  of a request, from the sending of its batch to the arrival of its
+ *  response. Several clients may be run at once to load the server
+ *  from several connections.
+ ******************************************************************* */
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "symtabled.h"
+
+/* Declaring an enum to hold the length of every key, and the bytes
+   asked of each read. */
+enum{KEY_LENGTH = 16, READ_CHUNK = 65536};
+
+/* The parameters of a run. */
+struct LoadConfig {
+   /* The path of the server's socket. */
+   const char *path;
+
+   /* The number of bindings put, and of operations in the mixed
+      phase. */
+   unsigned long numKeys;
+   unsigned long numOps;
+
+   /* The number of requests in each batch. */
+   unsigned long depth;
+
+   /* The percentage of the mixed phase that are gets. */
+   unsigned long getPercent;
+
+   /* The length of every value. */
+   size_t valueLength;
+};
+
+/* A connection to the server, with the bytes of responses read but
+   not yet parsed. */
+struct LoadConnection {
+   int fd;
+   char *bytes;
+   size_t start;
+   size_t length;
+   size_t capacity;
+};
+
+/* The state of the xorshift64* random number generator. */
+static unsigned long long randomState = 88172645463325252ULL;
+
+/* Returns the next pseudo-random 64-bit number. */
+static unsigned long long Load_random(void) {
+   randomState ^= randomState >> 12;
+   randomState ^= randomState << 25;
+   randomState ^= randomState >> 27;
+   return randomState * 0x2545F4914F6CDD1DULL;
+}
+
+/* Returns the present time in nanoseconds. */
+static unsigned long long Load_now(void) {
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return (unsigned long long)now.tv_sec * 1000000000 +
+          (unsigned long long)now.tv_nsec;
+}
+
+/* Appends to request (at *length) a request of operation on the key
+   of index, with valueLength bytes of value (if valueLength is not
+   0). */
+static void Load_addRequest(char *request, size_t *length,
+                            int operation, unsigned long index,
+                            size_t valueLength) {
+   struct SymTabled_Request header;
+   char key[KEY_LENGTH + 1];
+
+   assert(request != NULL);
+   assert(length != NULL);
+
+   (void)snprintf(key, sizeof(key), "key%013lu", index);
+   memset(&header, 0, sizeof(header));
+   header.operation = (uint8_t)operation;
+   header.keyLength = KEY_LENGTH;
+   header.valueLength = (uint32_t)valueLength;
+   memcpy(request + *length, &header, sizeof(header));
+   *length += sizeof(header);
+   memcpy(request + *length, key, KEY_LENGTH);
+   *length += KEY_LENGTH;
+   memset(request + *length, 'v', valueLength);
+   *length += valueLength;
+}
+
+/* Takes the next response from the bytes read from connection,
+   skipping its value, and stores its status in *status. Returns 1,
+   or 0 if the whole response has not yet been read. */
+static int Load_takeResponse(struct LoadConnection *connection,
+                             int *status) {
+   struct SymTabled_Response response;
+   size_t available;
+
+   assert(connection != NULL);
+   assert(status != NULL);
+
+   available = connection->length - connection->start;
+   if (available < sizeof(response)) {
+      return 0;
+   }
+   memcpy(&response, connection->bytes + connection->start,
+          sizeof(response));
+   if (available < sizeof(response) + response.valueLength) {
+      return 0;
+   }
+   connection->start += sizeof(response) + response.valueLength;
+   *status = response.status;
+   return 1;
+}
+
+/* Reads what the server has sent on connection, once. Returns 1, or
+   0 if the connection fails or there is insufficient memory
+   available. */
+static int Load_receive(struct LoadConnection *connection) {
+   size_t available;
+   ssize_t numRead;
+   char *newBytes;
+
+   assert(connection != NULL);
+
+   /* Moving the unparsed bytes to the beginning, and making room for
+      a chunk more. */
+   available = connection->length - connection->start;
+   memmove(connection->bytes, connection->bytes + connection->start,
+           available);
+   connection->start = 0;
+   connection->length = available;
+   if (connection->capacity - connection->length < READ_CHUNK) {
+      newBytes = (char *)realloc(connection->bytes,
+                                 connection->capacity * 2);
+      if (newBytes == NULL) {
+         return 0;
+      }
+      connection->bytes = newBytes;
+      connection->capacity *= 2;
+   }
+
+   numRead = read(connection->fd, connection->bytes + connection->length,
+                  connection->capacity - connection->length);
+   if (numRead < 0) {
+      return errno == EINTR;
+   }
+   if (numRead == 0) {
+      return 0;
+   }
+   connection->length += (size_t)numRead;
+   return 1;
+}
+
+/* Waits until connection can take more of the length bytes of
+   request from *numSent on, or has responses to be read, and sends
+   or reads what it can, adding the bytes sent to *numSent. Returns 1,
+   or 0 if the connection fails or there is insufficient memory
+   available. */
+static int Load_exchange(struct LoadConnection *connection,
+                         const char *request, size_t length,
+                         size_t *numSent) {
+   struct pollfd pollFd;
+   ssize_t numWritten;
+
+   assert(connection != NULL);
+   assert(request != NULL);
+   assert(numSent != NULL);
+
+   pollFd.fd = connection->fd;
+   pollFd.events = POLLIN;
+   if (*numSent < length) {
+      pollFd.events |= POLLOUT;
+   }
+   if (poll(&pollFd, 1, -1) < 0) {
+      return errno == EINTR;
+   }
+
+   if (pollFd.revents & POLLOUT) {
+      numWritten = send(connection->fd, request + *numSent,
+                        length - *numSent, MSG_DONTWAIT | MSG_NOSIGNAL);
+      if (numWritten >= 0) {
+         *numSent += (size_t)numWritten;
+      }
+      else if (errno != EINTR && errno != EAGAIN &&
+               errno != EWOULDBLOCK) {
+         return 0;
+      }
+   }
+   if (pollFd.revents & (POLLIN | POLLHUP | POLLERR)) {
+      return Load_receive(connection);
+   }
+   return 1;
+}
+
+/* Compares the latencies at first and second, for qsort. */
+static int Load_compare(const void *first, const void *second) {
+   unsigned long long a = *(const unsigned long long *)first;
+   unsigned long long b = *(const unsigned long long *)second;
+
+   return (a > b) - (a < b);
+}
+
+/* Runs phase against connection: numOps requests, in batches of
+   depth, of puts of keys 0 to numOps-1 if isLoading is nonzero and
+   of the configured mix of gets and replaces otherwise. Stores the
+   latency of each request in latencies (if it is not NULL), and
+   reports the phase. Returns 1, or 0 if the connection fails. */
+static int Load_runPhase(struct LoadConnection *connection,
+                         const struct LoadConfig *config,
+                         const char *phase, unsigned long numOps,
+                         int isLoading, char *request,
+                         unsigned long long *latencies) {
+   unsigned long long startNanos, batchNanos, nanos;
+   unsigned long i, j, batchSize, numOk = 0;
+   size_t length, numSent;
+   int operation, status;
+
+   assert(connection != NULL);
+   assert(config != NULL);
+   assert(request != NULL);
+
+   startNanos = Load_now();
+   for (i = 0; i < numOps; i += batchSize) {
+      batchSize = numOps - i < config->depth ? numOps - i : config->depth;
+      length = 0;
+      for (j = 0; j < batchSize; j++) {
+         if (isLoading) {
+            Load_addRequest(request, &length, SYMTABLED_PUT, i + j,
+                            config->valueLength);
+         }
+         else {
+            operation = Load_random() % 100 < config->getPercent ?
+                        SYMTABLED_GET : SYMTABLED_REPLACE;
+            Load_addRequest(request, &length, operation,
+                            (unsigned long)(Load_random() %
+                                            config->numKeys),
+                            operation == SYMTABLED_GET ? 0 :
+                            config->valueLength);
+         }
+      }
+
+      /* Sending the batch while taking its responses as they
+         arrive. */
+      batchNanos = Load_now();
+      numSent = 0;
+      j = 0;
+      while (j < batchSize) {
+         if (!Load_takeResponse(connection, &status)) {
+            if (!Load_exchange(connection, request, length, &numSent)) {
+               return 0;
+            }
+            continue;
+         }
+         numOk += status == SYMTABLED_OK;
+         if (latencies != NULL) {
+            latencies[i + j] = Load_now() - batchNanos;
+         }
+         j++;
+      }
+   }
+   nanos = Load_now() - startNanos;
+   if (nanos == 0) {
+      nanos = 1;
+   }
+
+   printf("symtabledload phase %-6s depth %lu ops %lu ok %lu "
+          "ops/sec %.0f\n", phase, config->depth, numOps, numOk,
+          (double)numOps * 1e9 / (double)nanos);
+   return 1;
+}
+
+/* Reports the percentiles of the numOps latencies, sorting them. */
+static void Load_reportLatencies(unsigned long long *latencies,
+                                 unsigned long numOps) {
+   static const double percentiles[] = {50.0, 90.0, 99.0, 99.9, 100.0};
+   size_t i, index;
+
+   assert(latencies != NULL);
+
+   if (numOps == 0) {
+      return;
+   }
+   qsort(latencies, numOps, sizeof(unsigned long long), Load_compare);
+   printf("symtabledload latency-us");
+   for (i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); i++) {
+      index = (size_t)((double)(numOps - 1) * percentiles[i] / 100.0);
+      printf(" p%g %.1f", percentiles[i],
+             (double)latencies[index] / 1000.0);
+   }
+   printf("\n");
+}
+
+/* Returns a socket connected to the server at path, or -1 if it
+   cannot be connected. */
+static int Load_connect(const char *path) {
+   struct sockaddr_un address;
+   int fd;
+
+   assert(path != NULL);
+
+   if (strlen(path) >= sizeof(address.sun_path)) {
+      return -1;
+   }
+   fd = socket(AF_UNIX, SOCK_STREAM, 0);
+   if (fd < 0) {
+      return -1;
+   }
+   memset(&address, 0, sizeof(address));
+   address.sun_family = AF_UNIX;
+   strcpy(address.sun_path, path);
+   if (connect(fd, (struct sockaddr *)&address, sizeof(address)) < 0) {
+      close(fd);
+      return -1;
+   }
+   return fd;
+}
+
+/* Writes the usage of program to stderr. */
+static void Load_usage(const char *program) {
+   fprintf(stderr,
+           "Usage: %s [-s socketpath] [-k keys] [-n ops] [-d depth]\n"
+           "          [-g getpercent] [-v valuelength]\n", program);
+}
+
+/* Loads the server configured by the arguments, and reports its
+   throughput and latency. Returns 0, or 1 if the arguments are
+   invalid, the server cannot be reached or there is insufficient
+   memory available. */
+int main(int argc, char *argv[]) {
+   struct LoadConfig config;
+   struct LoadConnection connection;
+   unsigned long long *latencies;
+   char *request;
+   int arg, option, isDone;
+
+   config.path = SYMTABLED_SOCKET_PATH;
+   config.numKeys = 100000;
+   config.numOps = 1000000;
+   config.depth = 32;
+   config.getPercent = 90;
+   config.valueLength = 32;
+
+   for (arg = 1; arg < argc; arg++) {
+      if (arg + 1 >= argc || argv[arg][0] != '-' ||
+          argv[arg][1] == '\0' || argv[arg][2] != '\0') {
+         Load_usage(argv[0]);
+         return 1;
+      }
+      option = argv[arg++][1];
+      switch (option) {
+         case 's':
+            config.path = argv[arg];
+            break;
+         case 'k':
+            config.numKeys = strtoul(argv[arg], NULL, 10);
+            break;
+         case 'n':
+            config.numOps = strtoul(argv[arg], NULL, 10);
+            break;
+         case 'd':
+            config.depth = strtoul(argv[arg], NULL, 10);
+            break;
+         case 'g':
+            config.getPercent = strtoul(argv[arg], NULL, 10);
+            break;
+         case 'v':
+            config.valueLength = (size_t)strtoul(argv[arg], NULL, 10);
+            break;
+         default:
+            Load_usage(argv[0]);
+            return 1;
+      }
+   }
+   if (config.numKeys == 0 || config.depth == 0 ||
+       config.getPercent > 100 ||
+       config.valueLength > SYMTABLED_MAX_VALUE_LENGTH) {
+      Load_usage(argv[0]);
+      return 1;
+   }
+
+   connection.fd = Load_connect(config.path);
+   if (connection.fd < 0) {
+      fprintf(stderr, "%s: cannot connect to %s\n", argv[0], config.path);
+      return 1;
+   }
+   connection.start = 0;
+   connection.length = 0;
+   connection.capacity = READ_CHUNK;
+   connection.bytes = (char *)malloc(connection.capacity);
+   request = (char *)malloc(config.depth *
+                            (sizeof(struct SymTabled_Request) +
+                             KEY_LENGTH + config.valueLength));
+   latencies = (unsigned long long *)
+      malloc((config.numOps + 1) * sizeof(unsigned long long));
+   if (connection.bytes == NULL || request == NULL || latencies == NULL) {
+      fprintf(stderr, "%s: insufficient memory\n", argv[0]);
+      isDone = 0;
+   }
+   else {
+      isDone = Load_runPhase(&connection, &config, "put",
+                             config.numKeys, 1, request, NULL) &&
+               Load_runPhase(&connection, &config, "mixed",
+                             config.numOps, 0, request, latencies);
+      if (isDone) {
+         Load_reportLatencies(latencies, config.numOps);
+      }
+      else {
+         fprintf(stderr, "%s: connection failed\n", argv[0]);
+      }
+   }
+
+   close(connection.fd);
+   free(connection.bytes);
+   free(request);
+   free(latencies);
+   return isDone ? 0 : 1;
+}
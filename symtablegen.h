@@ -0,0 +1,235 @@
+#ifndef SYMTABLEGEN_INCLUDED
+#define SYMTABLEGEN_INCLUDED
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "symtableutil.h"
+
+/* SYMTABLE_DEFINE(name, ValueType) defines a symbol table type name_T
+   whose values are of type ValueType and are stored by value, inside
+   the node holding the binding, rather than as const void * addresses
+   of values stored elsewhere. Each binding is a single allocation
+   holding its hash code, its link, its value and the defensive copy
+   of its key. Since every function is defined static (and
+   SYMTABLE_INLINE) in the file that uses the macro, the compiler may
+   inline them and specialize the copying of values.
+
+   The functions mirror those of symtable.h:
+
+      name_T name_new(void);
+      void name_free(name_T table);
+      size_t name_getLength(name_T table);
+      int name_put(name_T table, const char *key, ValueType value);
+      int name_replace(name_T table, const char *key, ValueType value,
+                       ValueType *oldValue);
+      int name_contains(name_T table, const char *key);
+      ValueType *name_get(name_T table, const char *key);
+      int name_remove(name_T table, const char *key,
+                      ValueType *oldValue);
+      void name_map(name_T table, void (*functionApply)
+                    (const char *key, ValueType *value, void *extra),
+                    const void *extra);
+
+   Since a value cannot be NULL, name_replace and name_remove return 1
+   if key was found (storing the old value in *oldValue, unless
+   oldValue is NULL) or 0 otherwise, and name_get returns the address
+   of the value held in the table (valid until the binding is removed)
+   or NULL. The macro must be used at file scope, once per name. */
+
+/* Declaring an enum to hold the number of buckets of a new table,
+   and its base 2 logarithm. */
+enum{SYMTABLEGEN_INITIAL_BUCKETS = 16, SYMTABLEGEN_INITIAL_BITS = 4};
+
+#define SYMTABLE_DEFINE(name, ValueType)                                 \
+                                                                         \
+struct name##_Node {                                                     \
+   size_t hashCode;                                                      \
+   struct name##_Node *next;                                             \
+   ValueType value;                                                      \
+   char key[1];                                                          \
+};                                                                       \
+                                                                         \
+struct name {                                                            \
+   struct name##_Node **buckets;                                         \
+   size_t numBuckets;                                                    \
+   int bucketShift;                                                      \
+   size_t numBindings;                                                   \
+};                                                                       \
+                                                                         \
+typedef struct name *name##_T;                                           \
+                                                                         \
+static SYMTABLE_INLINE name##_T name##_new(void) {                       \
+   name##_T table = (name##_T)malloc(sizeof(struct name));               \
+   if (table == NULL) {                                                  \
+      return NULL;                                                       \
+   }                                                                     \
+   table->buckets = (struct name##_Node **)                              \
+      calloc(SYMTABLEGEN_INITIAL_BUCKETS, sizeof(struct name##_Node *)); \
+   if (table->buckets == NULL) {                                         \
+      free(table);                                                       \
+      return NULL;                                                       \
+   }                                                                     \
+   table->numBuckets = SYMTABLEGEN_INITIAL_BUCKETS;                      \
+   table->bucketShift = (int)(sizeof(size_t) * 8) -                      \
+                        SYMTABLEGEN_INITIAL_BITS;                        \
+   table->numBindings = 0;                                               \
+   return table;                                                         \
+}                                                                        \
+                                                                         \
+static SYMTABLE_INLINE void name##_free(name##_T table) {                \
+   struct name##_Node *node, *nextNode;                                  \
+   size_t i;                                                             \
+   assert(table != NULL);                                                \
+   for (i = 0; i < table->numBuckets; i++) {                             \
+      for (node = table->buckets[i]; node != NULL; node = nextNode) {    \
+         nextNode = node->next;                                          \
+         free(node);                                                     \
+      }                                                                  \
+   }                                                                     \
+   free(table->buckets);                                                 \
+   free(table);                                                          \
+}                                                                        \
+                                                                         \
+static SYMTABLE_INLINE size_t name##_getLength(name##_T table) {         \
+   assert(table != NULL);                                                \
+   return table->numBindings;                                            \
+}                                                                        \
+                                                                         \
+/* Returns the address of the link referring to the node of table      \
+   holding key, or to NULL at the end of its bucket if there is none. */ \
+static SYMTABLE_INLINE struct name##_Node **                             \
+name##_findRef(name##_T table, const char *key, size_t hashCode,         \
+               size_t keyLength) {                                       \
+   struct name##_Node **nodeRef =                                        \
+      &table->buckets[hashCode >> table->bucketShift];                   \
+   while (*nodeRef != NULL &&                                            \
+          ((*nodeRef)->hashCode != hashCode ||                           \
+           memcmp((*nodeRef)->key, key, keyLength + 1) != 0)) {          \
+      nodeRef = &(*nodeRef)->next;                                       \
+   }                                                                     \
+   return nodeRef;                                                       \
+}                                                                        \
+                                                                         \
+/* Doubles the number of buckets of table, leaving it unchanged if     \
+   there is insufficient memory available. */                            \
+static SYMTABLE_INLINE void name##_grow(name##_T table) {                \
+   struct name##_Node **newBuckets;                                      \
+   struct name##_Node *node, *nextNode;                                  \
+   size_t i, bucket;                                                     \
+   newBuckets = (struct name##_Node **)                                  \
+      calloc(table->numBuckets * 2, sizeof(struct name##_Node *));       \
+   if (newBuckets == NULL) {                                             \
+      return;                                                            \
+   }                                                                     \
+   for (i = 0; i < table->numBuckets; i++) {                             \
+      for (node = table->buckets[i]; node != NULL; node = nextNode) {    \
+         nextNode = node->next;                                          \
+         bucket = node->hashCode >> (table->bucketShift - 1);            \
+         node->next = newBuckets[bucket];                                \
+         newBuckets[bucket] = node;                                      \
+      }                                                                  \
+   }                                                                     \
+   free(table->buckets);                                                 \
+   table->buckets = newBuckets;                                          \
+   table->numBuckets *= 2;                                               \
+   table->bucketShift--;                                                 \
+}                                                                        \
+                                                                         \
+static SYMTABLE_INLINE int name##_put(name##_T table, const char *key,   \
+                                      ValueType value) {                 \
+   struct name##_Node **nodeRef;                                         \
+   struct name##_Node *node;                                             \
+   size_t hashCode, keyLength;                                           \
+   assert(table != NULL);                                                \
+   assert(key != NULL);                                                  \
+   hashCode = (size_t)SymTable_stringHash(key, &keyLength);              \
+   nodeRef = name##_findRef(table, key, hashCode, keyLength);            \
+   if (*nodeRef != NULL) {                                               \
+      return 0;                                                          \
+   }                                                                     \
+   node = (struct name##_Node *)                                         \
+      malloc(offsetof(struct name##_Node, key) + keyLength + 1);         \
+   if (node == NULL) {                                                   \
+      return 0;                                                          \
+   }                                                                     \
+   node->hashCode = hashCode;                                            \
+   node->value = value;                                                  \
+   memcpy(node->key, key, keyLength + 1);                                \
+   node->next = NULL;                                                    \
+   *nodeRef = node;                                                      \
+   table->numBindings++;                                                 \
+   if (table->numBindings > table->numBuckets && table->bucketShift > 1) \
+      name##_grow(table);                                                \
+   return 1;                                                             \
+}                                                                        \
+                                                                         \
+static SYMTABLE_INLINE ValueType *                                       \
+name##_get(name##_T table, const char *key) {                            \
+   struct name##_Node *node;                                             \
+   size_t hashCode, keyLength;                                           \
+   assert(table != NULL);                                                \
+   assert(key != NULL);                                                  \
+   hashCode = (size_t)SymTable_stringHash(key, &keyLength);              \
+   node = *name##_findRef(table, key, hashCode, keyLength);              \
+   return node != NULL ? &node->value : NULL;                            \
+}                                                                        \
+                                                                         \
+static SYMTABLE_INLINE int                                               \
+name##_contains(name##_T table, const char *key) {                       \
+   return name##_get(table, key) != NULL;                                \
+}                                                                        \
+                                                                         \
+static SYMTABLE_INLINE int                                               \
+name##_replace(name##_T table, const char *key, ValueType value,         \
+               ValueType *oldValue) {                                    \
+   ValueType *valueRef = name##_get(table, key);                         \
+   if (valueRef == NULL) {                                               \
+      return 0;                                                          \
+   }                                                                     \
+   if (oldValue != NULL) {                                               \
+      *oldValue = *valueRef;                                             \
+   }                                                                     \
+   *valueRef = value;                                                    \
+   return 1;                                                             \
+}                                                                        \
+                                                                         \
+static SYMTABLE_INLINE int                                               \
+name##_remove(name##_T table, const char *key, ValueType *oldValue) {    \
+   struct name##_Node **nodeRef;                                         \
+   struct name##_Node *node;                                             \
+   size_t hashCode, keyLength;                                           \
+   assert(table != NULL);                                                \
+   assert(key != NULL);                                                  \
+   hashCode = (size_t)SymTable_stringHash(key, &keyLength);              \
+   nodeRef = name##_findRef(table, key, hashCode, keyLength);            \
+   node = *nodeRef;                                                      \
+   if (node == NULL) {                                                   \
+      return 0;                                                          \
+   }                                                                     \
+   if (oldValue != NULL) {                                               \
+      *oldValue = node->value;                                           \
+   }                                                                     \
+   *nodeRef = node->next;                                                \
+   free(node);                                                           \
+   table->numBindings--;                                                 \
+   return 1;                                                             \
+}                                                                        \
+                                                                         \
+static SYMTABLE_INLINE void                                              \
+name##_map(name##_T table, void (*functionApply)                         \
+           (const char *key, ValueType *value, void *extra),             \
+           const void *extra) {                                          \
+   struct name##_Node *node;                                             \
+   size_t i;                                                             \
+   assert(table != NULL);                                                \
+   assert(functionApply != NULL);                                        \
+   for (i = 0; i < table->numBuckets; i++) {                             \
+      for (node = table->buckets[i]; node != NULL; node = node->next) {  \
+         (*functionApply)(node->key, &node->value, (void *)extra);       \
+      }                                                                  \
+   }                                                                     \
+}
+
+#endif
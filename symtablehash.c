@@ -11,18 +11,82 @@
  *  ADT additionally allows for a SymTable structure to be freed if
  *  it is no longer to be used, for a function to be applied to all
  *  key-value pairs, for the value for a specified key to be replaced,
- *  and for checking if a SymTable contains a given key.
+ *  and for checking if a SymTable contains a given key. A SymTable
+ *  may optionally keep a counting Bloom filter of its keys, so that
+ *  most lookups of missing keys are answered without walking a list.
+ *  A bounded SymTable acts as a cache, evicting its least recently
+ *  used binding when a new binding would exceed its bound. Bindings
+ *  may be given a time to live, after which they are treated as
+ *  missing and reclaimed by a hierarchical timer wheel. An
+ *  instrumented SymTable records the latency of each operation.
+ *
+ *  Keys are hashed with SipHash-1-3 under a random key chosen for
+ *  each SymTable, so that which keys collide cannot be predicted
+ *  from outside. A linked list that grows long all the same (an
+ *  attack that learns the key, or a table beyond the largest number
+ *  of buckets) is indexed by a balanced (AVL) tree, as Java's
+ *  HashMap does, so that every operation on it takes logarithmic
+ *  rather than linear time.
+ *
+ *  The bucket array of a large SymTable is mapped directly from the
+ *  system and grown with mremap (see symtablearray.h), and doubling
+ *  it splits each linked list in place.
  ******************************************************************* */
+#define _GNU_SOURCE
 #include <assert.h>
 #include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <fcntl.h>
 #include <malloc.h>
-#include "symtable.h"
-
-/* Declaring an enum to hold the maximum number of buckets. */
-enum{MAX_BUCKETS = 65521};
-
-/* Declaring a global variable to hold the different bucket counts. */
-static size_t bucketCounts[] = {509, 1021, 2039, 4093, 8191, 16381, 32749, 65521};
+#include <pthread.h>
+#include <unistd.h>
+#include "symtablehash.h"
+#include "symtablelatency.h"
+#include "symtablearray.h"
+
+/* The bits kept of each hash code. A test build may define
+   SYMTABLE_HASH_MASK to keep only a few, so that keys collide. */
+#ifndef SYMTABLE_HASH_MASK
+#define SYMTABLE_HASH_MASK SIZE_MAX
+#endif
+
+/* Declaring an enum to hold the initial and the maximum numbers of
+   buckets, both powers of 2. */
+enum{MIN_BUCKETS = 512, MAX_BUCKETS = 1 << 30};
+
+/* Declaring an enum to hold the length a linked list reaches when it
+   is indexed by a tree (which, with at most one binding per bucket,
+   about one bucket in a billion reaches unless keys collide), the
+   height of a tree at or below which (at most 3 bindings) the tree
+   is discarded again, and the number of buckets below which a long
+   linked list doubles the buckets instead of being indexed. */
+enum{TREEIFY_THRESHOLD = 12, UNTREEIFY_HEIGHT = 2,
+     MIN_TREEIFY_BUCKETS = 2048};
+
+/* Declaring an enum to hold the size of a Bloom filter block (one
+   cache line) in bytes, the number of 4-bit counters in a block, the
+   number of counters set per key, the largest value of a counter,
+   and the number of counters per binding the filter is sized for. */
+enum{BLOOM_BLOCK_BYTES = 64, BLOOM_BLOCK_COUNTERS = 128,
+     BLOOM_NUM_PROBES = 4, BLOOM_MAX_COUNT = 15,
+     BLOOM_COUNTERS_PER_BINDING = 12};
+
+/* Declaring an enum to hold the number of levels of the timer wheel,
+   the number of bits of a time (in milliseconds) that select a slot
+   at each level, the number of slots per level, and the largest
+   number of expired bindings reclaimed by each operation. */
+enum{WHEEL_LEVELS = 4, WHEEL_SLOT_BITS = 6,
+     WHEEL_SLOTS = 1 << WHEEL_SLOT_BITS, EXPIRE_BUDGET = 4};
+
+/* Declaring an enum to hold the largest number of threads a set
+   operation runs on, and the numbers of buckets and of bindings from
+   which it uses more than one. */
+enum{SET_MAX_THREADS = 8, SET_PARALLEL_MIN_BUCKETS = 8192,
+     SET_PARALLEL_MIN_BINDINGS = 65536};
+
+/* The set operations, as run on a range of buckets by SymTable_runSetJob. */
+enum SetOperation {SET_MERGE, SET_INTERSECT, SET_DIFFERENCE};
 
 /* Each item is stored in an STNode. STNodes are linked to form a list.  */
 struct STNode {
@@ -32,10 +96,102 @@ struct STNode {
    /* The address of the value. */
    const void *value;
 
+   /* The hash code of the key, before it is reduced to a bucket
+      index, kept so that rehashing need not look at the key. */
+   size_t hashCode;
+
    /* The address of the next STNode. */
    struct STNode *next;
 };
 
+/* In a bounded symbol table, or one to which a binding with a time
+   to live has been put, each STNode is the first member of an
+   STLinkedNode, so that other symbol tables pay nothing for the
+   recency list and the timers. */
+struct STLinkedNode {
+   /* The STNode itself. */
+   struct STNode node;
+
+   /* In a bounded symbol table, the addresses of the STNodes used
+      just after and just before this one. */
+   struct STNode *newer;
+   struct STNode *older;
+
+   /* The address of the STTimer of a binding with a time to live,
+      or NULL. */
+   struct STTimer *timer;
+};
+
+/* A long linked list is indexed by a tree of STTreeNodes, one per
+   STNode, ordered by hash code and then by key. The list is kept in
+   the same order, so that the STNode before any other is found in the
+   tree. */
+struct STTreeNode {
+   /* The address of the STNode. */
+   struct STNode *node;
+
+   /* The subtrees of the STNodes ordered before and after it. */
+   struct STTreeNode *left;
+   struct STTreeNode *right;
+
+   /* The height of the subtree rooted here, 1 for a leaf. */
+   int height;
+};
+
+/* The expiry time of a binding is kept in an STTimer, which is linked
+   into a list at one slot of the timer wheel of its symbol table. */
+struct STTimer {
+   /* The time (in milliseconds) at which the binding expires. */
+   unsigned long long expiry;
+
+   /* The address of the STNode of the binding. */
+   struct STNode *node;
+
+   /* The address of the next STTimer in the slot, and the address of
+      the pointer to this STTimer. */
+   struct STTimer *next;
+   struct STTimer **previousNext;
+
+   /* The level of the timer wheel the STTimer is linked into. */
+   int level;
+};
+
+/* An STWheel is a hierarchical timer wheel. A slot at level L spans
+   2^(WHEEL_SLOT_BITS * L) milliseconds; when the time reaches the
+   start of a slot of a level above 0, its STTimers are cascaded into
+   the levels below, and the STTimers of a slot at level 0 expire
+   when the time reaches it. */
+struct STWheel {
+   /* The time (in milliseconds) the wheel has advanced to. The level
+      0 slot for this time may still hold expired STTimers. */
+   unsigned long long time;
+
+   /* The number of STTimers linked into each level, and in all. */
+   size_t levelCounts[WHEEL_LEVELS];
+   size_t numTimers;
+
+   /* The addresses of the first STTimers of each slot. */
+   struct STTimer *slots[WHEEL_LEVELS][WHEEL_SLOTS];
+};
+
+/* An STSetJob is the part of a set operation on a range of buckets
+   run by one thread, together with its results. */
+struct STSetJob {
+   /* The tables, the operation, and the range of buckets. */
+   struct SymTable *dst;
+   struct SymTable *src;
+   enum SetOperation operation;
+   size_t firstBucket;
+   size_t lastBucket;
+
+   /* The STNodes unlinked rather than moved, linked through their
+      next fields, the number of STNodes moved from src to dst, and
+      the bytes held by the STNodes moved or removed. */
+   struct STNode *unlinked;
+   size_t numMoved;
+   size_t numBytes;
+};
+
 /* A SymTable structure is a 'manager' structure that contains
    an array of linked lists, the total number of bindings, the
    number of buckets presently in the array, as well as a
@@ -50,411 +206,1661 @@ struct SymTable {
    int numBindings;
 
    /* The number of buckets (array elements) in the array of
-      linked lists presently. */
+      linked lists presently, a power of 2. */
    size_t numBuckets;
 
-   /* The bucket count index, used to keep track of where in
-      the array of bucket counts the symbol table presently is. */
-   int bucketCountIndex;
+   /* The random key of the hash function. */
+   uint64_t seed[2];
+
+   /* The roots of the trees indexing the long linked lists, by
+      bucket (NULL for a list with no tree), or NULL if no list has
+      been indexed since the last rehash, and the number of trees. */
+   struct STTreeNode **trees;
+   size_t numTrees;
+
+   /* The counters of the Bloom filter, aligned to a cache line, or
+      NULL if the filter is disabled, and the memory holding them. */
+   unsigned char *bloomCounters;
+   void *bloomMemory;
+
+   /* The number of blocks in the Bloom filter (a power of 2), and
+      the number of bindings it was sized for. */
+   size_t numBloomBlocks;
+   size_t bloomCapacity;
+
+   /* The number of bytes held by the STNodes and keys. */
+   size_t numBytes;
+
+   /* 1 if each STNode is the first member of an STLinkedNode, or 0
+      if it is allocated alone. */
+   int hasLinkedNodes;
+
+   /* 1 if the symbol table is bounded, and its bounds on the number
+      of bindings and the number of bytes held (0 if unbounded). */
+   int isBounded;
+   size_t maxBindings;
+   size_t maxBytes;
+
+   /* The function applied to each evicted binding, and the extra
+      parameter passed to it. */
+   void (*evictFunction)(const char *key, void *value, void *extra);
+   const void *evictExtra;
+
+   /* In a bounded symbol table, the addresses of the most and the
+      least recently used STNodes. */
+   struct STNode *newest;
+   struct STNode *oldest;
+
+   /* The timer wheel of the bindings with a time to live, or NULL
+      if none has been put. */
+   struct STWheel *wheel;
+
+   /* The function applied to each expired binding, and the extra
+      parameter passed to it. */
+   void (*expireFunction)(const char *key, void *value, void *extra);
+   const void *expireExtra;
+
+   /* The number of times the symbol table has been rehashed, and
+      the total time (in nanoseconds) spent rehashing it. */
+   size_t numRehashes;
+   unsigned long long rehashNanos;
+
+   /* The latency histograms of each operation, or NULL if the
+      symbol table is not instrumented. */
+   LatencyHistogram_T *latencies;
 };
 
-/* Return a hash code for pcKey that is between 0 and uBucketCount-1,
-   inclusive. */
-static size_t SymTable_hash(const char *pcKey, size_t uBucketCount) {
-   const size_t HASH_MULTIPLIER = 65599;
-   size_t u;
-   size_t uHash = 0;
+/* The random key from which the key of each symbol table's hash
+   function is derived, read once per process, and the control of
+   that reading. */
+static uint64_t processSeed[2];
+static pthread_once_t processSeedOnce = PTHREAD_ONCE_INIT;
+
+/* Reads processSeed from /dev/urandom or, failing that, derives it
+   from the time and the process ID. */
+static void SymTable_readProcessSeed(void) {
+   int fd;
+
+   fd = open("/dev/urandom", O_RDONLY);
+   if (fd < 0 || read(fd, processSeed, sizeof(processSeed)) !=
+       (ssize_t)sizeof(processSeed)) {
+      processSeed[0] = SymTable_mix((uint64_t)time(NULL));
+      processSeed[1] = SymTable_mix((uint64_t)getpid() ^ processSeed[0]);
+   }
+   if (fd >= 0) {
+      close(fd);
+   }
+}
+
+/* Performs one SipRound on the state v. */
+static void SymTable_sipRound(uint64_t v[4]) {
+   v[0] += v[1];
+   v[1] = (v[1] << 13) | (v[1] >> 51);
+   v[1] ^= v[0];
+   v[0] = (v[0] << 32) | (v[0] >> 32);
+   v[2] += v[3];
+   v[3] = (v[3] << 16) | (v[3] >> 48);
+   v[3] ^= v[2];
+   v[0] += v[3];
+   v[3] = (v[3] << 21) | (v[3] >> 43);
+   v[3] ^= v[0];
+   v[2] += v[1];
+   v[1] = (v[1] << 17) | (v[1] >> 47);
+   v[1] ^= v[2];
+   v[2] = (v[2] << 32) | (v[2] >> 32);
+}
+
+/* Return a hash code for pcKey in symTable: SipHash-1-3 of its bytes
+   under the key of symTable. Its low bits give the bucket index of
+   pcKey. */
+static size_t SymTable_hash(SymTable_T symTable, const char *pcKey) {
+   uint64_t v[4];
+   uint64_t word;
+   size_t u, uLength;
 
    assert(pcKey != NULL);
 
-   for (u = 0; pcKey[u] != '\0'; u++)
-      uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+   v[0] = symTable->seed[0] ^ 0x736F6D6570736575ULL;
+   v[1] = symTable->seed[1] ^ 0x646F72616E646F6DULL;
+   v[2] = symTable->seed[0] ^ 0x6C7967656E657261ULL;
+   v[3] = symTable->seed[1] ^ 0x7465646279746573ULL;
+
+   /* Compressing each whole 8 bytes of pcKey, then the rest of it
+      together with its length. */
+   uLength = strlen(pcKey);
+   for (u = 0; u + 8 <= uLength; u += 8) {
+      memcpy(&word, pcKey + u, sizeof(word));
+      v[3] ^= word;
+      SymTable_sipRound(v);
+      v[0] ^= word;
+   }
+   word = (uint64_t)uLength << 56;
+   for (; u < uLength; u++) {
+      word |= (uint64_t)(unsigned char)pcKey[u] << (8 * (u % 8));
+   }
+   v[3] ^= word;
+   SymTable_sipRound(v);
+   v[0] ^= word;
+
+   /* Finalizing. */
+   v[2] ^= 0xFF;
+   SymTable_sipRound(v);
+   SymTable_sipRound(v);
+   SymTable_sipRound(v);
+   return (size_t)(v[0] ^ v[1] ^ v[2] ^ v[3]) & SYMTABLE_HASH_MASK;
+}
 
-   return uHash % uBucketCount;
+/* Returns the hash code in symTable of the key of node, an STNode of
+   from, reusing the hash code of node if the two tables hash keys
+   alike. */
+static size_t SymTable_hashFor(SymTable_T symTable, SymTable_T from,
+                               const struct STNode *node) {
+   if (symTable->seed[0] == from->seed[0] &&
+       symTable->seed[1] == from->seed[1]) {
+      return node->hashCode;
+   }
+   return SymTable_hash(symTable, node->key);
 }
 
-/* Dynamically increases the number of buckets and repositions
-   all bindings for symTable. */
-static void SymTable_rehash(SymTable_T symTable) {
-   struct STNode **oldBucketsArray, **newBucketsArray;
-   struct STNode *currentNode, *newNode, *temporaryNode;
-   int i, oldNumBuckets, newNumBuckets, newBucketCountIndex;
-   size_t hashCode;
+/* Returns a second, well mixed hash code derived from hashCode, from
+   which the Bloom filter picks a block and the counters within it. */
+static uint64_t SymTable_bloomHash(size_t hashCode) {
+   uint64_t h = (uint64_t)hashCode;
+
+   h ^= h >> 33;
+   h *= (uint64_t)0xFF51AFD7ED558CCDULL;
+   h ^= h >> 33;
+   h *= (uint64_t)0xC4CEB9FE1A85EC53ULL;
+   h ^= h >> 33;
+   return h;
+}
 
-   assert(symTable != NULL);
-   oldNumBuckets = (int)symTable->numBuckets;
-   oldBucketsArray = symTable->bucketsArray;
-   newBucketCountIndex = symTable->bucketCountIndex + 1;
-   newNumBuckets = (int)bucketCounts[newBucketCountIndex];
-
-   /* Dynamically allocating memory for the new, longer array of
-      linked lists. */
-   newBucketsArray = (struct STNode **)calloc((size_t)newNumBuckets,
-                                              sizeof(struct STNode *));
-   /* Terminate the function if there isn't enough space for
-      the longer array of linked lists. */
-   if (newBucketsArray == NULL) {
-      return ;
+/* Adds delta (1 or -1) to each of the counters for hashCode in the
+   Bloom filter of symTable. Counters that reach BLOOM_MAX_COUNT
+   stay there, since their true count is no longer known. */
+static void SymTable_bloomUpdate(SymTable_T symTable, size_t hashCode,
+                                 int delta) {
+   uint64_t h = SymTable_bloomHash(hashCode);
+   unsigned char *block;
+   unsigned int counter, shift, count;
+   int i;
+
+   block = symTable->bloomCounters + BLOOM_BLOCK_BYTES *
+           (size_t)(h & (symTable->numBloomBlocks - 1));
+   for (i = 0; i < BLOOM_NUM_PROBES; i++) {
+      counter = (unsigned int)(h >> (32 + 7 * i)) &
+                (BLOOM_BLOCK_COUNTERS - 1);
+      shift = (counter & 1) * 4;
+      count = (block[counter / 2] >> shift) & 0xF;
+      if (count == BLOOM_MAX_COUNT || (delta < 0 && count == 0)) {
+         continue;
+      }
+      count = (unsigned int)((int)count + delta);
+      block[counter / 2] = (unsigned char)
+         ((block[counter / 2] & ~(0xF << shift)) | (count << shift));
    }
+}
 
-   /* Running a loop over all the nodes present in the symbol
-      table. */
-   for (i = 0; i < oldNumBuckets; i++) {
-      currentNode = oldBucketsArray[i];
-      while (currentNode != NULL) {
-         /* Dynamically allocating memory for the new node. */
-         newNode = (struct STNode*)malloc(sizeof(struct STNode));
-         if (newNode == NULL) {
-            return ;
-         }
-         /* Dynamically allocating memory for the defensive
-            copy of the key of the new node. */
-         newNode->key = (char *)malloc(strlen(currentNode->key) + 1);
-         if (newNode->key == NULL) {
-            return ;
-         }
-
-         /* Calculating the hashcode for the current key basis
-            the new number of buckets. */
-         hashCode = SymTable_hash(currentNode->key,
-                                  ((size_t)newNumBuckets));
+/* Returns 0 if the Bloom filter of symTable shows that no key with
+   hash code hashCode is present, or 1 if one may be. All the
+   counters examined lie in one cache line. */
+static int SymTable_bloomMayContain(SymTable_T symTable,
+                                    size_t hashCode) {
+   uint64_t h = SymTable_bloomHash(hashCode);
+   const unsigned char *block;
+   unsigned int counter;
+   int i;
+
+   block = symTable->bloomCounters + BLOOM_BLOCK_BYTES *
+           (size_t)(h & (symTable->numBloomBlocks - 1));
+   for (i = 0; i < BLOOM_NUM_PROBES; i++) {
+      counter = (unsigned int)(h >> (32 + 7 * i)) &
+                (BLOOM_BLOCK_COUNTERS - 1);
+      if (((block[counter / 2] >> ((counter & 1) * 4)) & 0xF) == 0) {
+         return 0;
+      }
+   }
+   return 1;
+}
 
-         /* Creating a defensive copy of the key by copying it
-            into the key for the newNode. */
-         strcpy((char*)newNode->key, currentNode->key);
-         newNode->value = currentNode->value;
+/* Replaces the Bloom filter of symTable with one sized for at least
+   capacity bindings, and adds the keys of all its bindings to it.
+   Returns 1, or 0 (leaving the filter unchanged) if there is
+   insufficient memory available. */
+static int SymTable_bloomBuild(SymTable_T symTable, size_t capacity) {
+   struct STNode *currentNode;
+   void *oldMemory = symTable->bloomMemory;
+   size_t numBlocks = 1;
+   void *memory;
+   size_t i;
+
+   while (numBlocks * BLOOM_BLOCK_COUNTERS <
+          capacity * BLOOM_COUNTERS_PER_BINDING) {
+      numBlocks *= 2;
+   }
 
-         /* Adding the new node to the beginning of the linked
-            list for the determined bucket in the array of linked
-            lists. */
-         newNode->next = newBucketsArray[hashCode];
-         newBucketsArray[hashCode] = newNode;
-         temporaryNode = currentNode->next;
-         currentNode = temporaryNode;
+   /* Allocating one extra block so that the counters can start on
+      a cache line boundary. */
+   memory = calloc(numBlocks + 1, BLOOM_BLOCK_BYTES);
+   if (memory == NULL) {
+      return 0;
+   }
+   symTable->bloomMemory = memory;
+   symTable->bloomCounters = (unsigned char *)memory +
+      (BLOOM_BLOCK_BYTES - (uintptr_t)memory % BLOOM_BLOCK_BYTES) %
+      BLOOM_BLOCK_BYTES;
+   symTable->numBloomBlocks = numBlocks;
+   symTable->bloomCapacity = capacity;
+
+   for (i = 0; i < symTable->numBuckets; i++) {
+      for (currentNode = symTable->bucketsArray[i]; currentNode != NULL;
+           currentNode = currentNode->next) {
+         SymTable_bloomUpdate(symTable, currentNode->hashCode, 1);
       }
    }
 
-   /* If there is sufficient space for all the new nodes and
-      they are all successfully repositioned, then freeing
-      the old array of linked lists. */
-   free(symTable->bucketsArray);
+   free(oldMemory);
+   return 1;
+}
 
-   /* Assigning the newly created bucket array to the symbol
-      table, and correspondingly updating its number of buckets
-      and bucket count index. */
-   symTable->bucketsArray = newBucketsArray;
-   symTable->numBuckets = (size_t)newNumBuckets;
-   symTable->bucketCountIndex = newBucketCountIndex;
+/* Returns the size of the block allocated for each STNode of
+   symTable. */
+static size_t SymTable_nodeSize(SymTable_T symTable) {
+   return symTable->hasLinkedNodes ? sizeof(struct STLinkedNode) :
+                                     sizeof(struct STNode);
 }
 
-/* Returns a new SymTable object that contains no bindings,
-   or NULL if there is insufficient memory available. */
-SymTable_T SymTable_new(void) {
-   SymTable_T symTable;
+/* Returns the number of bytes held by an STNode of symTable whose key
+   is key, including the defensive copy of key. */
+static size_t SymTable_nodeBytes(SymTable_T symTable, const char *key) {
+   return SymTable_nodeSize(symTable) + strlen(key) + 1;
+}
 
-   /* Allocating memory for the SymTable structure, returning
-      NULL if there isn't enough memory available. */
-   symTable = (SymTable_T)malloc(sizeof(struct SymTable));
-   if (symTable == NULL) {
-      return NULL;
-   }
+/* Returns the STLinkedNode whose first member is node, an STNode of
+   a symbol table with linked nodes. */
+static struct STLinkedNode *SymTable_links(const struct STNode *node) {
+   return (struct STLinkedNode *)node;
+}
 
-   /* Allocating memory for the array of linked lists, freeing
-      the symTable structure and returning ULL if there isn't
-      enough memory available. */
-   symTable->bucketsArray = (struct STNode **)calloc(bucketCounts[0],
-                                                     sizeof(struct STNode *));
+/* Returns the STTimer of node, an STNode of symTable, or NULL if it
+   has none. */
+static struct STTimer *SymTable_timerOf(SymTable_T symTable,
+                                        const struct STNode *node) {
+   return symTable->hasLinkedNodes ? SymTable_links(node)->timer : NULL;
+}
 
-   if (symTable->bucketsArray == NULL) {
-      free(symTable);
-      return NULL;
+/* Links node into the recency list of bounded symTable as its most
+   recently used STNode. */
+static void SymTable_linkNewest(SymTable_T symTable,
+                                struct STNode *node) {
+   struct STLinkedNode *links = SymTable_links(node);
+
+   links->newer = NULL;
+   links->older = symTable->newest;
+   if (symTable->newest != NULL) {
+      SymTable_links(symTable->newest)->newer = node;
    }
+   else {
+      symTable->oldest = node;
+   }
+   symTable->newest = node;
+}
 
-   symTable->numBindings = 0;
-   symTable->bucketCountIndex = 0;
-   symTable->numBuckets = bucketCounts[0];
+/* Unlinks node from the recency list of bounded symTable. */
+static void SymTable_unlinkRecency(SymTable_T symTable,
+                                   struct STNode *node) {
+   struct STLinkedNode *links = SymTable_links(node);
 
-   return symTable;
+   if (links->newer != NULL) {
+      SymTable_links(links->newer)->older = links->older;
+   }
+   else {
+      symTable->newest = links->older;
+   }
+   if (links->older != NULL) {
+      SymTable_links(links->older)->newer = links->newer;
+   }
+   else {
+      symTable->oldest = links->newer;
+   }
 }
 
-/* Frees all memory occupied by symTable. */
-void SymTable_free(SymTable_T symTable) {
-   struct STNode *currentNode;
-   struct STNode *temporaryNode;
-   int hashCode;
+/* Returns the present time in nanoseconds, from a clock that is
+   never set backwards. */
+static unsigned long long SymTable_nowNanos(void) {
+   struct timespec now;
 
-   /* Ensuring that the input parameters are not null. */
-   assert(symTable != NULL);
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return (unsigned long long)now.tv_sec * 1000000000 +
+          (unsigned long long)now.tv_nsec;
+}
 
-   /* Iterating over all nodes in symTable and
-      freeing memory occupied by defensive copies of
-      keys and by STNodes in symTable. */
-   for (hashCode = 0; hashCode < (int)symTable->numBuckets; hashCode++) {
-      currentNode = symTable->bucketsArray[hashCode];
-      while (currentNode != NULL) {
-         if (currentNode->key != NULL) {
-            free((char *)currentNode->key);
-         }
+/* Returns the present time in milliseconds, from a clock that is
+   never set backwards. */
+static unsigned long long SymTable_now(void) {
+   return SymTable_nowNanos() / 1000000;
+}
 
-         temporaryNode = currentNode;
-         currentNode = currentNode->next;
-         free(temporaryNode);
+/* Links timer into the slot of wheel in which it expires or, if it
+   expires beyond the span of level 0, is next cascaded. A timer that
+   expires beyond the span of the whole wheel is placed in the last
+   slot the wheel spans, and placed again when that slot cascades. */
+static void SymTable_wheelInsert(struct STWheel *wheel,
+                                 struct STTimer *timer) {
+   unsigned long long expiry = timer->expiry;
+   unsigned long long span;
+   struct STTimer **slot;
+   int level;
+
+   if (expiry < wheel->time) {
+      expiry = wheel->time;
+   }
+
+   /* Finding the lowest level whose span covers the expiry. */
+   for (level = 0; level < WHEEL_LEVELS; level++) {
+      span = 1ULL << (WHEEL_SLOT_BITS * (level + 1));
+      if (expiry - wheel->time < span) {
+         break;
       }
    }
+   if (level == WHEEL_LEVELS) {
+      level = WHEEL_LEVELS - 1;
+      expiry = wheel->time + span - 1;
+   }
 
-   /* Frees bucketsArray of symTable. */
-   free(symTable->bucketsArray);
+   slot = &wheel->slots[level]
+      [(expiry >> (WHEEL_SLOT_BITS * level)) & (WHEEL_SLOTS - 1)];
+   timer->level = level;
+   timer->next = *slot;
+   timer->previousNext = slot;
+   if (*slot != NULL) {
+      (*slot)->previousNext = &timer->next;
+   }
+   *slot = timer;
+   wheel->levelCounts[level]++;
+   wheel->numTimers++;
+}
 
-   /* Frees symTable structure. */
-   free(symTable);
+/* Unlinks timer from the slot of wheel it is linked into. */
+static void SymTable_wheelUnlink(struct STWheel *wheel,
+                                 struct STTimer *timer) {
+   *timer->previousNext = timer->next;
+   if (timer->next != NULL) {
+      timer->next->previousNext = timer->previousNext;
+   }
+   wheel->levelCounts[timer->level]--;
+   wheel->numTimers--;
 }
 
-/* Returns number of bindings (key-value pairs) in symTable. */
-size_t SymTable_getLength(SymTable_T symTable) {
-   /* Ensuring that the input parameters are not null. */
-   assert(symTable != NULL);
-   return (size_t)symTable->numBindings;
+/* Returns 1 if node, an STNode of symTable, has a time to live that
+   has run out, or 0 otherwise. The clock is read only for a node with
+   a time to live. */
+static int SymTable_isExpired(SymTable_T symTable,
+                              const struct STNode *node) {
+   struct STTimer *timer = SymTable_timerOf(symTable, node);
+
+   return timer != NULL && timer->expiry <= SymTable_now();
 }
 
-/* If key is already in symTable, leaves symTable unchanged
-   and returns 0. If insufficient memory is available,
-   returns 0. If symTable does not contain a binding
-   with key, then adds a new binding to symTable consisting
-   of key and value, and returns 1. */
-int SymTable_put(SymTable_T symTable, const char* key,
-                 const void *value) {
-   struct STNode *currentNode;
-   struct STNode *newNode;
-   size_t hashCode;
+/* Compares the key key with hash code hashCode to the key of node,
+   ordering first by hash code, and returns a negative number, 0 or a
+   positive number as it comes before, with or after it. */
+static int SymTable_treeCompare(size_t hashCode, const char *key,
+                                const struct STNode *node) {
+   if (hashCode != node->hashCode) {
+      return hashCode < node->hashCode ? -1 : 1;
+   }
+   return strcmp(key, node->key);
+}
 
-   /* Ensuring that the input parameters are not null. */
-   assert(symTable != NULL);
-   assert(key != NULL);
+/* Returns the height of the tree rooted at root. */
+static int SymTable_treeHeight(const struct STTreeNode *root) {
+   return root != NULL ? root->height : 0;
+}
 
-   /* Calculating the hashcode for the input key basis
-      the number of buckets. */
-   hashCode = SymTable_hash(key, symTable->numBuckets);
+/* Sets the height of root from those of its subtrees. */
+static void SymTable_treeUpdate(struct STTreeNode *root) {
+   int leftHeight = SymTable_treeHeight(root->left);
+   int rightHeight = SymTable_treeHeight(root->right);
 
-   /* Setting the currentNode equal to the first STNode
-      at index hashCode of bucketsArray. */
-   currentNode = symTable->bucketsArray[hashCode];
+   root->height = 1 + (leftHeight > rightHeight ? leftHeight : rightHeight);
+}
 
-   /* Iterating over current linked list of STNodes
-      to check if binding with key already exists. */
-   while (currentNode != NULL) {
-      if (strcmp(currentNode->key, key) == 0) {
-         return 0;
+/* Rotates the left subtree of root up into its place, and returns
+   the new root. */
+static struct STTreeNode *SymTable_rotateRight(struct STTreeNode *root) {
+   struct STTreeNode *pivot = root->left;
+
+   root->left = pivot->right;
+   pivot->right = root;
+   SymTable_treeUpdate(root);
+   SymTable_treeUpdate(pivot);
+   return pivot;
+}
+
+/* Rotates the right subtree of root up into its place, and returns
+   the new root. */
+static struct STTreeNode *SymTable_rotateLeft(struct STTreeNode *root) {
+   struct STTreeNode *pivot = root->right;
+
+   root->right = pivot->left;
+   pivot->left = root;
+   SymTable_treeUpdate(root);
+   SymTable_treeUpdate(pivot);
+   return pivot;
+}
+
+/* Returns the tree rooted at root rebalanced, after one of its
+   subtrees (each balanced) has grown or shrunk by a level. */
+static struct STTreeNode *SymTable_treeBalance(struct STTreeNode *root) {
+   int balance;
+
+   SymTable_treeUpdate(root);
+   balance = SymTable_treeHeight(root->left) -
+             SymTable_treeHeight(root->right);
+   if (balance > 1) {
+      if (SymTable_treeHeight(root->left->right) >
+          SymTable_treeHeight(root->left->left)) {
+         root->left = SymTable_rotateLeft(root->left);
       }
-      currentNode = currentNode->next;
+      return SymTable_rotateRight(root);
    }
-
-   /* Dynamically allocating memory for the new node. */
-   newNode = (struct STNode*)malloc(sizeof(struct STNode));
-   if (newNode == NULL) {
-      return 0;
+   if (balance < -1) {
+      if (SymTable_treeHeight(root->right->left) >
+          SymTable_treeHeight(root->right->right)) {
+         root->right = SymTable_rotateRight(root->right);
+      }
+      return SymTable_rotateLeft(root);
    }
+   return root;
+}
 
-   /* Dynamically allocating memory for the defensive
-      copy of the key of the new node. */
-   newNode->key = (char *)malloc(strlen(key) + 1);
-   if (newNode->key == NULL) {
-      return 0;
+/* Adds treeNode, whose STNode's key is not in the tree rooted at
+   root, to that tree, and returns its new root. */
+static struct STTreeNode *SymTable_treeInsert(struct STTreeNode *root,
+                                              struct STTreeNode *treeNode) {
+   if (root == NULL) {
+      treeNode->left = NULL;
+      treeNode->right = NULL;
+      treeNode->height = 1;
+      return treeNode;
    }
+   if (SymTable_treeCompare(treeNode->node->hashCode, treeNode->node->key,
+                            root->node) < 0) {
+      root->left = SymTable_treeInsert(root->left, treeNode);
+   }
+   else {
+      root->right = SymTable_treeInsert(root->right, treeNode);
+   }
+   return SymTable_treeBalance(root);
+}
 
-   /* Incrementing the number of bindings if the
-      key is not in symTable and if there is
-      sufficient memory. */
-   symTable->numBindings++;
-
-   /* Rehashing the symTable if the number of bindings
-      exceeds the current number of buckets, up until
-      the max number of buckets (=65521), and
-      correspondingly updating the hashCode basis the
-      new number of buckets. */
-   if ((symTable->numBindings > (int)symTable->numBuckets) &&
-       ((int)symTable->numBuckets < (int) MAX_BUCKETS)) {
-      SymTable_rehash(symTable);
-      hashCode = SymTable_hash(key, symTable->numBuckets);
+/* Unlinks the first STTreeNode of the tree rooted at root, storing
+   its address in *first, and returns the new root. */
+static struct STTreeNode *SymTable_treeRemoveFirst(struct STTreeNode *root,
+                                                   struct STTreeNode
+                                                   **first) {
+   if (root->left == NULL) {
+      *first = root;
+      return root->right;
    }
+   root->left = SymTable_treeRemoveFirst(root->left, first);
+   return SymTable_treeBalance(root);
+}
 
-   /* Copying the input key into the key of the newNode
-      (defensive copy). */
-   strcpy((char*)newNode->key, key);
-   newNode->value = value;
+/* Removes and frees the STTreeNode of node from the tree rooted at
+   root, which holds it, and returns the new root. */
+static struct STTreeNode *SymTable_treeRemove(struct STTreeNode *root,
+                                              const struct STNode *node) {
+   struct STTreeNode *removed, *right;
+   int comparison;
 
-   /* Adding the newNode to the beginning of the
-      linked list for that particular bucket. */
-   newNode->next = symTable->bucketsArray[hashCode];
-   symTable->bucketsArray[hashCode] = newNode;
+   assert(root != NULL);
 
-   return 1;
+   comparison = SymTable_treeCompare(node->hashCode, node->key,
+                                     root->node);
+   if (comparison < 0) {
+      root->left = SymTable_treeRemove(root->left, node);
+   }
+   else if (comparison > 0) {
+      root->right = SymTable_treeRemove(root->right, node);
+   }
+   else {
+      /* Replacing the STTreeNode by the first of its right subtree,
+         or by its left subtree if it has no right one. */
+      removed = root;
+      if (removed->right == NULL) {
+         root = removed->left;
+      }
+      else {
+         right = SymTable_treeRemoveFirst(removed->right, &root);
+         root->left = removed->left;
+         root->right = right;
+      }
+      free(removed);
+      if (root == NULL) {
+         return NULL;
+      }
+   }
+   return SymTable_treeBalance(root);
 }
 
-/* If symTable contains a binding whose key is input parameter key, return
-   its corresponding value and replace the value with input parameter value.
-   Else if there is no binding whose key is input parameter key, leave
-   symTable unchanged and return NULL. */
-void *SymTable_replace(SymTable_T symTable, const char *key, const void *value) {
-   struct STNode *currentNode;
-   void *oldValue;
-   size_t hashCode;
-
-   /* Ensuring that the input parameters are not null. */
-   assert(symTable != NULL);
-   assert(key != NULL);
+/* Links the STNodes of the tree rooted at root, in order, into a
+   linked list followed by tail, and returns its first STNode. */
+static struct STNode *SymTable_treeChain(const struct STTreeNode *root,
+                                         struct STNode *tail) {
+   if (root == NULL) {
+      return tail;
+   }
+   root->node->next = SymTable_treeChain(root->right, tail);
+   return SymTable_treeChain(root->left, root->node);
+}
 
-   /* Calculating the hashcode for the input key basis
-      the number of buckets. */
-   hashCode = SymTable_hash(key, symTable->numBuckets);
+/* Frees the STTreeNodes of the tree rooted at root, but not their
+   STNodes. */
+static void SymTable_treeFree(struct STTreeNode *root) {
+   if (root != NULL) {
+      SymTable_treeFree(root->left);
+      SymTable_treeFree(root->right);
+      free(root);
+   }
+}
 
-   /* Setting the currentNode equal to the first STNode
-      at index hashCode of bucketsArray. */
-   currentNode = symTable->bucketsArray[hashCode];
+/* Returns the number of STTreeNodes in the tree rooted at root. */
+static size_t SymTable_treeSize(const struct STTreeNode *root) {
+   if (root == NULL) {
+      return 0;
+   }
+   return 1 + SymTable_treeSize(root->left) + SymTable_treeSize(root->right);
+}
 
-   /* Iterating over linked list of STNodes to check if
-      binding with input key exists. If so, return
-      corresponding value, and replace it with
-      input value. */
-   while (currentNode != NULL) {
-      if (strcmp(currentNode->key, key) == 0) {
-         oldValue = (void *)currentNode->value;
-         currentNode->value = value;
-         return oldValue;
-      }
-      currentNode = currentNode->next;
+/* Returns 1 if the linked list beginning with node has at least
+   length STNodes, or 0 otherwise, walking at most length of them. */
+static int SymTable_chainReaches(const struct STNode *node, size_t length) {
+   for (; node != NULL && length > 0; node = node->next) {
+      length--;
    }
+   return length == 0;
+}
 
-   /* Else, return NULL. */
-   return NULL;
+/* Discards the tree indexing the linked list of bucket of symTable;
+   the list alone then holds its bindings. */
+static void SymTable_untreeify(SymTable_T symTable, size_t bucket) {
+   SymTable_treeFree(symTable->trees[bucket]);
+   symTable->trees[bucket] = NULL;
+   symTable->numTrees--;
 }
 
-/* If symTable contains a binding whose key is input parameter key,
-   return 1. Else if there is no binding whose key is input
-   parameter key, return 0. symTable is unchanged. */
-int SymTable_contains(SymTable_T symTable, const char *key) {
+/* Indexes the linked list of bucket of symTable, which has none, by
+   a tree, and puts the list in the order of the tree. If there is
+   insufficient memory available, the list is left without one, which
+   is slower but still correct. */
+static void SymTable_treeify(SymTable_T symTable, size_t bucket) {
+   struct STTreeNode *root = NULL;
+   struct STTreeNode *treeNode;
    struct STNode *currentNode;
-   size_t hashCode;
 
-   /* Ensuring that the input parameters are not null. */
-   assert(symTable != NULL);
-   assert(key != NULL);
+   if (symTable->trees == NULL) {
+      symTable->trees = (struct STTreeNode **)
+         calloc(symTable->numBuckets, sizeof(struct STTreeNode *));
+      if (symTable->trees == NULL) {
+         return;
+      }
+   }
 
-   /* Calculating the hashcode for the input key basis
-      the number of buckets. */
-   hashCode = SymTable_hash(key, symTable->numBuckets);
+   for (currentNode = symTable->bucketsArray[bucket]; currentNode != NULL;
+        currentNode = currentNode->next) {
+      treeNode = (struct STTreeNode *)malloc(sizeof(struct STTreeNode));
+      if (treeNode == NULL) {
+         SymTable_treeFree(root);
+         return;
+      }
+      treeNode->node = currentNode;
+      root = SymTable_treeInsert(root, treeNode);
+   }
+   symTable->bucketsArray[bucket] = SymTable_treeChain(root, NULL);
+   symTable->trees[bucket] = root;
+   symTable->numTrees++;
+}
 
-   /* Setting the currentNode equal to the first STNode
-      at index hashCode of bucketsArray. */
-   currentNode = symTable->bucketsArray[hashCode];
+/* Indexes by a tree each linked list of symTable that has reached
+   TREEIFY_THRESHOLD STNodes and has no tree, if symTable has at least
+   MIN_TREEIFY_BUCKETS buckets. */
+static void SymTable_treeifyLong(SymTable_T symTable) {
+   size_t i;
 
-   /* Iterating over linked list of STNodes to check if
-      binding with input key exists. If so, return 1. */
-   while (currentNode != NULL) {
-      if (strcmp(currentNode->key, key) == 0) {
-         return 1;
+   if (symTable->numBuckets < MIN_TREEIFY_BUCKETS) {
+      return;
+   }
+   for (i = 0; i < symTable->numBuckets; i++) {
+      if ((symTable->trees == NULL || symTable->trees[i] == NULL) &&
+          SymTable_chainReaches(symTable->bucketsArray[i],
+                                TREEIFY_THRESHOLD)) {
+         SymTable_treeify(symTable, i);
       }
-      currentNode = currentNode->next;
    }
-
-   /* Else, return 0. */
-   return 0;
 }
 
-/* If symTable contains a binding whose key is input parameter key,
-   return corresponding value. Else, return NULL. symTable is unchanged. */
-void *SymTable_get(SymTable_T symTable, const char *key) {
-   struct STNode *currentNode;
-   size_t hashCode;
+/* Frees every tree of symTable and the array of their roots. */
+static void SymTable_freeTrees(SymTable_T symTable) {
+   size_t i;
 
-   /* Ensuring that the input parameters are not null. */
-   assert(symTable != NULL);
-   assert(key != NULL);
+   if (symTable->trees == NULL) {
+      return;
+   }
+   for (i = 0; i < symTable->numBuckets; i++) {
+      SymTable_treeFree(symTable->trees[i]);
+   }
+   free(symTable->trees);
+   symTable->trees = NULL;
+   symTable->numTrees = 0;
+}
+
+/* Links node into a linked list at the place whose address is
+   stored at *nodeRef. */
+static void SymTable_pushNode(struct STNode **nodeRef,
+                              struct STNode *node) {
+   node->next = *nodeRef;
+   *nodeRef = node;
+}
 
-   /* Calculating the hashcode for the input key basis
-      the number of buckets. */
-   hashCode = SymTable_hash(key, symTable->numBuckets);
+/* Unlinks the STNode whose address is stored at *nodeRef from its
+   linked list. */
+static void SymTable_unlinkNode(struct STNode **nodeRef) {
+   *nodeRef = (*nodeRef)->next;
+}
 
-   /* Setting the currentNode equal to the first STNode
-      at index hashCode of bucketsArray. */
-   currentNode = symTable->bucketsArray[hashCode];
+/* Returns the index of the bucket of symTable for the hash code
+   hashCode. */
+static size_t SymTable_bucketOf(SymTable_T symTable, size_t hashCode) {
+   return hashCode & (symTable->numBuckets - 1);
+}
 
-   /* Iterating over linked list of STNodes to check if
-      binding with input key exists. If so, return
-      corresponding value. */
-   while (currentNode != NULL) {
-       if (strcmp(currentNode->key, key) == 0) {
-         return (void *)currentNode->value;
+/* Returns the address of the pointer, in the linked list of bucket of
+   symTable, to the first STNode that does not come before the key
+   key with hash code hashCode (or of the NULL pointer ending the
+   list). The list must be indexed by a tree. */
+static struct STNode **SymTable_treeSlot(SymTable_T symTable,
+                                         size_t bucket, const char *key,
+                                         size_t hashCode) {
+   const struct STTreeNode *root = symTable->trees[bucket];
+   struct STNode *previous = NULL;
+
+   /* Finding the last STNode that comes before key, whose next
+      pointer is the slot. */
+   while (root != NULL) {
+      if (SymTable_treeCompare(hashCode, key, root->node) > 0) {
+         previous = root->node;
+         root = root->right;
+      }
+      else {
+         root = root->left;
       }
-      currentNode = currentNode->next;
    }
+   return previous != NULL ? &previous->next :
+                             &symTable->bucketsArray[bucket];
+}
 
-   /* Else, return NULL. */
+/* Returns the address of the pointer to the STNode of symTable whose
+   key is key and whose hash code is keyHash, or NULL if there is
+   none, searching the tree of its bucket if it has one. */
+static struct STNode **SymTable_lookup(SymTable_T symTable,
+                                       const char *key, size_t keyHash) {
+   struct STNode **nodeRef;
+   size_t bucket = SymTable_bucketOf(symTable, keyHash);
+
+   if (symTable->trees != NULL && symTable->trees[bucket] != NULL) {
+      nodeRef = SymTable_treeSlot(symTable, bucket, key, keyHash);
+      if (*nodeRef != NULL &&
+          SymTable_treeCompare(keyHash, key, *nodeRef) == 0) {
+         return nodeRef;
+      }
+      return NULL;
+   }
+   for (nodeRef = &symTable->bucketsArray[bucket]; *nodeRef != NULL;
+        nodeRef = &(*nodeRef)->next) {
+      if ((*nodeRef)->hashCode == keyHash &&
+          strcmp((*nodeRef)->key, key) == 0) {
+         return nodeRef;
+      }
+   }
    return NULL;
 }
 
-/* If symTable contains a binding with input key, remove that
-   binding from symTable and return the binding's value. Else,
-   leave symTable unchanged and return NULL. */
-void *SymTable_remove(SymTable_T symTable, const char *key) {
-   struct STNode *currentNode;
-   struct STNode *previousNode;
-   struct STNode *temporaryNode;
-   void *value;
-   size_t hashCode;
+/* Unlinks the STNode whose address is stored at *nodeRef from its
+   linked list and from every other structure of symTable that
+   refers to it, and returns it. The caller frees the STNode. A tree
+   left small is discarded. */
+static struct STNode *SymTable_detach(SymTable_T symTable,
+                                      struct STNode **nodeRef) {
+   struct STNode *node = *nodeRef;
+   struct STTimer *timer = SymTable_timerOf(symTable, node);
+   size_t bucket;
+
+   SymTable_unlinkNode(nodeRef);
+   bucket = SymTable_bucketOf(symTable, node->hashCode);
+   if (symTable->trees != NULL && symTable->trees[bucket] != NULL) {
+      symTable->trees[bucket] = SymTable_treeRemove(symTable->trees[bucket],
+                                                    node);
+      if (SymTable_treeHeight(symTable->trees[bucket]) <=
+          UNTREEIFY_HEIGHT) {
+         SymTable_untreeify(symTable, bucket);
+      }
+   }
+   if (symTable->bloomCounters != NULL) {
+      SymTable_bloomUpdate(symTable, node->hashCode, -1);
+   }
+   if (symTable->isBounded) {
+      SymTable_unlinkRecency(symTable, node);
+   }
+   if (timer != NULL) {
+      SymTable_wheelUnlink(symTable->wheel, timer);
+      free(timer);
+      SymTable_links(node)->timer = NULL;
+   }
+   symTable->numBytes -= SymTable_nodeBytes(symTable, node->key);
+   symTable->numBindings--;
+   return node;
+}
 
-   /* Ensuring that the input parameters are not null. */
-   assert(symTable != NULL);
-   assert(key != NULL);
+/* Removes the least recently used binding of bounded symTable,
+   passing it to the eviction function (if any) before freeing it. */
+static void SymTable_evict(SymTable_T symTable) {
+   struct STNode *node = symTable->oldest;
 
-   /* Calculating the hashcode for the input key basis
-      the number of buckets. */
-   hashCode = SymTable_hash(key, symTable->numBuckets);
+   assert(node != NULL);
 
-   /* Setting the currentNode equal to the first STNode
-      at index hashCode of bucketsArray. */
-   currentNode = symTable->bucketsArray[hashCode];
+   (void)SymTable_detach(symTable, SymTable_lookup(symTable, node->key,
+                                                   node->hashCode));
 
-   /* If symTable is empty, return NULL. */
-   if (currentNode == NULL) {
-      return NULL;
+   if (symTable->evictFunction != NULL) {
+      (*symTable->evictFunction)(node->key, (void *)node->value,
+                                 (void *)symTable->evictExtra);
    }
+   free((char *)node->key);
+   free(node);
+}
+
+/* Removes the expired binding whose STNode's address is stored at
+   *nodeRef from symTable, passing it to the expiry function (if any)
+   before freeing it. */
+static void SymTable_reclaim(SymTable_T symTable,
+                             struct STNode **nodeRef) {
+   struct STNode *node = SymTable_detach(symTable, nodeRef);
 
-   /* If the first node contains the key. */
-   if (strcmp(currentNode->key, key) == 0) {
-      temporaryNode = currentNode;
-      value = (void *)temporaryNode->value;
-      symTable->bucketsArray[hashCode] = temporaryNode->next;
+   if (symTable->expireFunction != NULL) {
+      (*symTable->expireFunction)(node->key, (void *)node->value,
+                                  (void *)symTable->expireExtra);
    }
-   /* If symTable is not empty, and the firstNode does not contain
-      the key, traversing the list while key is not found and end
-      of the symTable is not reached. */
-  else {
-      while (currentNode != NULL &&
-             (strcmp(currentNode->key, key) != 0)) {
-         previousNode = currentNode;
-         currentNode = currentNode->next;
+   free((char *)node->key);
+   free(node);
+}
+
+/* Advances the timer wheel of symTable towards time now, reclaiming
+   the bindings that expire on the way, and stopping early once
+   budget bindings have been reclaimed. Returns the number of
+   bindings reclaimed. Each STTimer is cascaded at most once per
+   level, and runs of empty slots are skipped whole. */
+static size_t SymTable_advance(SymTable_T symTable,
+                               unsigned long long now, size_t budget) {
+   struct STWheel *wheel = symTable->wheel;
+   struct STTimer **slot;
+   struct STTimer *timer;
+   unsigned long long step;
+   size_t numReclaimed = 0;
+   int level, topLevel;
+
+   for (;;) {
+      /* Reclaiming the bindings whose STTimers are in the level 0
+         slot for the present time of the wheel. */
+      slot = &wheel->slots[0][wheel->time & (WHEEL_SLOTS - 1)];
+      while (*slot != NULL) {
+         if (numReclaimed == budget) {
+            return numReclaimed;
+         }
+         timer = *slot;
+         assert(timer->expiry <= wheel->time);
+         SymTable_reclaim(symTable,
+                          SymTable_lookup(symTable, timer->node->key,
+                                          timer->node->hashCode));
+         numReclaimed++;
       }
 
-      /* If key is not present in symbol table. */
-      if (currentNode == NULL) {
-         return NULL;
+      if (wheel->time >= now) {
+         return numReclaimed;
+      }
+      if (wheel->numTimers == 0) {
+         wheel->time = now;
+         return numReclaimed;
       }
 
-      /* Freeing the currentNode and its key. */
-      temporaryNode = currentNode;
+      /* Moving to the start of the next slot of the lowest level
+         that holds an STTimer, since nothing happens before it. */
+      for (level = 0; wheel->levelCounts[level] == 0; level++) {
+      }
+      step = 1ULL << (WHEEL_SLOT_BITS * level);
+      if ((wheel->time | (step - 1)) >= now) {
+         assert(level > 0);
+         wheel->time = now;
+         return numReclaimed;
+      }
+      wheel->time = (wheel->time | (step - 1)) + 1;
 
-      /* Assigning the value to be returned to the
-         value of the currentNode, and the next node for
-         currentNode to be the next node for its
-         previous node. */
-      value = (void *)temporaryNode->value;
-      free((char *)temporaryNode->key);
-      previousNode->next = temporaryNode->next;
-      free(temporaryNode);
+      /* Cascading the STTimers of the slots that start at the new
+         time, from the highest level down. */
+      for (topLevel = 0; topLevel < WHEEL_LEVELS - 1 &&
+           (wheel->time & ((1ULL << (WHEEL_SLOT_BITS * (topLevel + 1)))
+                           - 1)) == 0; topLevel++) {
+      }
+      for (level = topLevel; level > 0; level--) {
+         slot = &wheel->slots[level]
+            [(wheel->time >> (WHEEL_SLOT_BITS * level)) &
+             (WHEEL_SLOTS - 1)];
+         while (*slot != NULL) {
+            timer = *slot;
+            SymTable_wheelUnlink(wheel, timer);
+            SymTable_wheelInsert(wheel, timer);
+         }
+      }
    }
+}
 
-   /* Decrementing the number of bindings in symTable. */
-   symTable->numBindings--;
+/* Reclaims up to EXPIRE_BUDGET expired bindings of symTable, so that
+   the work of expiry is spread over the operations on it. */
+static void SymTable_expireSome(SymTable_T symTable) {
+   if (symTable->wheel != NULL && symTable->wheel->numTimers > 0) {
+      (void)SymTable_advance(symTable, SymTable_now(), EXPIRE_BUDGET);
+   }
+}
+
+/* Returns the time at which an operation on symTable starts, or 0 if
+   symTable is not instrumented. */
+static unsigned long long SymTable_startTiming(SymTable_T symTable) {
+   if (symTable->latencies == NULL) {
+      return 0;
+   }
+   return LatencyHistogram_now();
+}
+
+/* Records the latency of operation on an instrumented symTable,
+   which started at time startNanos. */
+static void SymTable_stopTiming(SymTable_T symTable,
+                                enum SymTable_Operation operation,
+                                unsigned long long startNanos) {
+   if (symTable->latencies != NULL) {
+      LatencyHistogram_record(symTable->latencies[operation],
+                              LatencyHistogram_now() - startNanos);
+   }
+}
+
+/* Dynamically doubles the number of buckets and repositions
+   all bindings for symTable, rebuilding the trees of the linked
+   lists that are still long. Returns 1, or 0 (leaving symTable
+   unchanged) if there is insufficient memory available. The array
+   of linked lists is grown in place where the system allows (see
+   symtablearray.h), and since the number of buckets is a power of
+   2, the STNodes of bucket i go either to bucket i or to bucket i
+   plus the old number of buckets, so each list is split in place
+   rather than relinked into a new array. */
+static int SymTable_rehash(SymTable_T symTable) {
+   struct STNode **newBucketsArray;
+   struct STNode **lowLink, **highLink;
+   struct STNode *currentNode, *nextNode;
+   size_t i, oldNumBuckets, newNumBuckets;
+   unsigned long long startNanos;
+
+   assert(symTable != NULL);
+   assert(symTable->numBuckets < MAX_BUCKETS);
+   startNanos = SymTable_nowNanos();
+   oldNumBuckets = symTable->numBuckets;
+   newNumBuckets = oldNumBuckets * 2;
+
+   /* Growing the array of linked lists, terminating the function
+      if there isn't enough space for the longer array. */
+   newBucketsArray = (struct STNode **)SymTable_resizeArray
+      (symTable->bucketsArray, oldNumBuckets * sizeof(struct STNode *),
+       newNumBuckets * sizeof(struct STNode *));
+   if (newBucketsArray == NULL) {
+      return 0;
+   }
+   SymTable_freeTrees(symTable);
+   symTable->bucketsArray = newBucketsArray;
+   symTable->numBuckets = newNumBuckets;
+
+   /* Splitting each list, keeping the order of its STNodes, into
+      the list of its own bucket and that of the bucket in the new
+      half of the array, using the stored hash code of each. */
+   for (i = 0; i < oldNumBuckets; i++) {
+      currentNode = newBucketsArray[i];
+      lowLink = &newBucketsArray[i];
+      highLink = &newBucketsArray[i + oldNumBuckets];
+      for (; currentNode != NULL; currentNode = nextNode) {
+         nextNode = currentNode->next;
+         if (currentNode->hashCode & oldNumBuckets) {
+            *highLink = currentNode;
+            highLink = &currentNode->next;
+         }
+         else {
+            *lowLink = currentNode;
+            lowLink = &currentNode->next;
+         }
+      }
+      *lowLink = NULL;
+      *highLink = NULL;
+   }
+   SymTable_treeifyLong(symTable);
+   symTable->numRehashes++;
+   symTable->rehashNanos += SymTable_nowNanos() - startNanos;
+   return 1;
+}
+
+/* Returns a new SymTable object that contains no bindings,
+   or NULL if there is insufficient memory available. */
+SymTable_T SymTable_new(void) {
+   SymTable_T symTable;
+
+   /* Allocating memory for the SymTable structure, returning
+      NULL if there isn't enough memory available. */
+   symTable = (SymTable_T)malloc(sizeof(struct SymTable));
+   if (symTable == NULL) {
+      return NULL;
+   }
+
+   /* Allocating memory for the array of linked lists, freeing
+      the symTable structure and returning ULL if there isn't
+      enough memory available. */
+   symTable->bucketsArray = (struct STNode **)calloc(MIN_BUCKETS,
+                                                     sizeof(struct STNode *));
+
+   if (symTable->bucketsArray == NULL) {
+      free(symTable);
+      return NULL;
+   }
+
+   symTable->numBindings = 0;
+   symTable->numBuckets = MIN_BUCKETS;
+   symTable->trees = NULL;
+   symTable->numTrees = 0;
+   symTable->bloomCounters = NULL;
+   symTable->bloomMemory = NULL;
+   symTable->numBloomBlocks = 0;
+   symTable->bloomCapacity = 0;
+   symTable->numBytes = 0;
+   symTable->hasLinkedNodes = 0;
+   symTable->isBounded = 0;
+   symTable->maxBindings = 0;
+   symTable->maxBytes = 0;
+   symTable->evictFunction = NULL;
+   symTable->evictExtra = NULL;
+   symTable->newest = NULL;
+   symTable->oldest = NULL;
+   symTable->wheel = NULL;
+   symTable->expireFunction = NULL;
+   symTable->expireExtra = NULL;
+   symTable->numRehashes = 0;
+   symTable->rehashNanos = 0;
+   symTable->latencies = NULL;
+
+   /* Choosing the key of the hash function from the random key of
+      the process, the address of symTable and the time, so that
+      each SymTable has its own. */
+   (void)pthread_once(&processSeedOnce, SymTable_readProcessSeed);
+   symTable->seed[0] = SymTable_mix(processSeed[0] ^
+                                    (uint64_t)(uintptr_t)symTable);
+   symTable->seed[1] = SymTable_mix(processSeed[1] ^
+                                    (uint64_t)SymTable_nowNanos());
+
+   return symTable;
+}
+
+/* Returns a new SymTable object that contains no bindings and that
+   holds at most maxBindings bindings and at most maxBytes bytes of
+   STNodes and keys (either bound may be 0, meaning no bound), or
+   NULL if there is insufficient memory available. When adding a
+   binding would exceed a bound, the least recently put, retrieved,
+   replaced or found bindings are removed first, each being passed
+   to evictFunction (if it is not NULL) together with extra so that
+   its value may be released. */
+SymTable_T SymTable_newBounded(size_t maxBindings, size_t maxBytes,
+                               void (*evictFunction)
+                               (const char *key, void *value,
+                                void *extra),
+                               const void *extra) {
+   SymTable_T symTable;
+
+   symTable = SymTable_new();
+   if (symTable == NULL) {
+      return NULL;
+   }
+
+   symTable->hasLinkedNodes = 1;
+   symTable->isBounded = 1;
+   symTable->maxBindings = maxBindings;
+   symTable->maxBytes = maxBytes;
+   symTable->evictFunction = evictFunction;
+   symTable->evictExtra = extra;
+   return symTable;
+}
+
+/* Returns a new SymTable object that contains no bindings and that
+   hashes keys as symTable does, or NULL if there is insufficient
+   memory available. SymTable_merge moves the bindings of either
+   table into the other without hashing their keys again, and splits
+   the work for two large tables of the same number of buckets among
+   several threads. */
+SymTable_T SymTable_newLike(SymTable_T symTable) {
+   SymTable_T newSymTable;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   newSymTable = SymTable_new();
+   if (newSymTable == NULL) {
+      return NULL;
+   }
+   newSymTable->seed[0] = symTable->seed[0];
+   newSymTable->seed[1] = symTable->seed[1];
+   return newSymTable;
+}
+
+/* If enabled is nonzero, makes symTable keep a counting Bloom filter
+   of its keys, which SymTable_put, SymTable_replace,
+   SymTable_contains and SymTable_get consult before walking a linked
+   list, so that most lookups of missing keys touch a single cache
+   line. If enabled is 0, discards the filter. Returns 1, or 0
+   (leaving symTable unchanged) if there is insufficient memory
+   available. */
+int SymTable_setBloomFilter(SymTable_T symTable, int enabled) {
+   size_t capacity;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   if (!enabled) {
+      free(symTable->bloomMemory);
+      symTable->bloomCounters = NULL;
+      symTable->bloomMemory = NULL;
+      symTable->numBloomBlocks = 0;
+      symTable->bloomCapacity = 0;
+      return 1;
+   }
+
+   if (symTable->bloomCounters != NULL) {
+      return 1;
+   }
+
+   /* Sizing the filter for the larger of the present number of
+      bindings and the number of buckets. */
+   capacity = symTable->numBuckets;
+   if ((size_t)symTable->numBindings > capacity) {
+      capacity = (size_t)symTable->numBindings;
+   }
+   return SymTable_bloomBuild(symTable, capacity);
+}
+
+/* Frees all memory occupied by symTable. */
+void SymTable_free(SymTable_T symTable) {
+   struct STNode *currentNode;
+   struct STNode *temporaryNode;
+   size_t hashCode;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   /* Iterating over all nodes in symTable and
+      freeing memory occupied by defensive copies of
+      keys and by STNodes in symTable. */
+   for (hashCode = 0; hashCode < symTable->numBuckets; hashCode++) {
+      currentNode = symTable->bucketsArray[hashCode];
+      while (currentNode != NULL) {
+         if (currentNode->key != NULL) {
+            free((char *)currentNode->key);
+         }
+         free(SymTable_timerOf(symTable, currentNode));
+
+         temporaryNode = currentNode;
+         currentNode = currentNode->next;
+         free(temporaryNode);
+      }
+   }
+
+   /* Frees bucketsArray, the trees, the Bloom filter and the timer
+      wheel of symTable. */
+   SymTable_freeTrees(symTable);
+   SymTable_freeArray(symTable->bucketsArray,
+                      symTable->numBuckets * sizeof(struct STNode *));
+   free(symTable->bloomMemory);
+   free(symTable->wheel);
+   (void)SymTable_setInstrumentation(symTable, 0);
+
+   /* Frees symTable structure. */
+   free(symTable);
+}
+
+/* Removes every binding from symTable, passing each (including
+   expired bindings not yet reclaimed) to freeFunction (if it is not
+   NULL) with extra, so that its value may be released. symTable
+   keeps its buckets, Bloom filter and timer wheel at their present
+   sizes, so that refilling it does not rehash it again. */
+void SymTable_clear(SymTable_T symTable,
+                    void (*freeFunction)
+                    (const char *key, void *value, void *extra),
+                    const void *extra) {
+   struct STNode *currentNode;
+   struct STNode *temporaryNode;
+   size_t i;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   /* Emptying each linked list, freeing its STNodes, their keys and
+      their timers. */
+   for (i = 0; i < symTable->numBuckets; i++) {
+      currentNode = symTable->bucketsArray[i];
+      symTable->bucketsArray[i] = NULL;
+      while (currentNode != NULL) {
+         if (freeFunction != NULL) {
+            (*freeFunction)(currentNode->key, (void *)currentNode->value,
+                            (void *)extra);
+         }
+         free((char *)currentNode->key);
+         free(SymTable_timerOf(symTable, currentNode));
+
+         temporaryNode = currentNode;
+         currentNode = currentNode->next;
+         free(temporaryNode);
+      }
+   }
+
+   /* Resetting the counts, the recency list, the trees, the Bloom
+      filter and the timer wheel, which no longer refer to any
+      STNode. */
+   SymTable_freeTrees(symTable);
+   symTable->numBindings = 0;
+   symTable->numBytes = 0;
+   symTable->newest = NULL;
+   symTable->oldest = NULL;
+   if (symTable->bloomCounters != NULL) {
+      memset(symTable->bloomCounters, 0,
+             symTable->numBloomBlocks * BLOOM_BLOCK_BYTES);
+   }
+   if (symTable->wheel != NULL) {
+      memset(symTable->wheel, 0, sizeof(struct STWheel));
+   }
+}
+
+/* Returns number of bindings (key-value pairs) in symTable. This
+   includes expired bindings that have not yet been reclaimed. */
+size_t SymTable_getLength(SymTable_T symTable) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   return (size_t)symTable->numBindings;
+}
+
+/* Puts an STLinkedNode in place of each STNode of symTable, which
+   has no linked nodes, so that bindings with a time to live may be
+   put into it. Returns 1, or 0 (leaving symTable unchanged) if there
+   is insufficient memory available. */
+static int SymTable_linkNodes(SymTable_T symTable) {
+   struct STNode **nodeRef;
+   struct STNode *node, *oldNode, *spare = NULL;
+   struct STLinkedNode *links;
+   size_t bucket;
+   int i;
+
+   assert(!symTable->hasLinkedNodes);
+
+   /* Allocating every STLinkedNode first, chained through their
+      STNodes, so that running out of memory changes nothing. */
+   for (i = 0; i < symTable->numBindings; i++) {
+      links = (struct STLinkedNode *)malloc(sizeof(struct STLinkedNode));
+      if (links == NULL) {
+         while (spare != NULL) {
+            node = spare;
+            spare = node->next;
+            free(node);
+         }
+         return 0;
+      }
+      links->node.next = spare;
+      spare = &links->node;
+   }
+
+   /* Moving each STNode into an STLinkedNode at its place in its
+      linked list. The trees refer to the old STNodes, so they are
+      rebuilt afterwards. */
+   SymTable_freeTrees(symTable);
+   for (bucket = 0; bucket < symTable->numBuckets; bucket++) {
+      for (nodeRef = &symTable->bucketsArray[bucket]; *nodeRef != NULL;
+           nodeRef = &node->next) {
+         oldNode = *nodeRef;
+         node = spare;
+         spare = node->next;
+         *node = *oldNode;
+         *nodeRef = node;
+         links = SymTable_links(node);
+         links->newer = NULL;
+         links->older = NULL;
+         links->timer = NULL;
+         free(oldNode);
+      }
+   }
+   assert(spare == NULL);
+
+   symTable->numBytes += (size_t)symTable->numBindings *
+      (sizeof(struct STLinkedNode) - sizeof(struct STNode));
+   symTable->hasLinkedNodes = 1;
+   SymTable_treeifyLong(symTable);
+   return 1;
+}
+
+/* Links node, whose key, value, hash code and STTimer (which may be
+   NULL) are set, into symTable, which does not contain its key,
+   first evicting the least recently used bindings of a bounded
+   symTable until it fits, and rehashing symTable if it has outgrown
+   its buckets. The STTimer, if any, is linked into the timer wheel of
+   symTable, which must exist. A linked list that grows long is
+   indexed by a tree. */
+static void SymTable_link(SymTable_T symTable, struct STNode *node) {
+   struct STTreeNode *treeNode;
+   struct STTimer *timer;
+   size_t hashCode, newBytes;
+
+   /* Evicting the least recently used bindings of a bounded
+      symTable until the new binding fits. */
+   newBytes = SymTable_nodeBytes(symTable, node->key);
+   if (symTable->isBounded) {
+      while (symTable->numBindings > 0 &&
+             ((symTable->maxBindings != 0 &&
+               (size_t)symTable->numBindings >= symTable->maxBindings) ||
+              (symTable->maxBytes != 0 &&
+               symTable->numBytes + newBytes > symTable->maxBytes))) {
+         SymTable_evict(symTable);
+      }
+   }
+
+   /* Incrementing the number of bindings. */
+   symTable->numBindings++;
+
+   /* Rehashing the symTable if the number of bindings
+      exceeds the current number of buckets, up until
+      the max number of buckets. */
+   if (((size_t)symTable->numBindings > symTable->numBuckets) &&
+       (symTable->numBuckets < MAX_BUCKETS)) {
+      (void)SymTable_rehash(symTable);
+   }
+
+   timer = SymTable_timerOf(symTable, node);
+   if (timer != NULL) {
+      SymTable_wheelInsert(symTable->wheel, timer);
+   }
+
+   symTable->numBytes += newBytes;
+
+   /* Adding the node to the linked list for its bucket, at its
+      place in the order of the list's tree and to the tree if it
+      has one. If there is not enough memory for the tree's new
+      STTreeNode, the tree is discarded and the list alone holds the
+      bindings. */
+   hashCode = SymTable_bucketOf(symTable, node->hashCode);
+   if (symTable->trees != NULL && symTable->trees[hashCode] != NULL) {
+      SymTable_pushNode(SymTable_treeSlot(symTable, hashCode, node->key,
+                                          node->hashCode), node);
+      treeNode = (struct STTreeNode *)malloc(sizeof(struct STTreeNode));
+      if (treeNode == NULL) {
+         SymTable_untreeify(symTable, hashCode);
+      }
+      else {
+         treeNode->node = node;
+         symTable->trees[hashCode] =
+            SymTable_treeInsert(symTable->trees[hashCode], treeNode);
+      }
+   }
+   else {
+      /* Adding the node to the beginning of the list. A list that
+         has become long doubles the buckets of a small symTable,
+         and is otherwise (or if there is not enough memory to
+         double them) indexed by a tree. */
+      SymTable_pushNode(&symTable->bucketsArray[hashCode], node);
+      if (SymTable_chainReaches(symTable->bucketsArray[hashCode],
+                                TREEIFY_THRESHOLD) &&
+          (symTable->numBuckets >= MIN_TREEIFY_BUCKETS ||
+           !SymTable_rehash(symTable))) {
+         SymTable_treeify(symTable, hashCode);
+      }
+   }
+
+   if (symTable->isBounded) {
+      SymTable_linkNewest(symTable, node);
+   }
+
+   /* Adding the key to the Bloom filter, first doubling the
+      filter if it has outgrown the size it was built for. If
+      there is not enough memory to double it, the old filter
+      stays correct, only less selective. */
+   if (symTable->bloomCounters != NULL) {
+      if ((size_t)symTable->numBindings <= symTable->bloomCapacity ||
+          !SymTable_bloomBuild(symTable, symTable->bloomCapacity * 2)) {
+         SymTable_bloomUpdate(symTable, node->hashCode, 1);
+      }
+   }
+}
+
+/* Adds a binding of key and value to symTable as SymTable_put does,
+   giving it timer as its STTimer (which may be NULL, and must be if
+   symTable has no linked nodes). Returns 1, or 0
+   if key is already in symTable or if insufficient memory is
+   available. */
+static int SymTable_insert(SymTable_T symTable, const char *key,
+                           const void *value, struct STTimer *timer) {
+   struct STNode **nodeRef;
+   struct STNode *newNode;
+   size_t keyHash, newBytes;
+
+   /* Calculating the hashcode for the input key. */
+   keyHash = SymTable_hash(symTable, key);
+
+   /* Checking if binding with key already exists, unless
+      the Bloom filter shows that it cannot. An expired
+      binding with key is reclaimed instead. */
+   if (symTable->bloomCounters == NULL ||
+       SymTable_bloomMayContain(symTable, keyHash)) {
+      nodeRef = SymTable_lookup(symTable, key, keyHash);
+      if (nodeRef != NULL) {
+         if (!SymTable_isExpired(symTable, *nodeRef)) {
+            return 0;
+         }
+         SymTable_reclaim(symTable, nodeRef);
+      }
+   }
+
+   /* A binding larger than the byte bound can never be held. */
+   newBytes = SymTable_nodeBytes(symTable, key);
+   if (symTable->maxBytes != 0 && newBytes > symTable->maxBytes) {
+      return 0;
+   }
+
+   /* Dynamically allocating memory for the new node. */
+   newNode = (struct STNode*)malloc(SymTable_nodeSize(symTable));
+   if (newNode == NULL) {
+      return 0;
+   }
+
+   /* Dynamically allocating memory for the defensive
+      copy of the key of the new node. */
+   newNode->key = (char *)malloc(strlen(key) + 1);
+   if (newNode->key == NULL) {
+      free(newNode);
+      return 0;
+   }
+
+   /* Copying the input key into the key of the newNode
+      (defensive copy). */
+   strcpy((char*)newNode->key, key);
+   newNode->value = value;
+   newNode->hashCode = keyHash;
+   if (symTable->hasLinkedNodes) {
+      SymTable_links(newNode)->timer = timer;
+   }
+   if (timer != NULL) {
+      assert(symTable->hasLinkedNodes);
+      timer->node = newNode;
+   }
+
+   SymTable_link(symTable, newNode);
+   return 1;
+}
+
+/* If key is already in symTable, leaves symTable unchanged
+   and returns 0. If insufficient memory is available,
+   returns 0. If symTable does not contain a binding
+   with key, then adds a new binding to symTable consisting
+   of key and value, and returns 1. */
+int SymTable_put(SymTable_T symTable, const char* key,
+                 const void *value) {
+   unsigned long long startNanos;
+   int result;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   startNanos = SymTable_startTiming(symTable);
+   SymTable_expireSome(symTable);
+   result = SymTable_insert(symTable, key, value, NULL);
+   SymTable_stopTiming(symTable, SYMTABLE_OP_PUT, startNanos);
+   return result;
+}
+
+/* As SymTable_put, but the new binding expires ttlMillis
+   milliseconds from now. From then on, symTable behaves as if the
+   binding had been removed, and the binding is reclaimed (being
+   passed to the expiry function, if any) by a later operation on
+   symTable. */
+int SymTable_putWithTTL(SymTable_T symTable, const char *key,
+                        const void *value, unsigned long ttlMillis) {
+   struct STTimer *timer;
+   unsigned long long now, startNanos;
+   int result;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   /* Creating the timer wheel, and the linked nodes that hold the
+      STTimers, for the first binding with a time to live. */
+   now = SymTable_now();
+   if (!symTable->hasLinkedNodes && !SymTable_linkNodes(symTable)) {
+      return 0;
+   }
+   if (symTable->wheel == NULL) {
+      symTable->wheel = (struct STWheel *)calloc(1, sizeof(struct STWheel));
+      if (symTable->wheel == NULL) {
+         return 0;
+      }
+   }
+   if (symTable->wheel->numTimers == 0) {
+      symTable->wheel->time = now;
+   }
+
+   /* Timing from the same point as SymTable_put, so that the
+      expiry work done on the way is counted alike. */
+   startNanos = SymTable_startTiming(symTable);
+   SymTable_expireSome(symTable);
+   timer = (struct STTimer *)malloc(sizeof(struct STTimer));
+   if (timer == NULL) {
+      result = 0;
+   }
+   else {
+      timer->expiry = now + ttlMillis;
+      result = SymTable_insert(symTable, key, value, timer);
+      if (!result) {
+         free(timer);
+      }
+   }
+   SymTable_stopTiming(symTable, SYMTABLE_OP_PUT, startNanos);
+   return result;
+}
+
+/* Makes symTable pass each expired binding, together with extra, to
+   expireFunction (if it is not NULL) when reclaiming it, so that its
+   value may be released. expireFunction must not change symTable. */
+void SymTable_setExpireFunction(SymTable_T symTable,
+                                void (*expireFunction)
+                                (const char *key, void *value,
+                                 void *extra),
+                                const void *extra) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   symTable->expireFunction = expireFunction;
+   symTable->expireExtra = extra;
+}
+
+/* Reclaims all bindings of symTable that have expired, and returns
+   their number. */
+size_t SymTable_expire(SymTable_T symTable) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   if (symTable->wheel == NULL) {
+      return 0;
+   }
+   return SymTable_advance(symTable, SymTable_now(), (size_t)-1);
+}
+
+/* Returns the STNode of symTable whose key is key, or NULL if there
+   is none. An expired binding with key is reclaimed, and NULL
+   returned. In a bounded symTable, the STNode found becomes the most
+   recently used. */
+static struct STNode *SymTable_find(SymTable_T symTable,
+                                    const char *key) {
+   struct STNode **nodeRef;
+   struct STNode *currentNode;
+   size_t keyHash;
+
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   SymTable_expireSome(symTable);
+
+   /* Calculating the hashcode for the input key, and returning
+      early if the Bloom filter shows the key is missing. */
+   keyHash = SymTable_hash(symTable, key);
+   if (symTable->bloomCounters != NULL &&
+       !SymTable_bloomMayContain(symTable, keyHash)) {
+      return NULL;
+   }
+
+   /* Checking if binding with input key exists. */
+   nodeRef = SymTable_lookup(symTable, key, keyHash);
+   if (nodeRef == NULL) {
+      return NULL;
+   }
+   currentNode = *nodeRef;
+   if (SymTable_isExpired(symTable, currentNode)) {
+      SymTable_reclaim(symTable, nodeRef);
+      return NULL;
+   }
+   if (symTable->isBounded && symTable->newest != currentNode) {
+      SymTable_unlinkRecency(symTable, currentNode);
+      SymTable_linkNewest(symTable, currentNode);
+   }
+   return currentNode;
+}
+
+/* If symTable contains a binding whose key is input parameter key, return
+   its corresponding value and replace the value with input parameter value.
+   Else if there is no binding whose key is input parameter key, leave
+   symTable unchanged and return NULL. */
+void *SymTable_replace(SymTable_T symTable, const char *key, const void *value) {
+   struct STNode *currentNode;
+   void *oldValue = NULL;
+   unsigned long long startNanos;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   /* If binding with input key exists, return corresponding
+      value, and replace it with input value. Else, return
+      NULL. */
+   startNanos = SymTable_startTiming(symTable);
+   currentNode = SymTable_find(symTable, key);
+   if (currentNode != NULL) {
+      oldValue = (void *)currentNode->value;
+      currentNode->value = value;
+   }
+   SymTable_stopTiming(symTable, SYMTABLE_OP_REPLACE, startNanos);
+   return oldValue;
+}
+
+/* If symTable contains a binding whose key is input parameter key,
+   return 1. Else if there is no binding whose key is input
+   parameter key, return 0. symTable is unchanged. */
+int SymTable_contains(SymTable_T symTable, const char *key) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   return SymTable_find(symTable, key) != NULL;
+}
+
+/* If symTable contains a binding whose key is input parameter key,
+   return corresponding value. Else, return NULL. symTable is unchanged. */
+void *SymTable_get(SymTable_T symTable, const char *key) {
+   struct STNode *currentNode;
+   unsigned long long startNanos;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   /* If binding with input key exists, return corresponding
+      value. Else, return NULL. */
+   startNanos = SymTable_startTiming(symTable);
+   currentNode = SymTable_find(symTable, key);
+   SymTable_stopTiming(symTable, SYMTABLE_OP_GET, startNanos);
+   if (currentNode != NULL) {
+      return (void *)currentNode->value;
+   }
+   return NULL;
+}
+
+/* Removes the binding with key from symTable as SymTable_remove
+   does, returning its value, or NULL if there is none. */
+static void *SymTable_delete(SymTable_T symTable, const char *key) {
+   struct STNode **nodeRef;
+   struct STNode *temporaryNode;
+   void *value;
+   size_t keyHash;
+
+   SymTable_expireSome(symTable);
+
+   /* Calculating the hashcode for the input key, and returning
+      early if the Bloom filter shows the key is missing. */
+   keyHash = SymTable_hash(symTable, key);
+   if (symTable->bloomCounters != NULL &&
+       !SymTable_bloomMayContain(symTable, keyHash)) {
+      return NULL;
+   }
+
+   /* If key is not present in symbol table. */
+   nodeRef = SymTable_lookup(symTable, key, keyHash);
+   if (nodeRef == NULL) {
+      return NULL;
+   }
+
+   /* An expired binding is reclaimed as if it were missing. */
+   if (SymTable_isExpired(symTable, *nodeRef)) {
+      SymTable_reclaim(symTable, nodeRef);
+      return NULL;
+   }
+
+   /* Unlinking the node (which also decrements the number of
+      bindings in symTable), returning its value, and freeing the
+      node and its key. */
+   temporaryNode = SymTable_detach(symTable, nodeRef);
+   value = (void *)temporaryNode->value;
+   free((char *)temporaryNode->key);
+   free(temporaryNode);
+   return value;
+}
+
+/* If symTable contains a binding with input key, remove that
+   binding from symTable and return the binding's value. Else,
+   leave symTable unchanged and return NULL. */
+void *SymTable_remove(SymTable_T symTable, const char *key) {
+   unsigned long long startNanos;
+   void *value;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   startNanos = SymTable_startTiming(symTable);
+   value = SymTable_delete(symTable, key);
+   SymTable_stopTiming(symTable, SYMTABLE_OP_REMOVE, startNanos);
    return value;
 }
 
@@ -467,21 +1873,743 @@ void SymTable_map(SymTable_T symTable,
                   void (*functionApply)(const char *key,  void *value,
                                         void *extra), const void *extra) {
    struct STNode *currentNode;
-   int hashCode;
+   unsigned long long now, startNanos;
+   struct STTimer *timer;
+   size_t hashCode;
 
    /* Ensuring that the input parameters are not null. */
    assert(symTable != NULL);
    assert(functionApply != NULL);
 
+   startNanos = SymTable_startTiming(symTable);
+   now = symTable->wheel != NULL ? SymTable_now() : 0;
+
    /* Iterating over all nodes in symTable and
       applying the function to each key-value
-      pair. */
-   for (hashCode = 0; hashCode < (int)symTable->numBuckets; hashCode++) {
+      pair that has not expired. */
+   for (hashCode = 0; hashCode < symTable->numBuckets; hashCode++) {
       for (currentNode = symTable->bucketsArray[hashCode];
            currentNode != NULL;
            currentNode = currentNode->next) {
+         timer = SymTable_timerOf(symTable, currentNode);
+         if (timer != NULL && timer->expiry <= now) {
+            continue;
+         }
          (*functionApply)((const char*)currentNode->key,
                           (void*)currentNode->value, (void*)extra);
       }
    }
+   SymTable_stopTiming(symTable, SYMTABLE_OP_MAP, startNanos);
+}
+
+/* Returns the STNode of symTable with the key of node (an STNode of
+   another symbol table), whose hash code in symTable is hashCode, or
+   NULL if there is none. The recency of the STNode found is not
+   changed. */
+static struct STNode *SymTable_findMatch(SymTable_T symTable,
+                                         const struct STNode *node,
+                                         size_t hashCode) {
+   struct STNode **nodeRef;
+
+   if (symTable->bloomCounters != NULL &&
+       !SymTable_bloomMayContain(symTable, hashCode)) {
+      return NULL;
+   }
+   nodeRef = SymTable_lookup(symTable, node->key, hashCode);
+   return nodeRef != NULL ? *nodeRef : NULL;
+}
+
+/* Returns 1 if operation on dst and src may split the buckets of dst
+   among threads: dst has many buckets, neither table has a Bloom
+   filter, a bound or a binding with a time to live, and dst (and, for
+   SET_MERGE, src) has no tree, so that the STNodes of each bucket are
+   reached only from that bucket. SET_MERGE moves the STNodes of each
+   bucket of src to the same bucket of dst, so the tables must also
+   have the same number of buckets and hash keys alike; the other
+   operations only look up the keys of dst in src. */
+static int SymTable_canSplitBuckets(SymTable_T dst, SymTable_T src,
+                                    enum SetOperation operation) {
+   if (dst->numTrees != 0 ||
+       (operation == SET_MERGE &&
+        (src->numTrees != 0 || dst->numBuckets != src->numBuckets ||
+         dst->seed[0] != src->seed[0] || dst->seed[1] != src->seed[1]))) {
+      return 0;
+   }
+   return dst->numBuckets >= SET_PARALLEL_MIN_BUCKETS &&
+          (size_t)(dst->numBindings + src->numBindings) >=
+          SET_PARALLEL_MIN_BINDINGS &&
+          dst->bloomCounters == NULL && src->bloomCounters == NULL &&
+          !dst->isBounded && !src->isBounded &&
+          (dst->wheel == NULL || dst->wheel->numTimers == 0) &&
+          (src->wheel == NULL || src->wheel->numTimers == 0);
+}
+
+/* Performs operation on the buckets of job, from firstBucket up to
+   (but not including) lastBucket, of dst (and, for SET_MERGE, the
+   same buckets of src, which has as many). The STNodes of dst that
+   are to be removed (for SET_INTERSECT and SET_DIFFERENCE), and those
+   of src whose keys are already in dst (for SET_MERGE), are unlinked
+   into job->unlinked rather than freed, so that the caller may pass
+   them to the client's functions from one thread. Returns NULL (as a
+   thread's start function). */
+static void *SymTable_runSetJob(void *argument) {
+   struct STSetJob *job = (struct STSetJob *)argument;
+   struct STNode **nodeRef;
+   struct STNode *node;
+   size_t i;
+   int found;
+
+   for (i = job->firstBucket; i < job->lastBucket; i++) {
+      if (job->operation == SET_MERGE) {
+         /* Moving each STNode of src to the same bucket of dst,
+            unless dst has its key. */
+         while ((node = job->src->bucketsArray[i]) != NULL) {
+            SymTable_unlinkNode(&job->src->bucketsArray[i]);
+            if (SymTable_findMatch(job->dst, node, node->hashCode) !=
+                NULL) {
+               node->next = job->unlinked;
+               job->unlinked = node;
+            }
+            else {
+               SymTable_pushNode(&job->dst->bucketsArray[i], node);
+               job->numMoved++;
+               job->numBytes += SymTable_nodeBytes(job->src, node->key);
+            }
+         }
+         continue;
+      }
+
+      /* Unlinking each STNode of dst whose key is in src (for
+         SET_DIFFERENCE) or is not (for SET_INTERSECT). */
+      nodeRef = &job->dst->bucketsArray[i];
+      while (*nodeRef != NULL) {
+         node = *nodeRef;
+         found = SymTable_findMatch(job->src, node,
+                                    SymTable_hashFor(job->src, job->dst,
+                                                     node)) != NULL;
+         if (found == (job->operation == SET_DIFFERENCE)) {
+            SymTable_unlinkNode(nodeRef);
+            node->next = job->unlinked;
+            job->unlinked = node;
+            job->numBytes += SymTable_nodeBytes(job->dst, node->key);
+         }
+         else {
+            nodeRef = &node->next;
+         }
+      }
+   }
+   return NULL;
+}
+
+/* Performs operation on all buckets of dst (and src, for SET_MERGE),
+   which SymTable_canSplitBuckets allows to be split, dividing them into
+   ranges run by separate threads (or by this thread, if a thread
+   cannot be created). Returns the STNodes unlinked by all ranges,
+   linked through their next fields, and stores in *numMoved the
+   number of STNodes moved from src to dst. The numbers of bindings
+   and of bytes of dst and src are updated. */
+static struct STNode *SymTable_splitBuckets(SymTable_T dst,
+                                            SymTable_T src,
+                                            enum SetOperation operation,
+                                            size_t *numMoved) {
+   struct STSetJob jobs[SET_MAX_THREADS];
+   pthread_t threads[SET_MAX_THREADS];
+   int started[SET_MAX_THREADS];
+   struct STNode *unlinked = NULL;
+   struct STNode *last;
+   long numCpus;
+   int numJobs, i;
+
+   numCpus = sysconf(_SC_NPROCESSORS_ONLN);
+   numJobs = numCpus < 1 ? 1 :
+             numCpus > SET_MAX_THREADS ? SET_MAX_THREADS : (int)numCpus;
+
+   for (i = 0; i < numJobs; i++) {
+      jobs[i].dst = dst;
+      jobs[i].src = src;
+      jobs[i].operation = operation;
+      jobs[i].firstBucket = dst->numBuckets * (size_t)i / (size_t)numJobs;
+      jobs[i].lastBucket = dst->numBuckets * (size_t)(i + 1) /
+                           (size_t)numJobs;
+      jobs[i].unlinked = NULL;
+      jobs[i].numMoved = 0;
+      jobs[i].numBytes = 0;
+      started[i] = i > 0 && pthread_create(&threads[i], NULL,
+                                           SymTable_runSetJob,
+                                           &jobs[i]) == 0;
+   }
+   (void)SymTable_runSetJob(&jobs[0]);
+
+   /* Waiting for each range, running it here if its thread could
+      not be created, and gathering its results. */
+   *numMoved = 0;
+   for (i = 0; i < numJobs; i++) {
+      if (started[i]) {
+         (void)pthread_join(threads[i], NULL);
+      }
+      else if (i > 0) {
+         (void)SymTable_runSetJob(&jobs[i]);
+      }
+
+      *numMoved += jobs[i].numMoved;
+      if (operation == SET_MERGE) {
+         dst->numBytes += jobs[i].numBytes;
+         src->numBytes -= jobs[i].numBytes;
+      }
+      else {
+         dst->numBytes -= jobs[i].numBytes;
+      }
+      if (jobs[i].unlinked != NULL) {
+         for (last = jobs[i].unlinked; last->next != NULL;
+              last = last->next) {
+         }
+         last->next = unlinked;
+         unlinked = jobs[i].unlinked;
+      }
+   }
+
+   if (operation == SET_MERGE) {
+      dst->numBindings += (int)*numMoved;
+      src->numBindings = 0;
+      src->numBytes = 0;
+   }
+   return unlinked;
+}
+
+/* Rehashes symTable until it has at least as many buckets as
+   bindings (or the maximum number of buckets), or until there is
+   insufficient memory available. */
+static void SymTable_growBuckets(SymTable_T symTable) {
+   while ((size_t)symTable->numBindings > symTable->numBuckets &&
+          symTable->numBuckets < MAX_BUCKETS) {
+      if (!SymTable_rehash(symTable)) {
+         return;
+      }
+   }
+}
+
+/* Moves every binding of src into dst, leaving src empty. For a key
+   bound in both, dst keeps the value returned by
+   (*conflictFunction)(key, dstValue, srcValue, extra), or its own
+   value if conflictFunction is NULL. Expired bindings of both are
+   reclaimed first, and bindings with a time to live keep it. The
+   STNodes of src are moved rather than copied. An empty dst takes the
+   hash key of src, and tables with the same hash key (see
+   SymTable_newLike) and number of buckets are merged bucket by
+   bucket, by several threads if they are large. A bounded
+   dst evicts bindings as SymTable_put would. Returns 1, or 0
+   (leaving both unchanged) if there is insufficient memory
+   available. */
+int SymTable_merge(SymTable_T dst, SymTable_T src,
+                   void *(*conflictFunction)
+                   (const char *key, void *dstValue, void *srcValue,
+                    void *extra),
+                   const void *extra) {
+   struct STNode **nodeRef;
+   struct STNode *node, *match, *unlinked;
+   struct STTimer *timer;
+   size_t i, numMoved;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(dst != NULL);
+   assert(src != NULL);
+   assert(dst != src);
+
+   /* Giving both tables linked nodes if either has them, so that the
+      STNodes of src may be moved into dst. */
+   if (dst->hasLinkedNodes != src->hasLinkedNodes &&
+       !SymTable_linkNodes(dst->hasLinkedNodes ? src : dst)) {
+      return 0;
+   }
+
+   /* Creating the timer wheel of dst if bindings with a time to live
+      are to be moved into it. */
+   if (src->wheel != NULL && src->wheel->numTimers > 0) {
+      if (dst->wheel == NULL) {
+         dst->wheel = (struct STWheel *)calloc(1, sizeof(struct STWheel));
+         if (dst->wheel == NULL) {
+            return 0;
+         }
+      }
+      if (dst->wheel->numTimers == 0) {
+         dst->wheel->time = SymTable_now();
+      }
+   }
+   (void)SymTable_expire(dst);
+   (void)SymTable_expire(src);
+
+   /* An empty dst, which holds no hash codes, hashes keys as src
+      does, so that the keys of src need not be hashed again. */
+   if (dst->numBindings == 0) {
+      dst->seed[0] = src->seed[0];
+      dst->seed[1] = src->seed[1];
+   }
+
+   if (SymTable_canSplitBuckets(dst, src, SET_MERGE)) {
+      unlinked = SymTable_splitBuckets(dst, src, SET_MERGE, &numMoved);
+      while (unlinked != NULL) {
+         node = unlinked;
+         unlinked = node->next;
+         match = SymTable_findMatch(dst, node, node->hashCode);
+         if (conflictFunction != NULL) {
+            match->value = (*conflictFunction)(match->key,
+                                               (void *)match->value,
+                                               (void *)node->value,
+                                               (void *)extra);
+         }
+         free((char *)node->key);
+         free(node);
+      }
+      SymTable_growBuckets(dst);
+      SymTable_treeifyLong(dst);
+      return 1;
+   }
+
+   /* Detaching each STNode of src, keeping its STTimer, and either
+      linking it into dst or resolving the conflict with the STNode
+      of dst with the same key. */
+   for (i = 0; i < src->numBuckets; i++) {
+      nodeRef = &src->bucketsArray[i];
+      while (*nodeRef != NULL) {
+         timer = SymTable_timerOf(src, *nodeRef);
+         if (timer != NULL) {
+            SymTable_wheelUnlink(src->wheel, timer);
+            SymTable_links(*nodeRef)->timer = NULL;
+         }
+         node = SymTable_detach(src, nodeRef);
+         if (timer != NULL) {
+            SymTable_links(node)->timer = timer;
+         }
+         node->hashCode = SymTable_hashFor(dst, src, node);
+
+         match = SymTable_findMatch(dst, node, node->hashCode);
+         if (match == NULL &&
+             (dst->maxBytes == 0 ||
+              SymTable_nodeBytes(dst, node->key) <= dst->maxBytes)) {
+            SymTable_link(dst, node);
+            continue;
+         }
+         if (match != NULL && conflictFunction != NULL) {
+            match->value = (*conflictFunction)(match->key,
+                                               (void *)match->value,
+                                               (void *)node->value,
+                                               (void *)extra);
+         }
+         else if (match == NULL && dst->evictFunction != NULL) {
+            (*dst->evictFunction)(node->key, (void *)node->value,
+                                  (void *)dst->evictExtra);
+         }
+         free(timer);
+         free((char *)node->key);
+         free(node);
+      }
+   }
+   return 1;
+}
+
+/* Removes from dst each binding whose key is (if keepFound is 0) or
+   is not (if keepFound is 1) bound in src, passing each to
+   removeFunction (if it is not NULL) with extra. Returns the number
+   of bindings removed. */
+static size_t SymTable_filterBy(SymTable_T dst, SymTable_T src,
+                                int keepFound,
+                                void (*removeFunction)
+                                (const char *key, void *value,
+                                 void *extra),
+                                const void *extra) {
+   struct STNode **nodeRef;
+   struct STNode *node, *unlinked;
+   enum SetOperation operation;
+   size_t i, numMoved, numRemoved = 0;
+
+   (void)SymTable_expire(dst);
+   (void)SymTable_expire(src);
+
+   operation = keepFound ? SET_INTERSECT : SET_DIFFERENCE;
+   if (SymTable_canSplitBuckets(dst, src, operation)) {
+      unlinked = SymTable_splitBuckets(dst, src, operation, &numMoved);
+      while (unlinked != NULL) {
+         node = unlinked;
+         unlinked = node->next;
+         dst->numBindings--;
+         numRemoved++;
+         if (removeFunction != NULL) {
+            (*removeFunction)(node->key, (void *)node->value,
+                              (void *)extra);
+         }
+         free((char *)node->key);
+         free(node);
+      }
+      return numRemoved;
+   }
+
+   for (i = 0; i < dst->numBuckets; i++) {
+      nodeRef = &dst->bucketsArray[i];
+      while (*nodeRef != NULL) {
+         if ((SymTable_findMatch(src, *nodeRef,
+                                 SymTable_hashFor(src, dst, *nodeRef)) !=
+              NULL) == keepFound) {
+            nodeRef = &(*nodeRef)->next;
+            continue;
+         }
+         node = SymTable_detach(dst, nodeRef);
+         numRemoved++;
+         if (removeFunction != NULL) {
+            (*removeFunction)(node->key, (void *)node->value,
+                              (void *)extra);
+         }
+         free((char *)node->key);
+         free(node);
+      }
+   }
+   return numRemoved;
+}
+
+/* Removes from dst every binding whose key is not bound in src,
+   passing each to removeFunction (if it is not NULL) with extra, so
+   that its value may be released. src is unchanged, except that
+   expired bindings of both are reclaimed first. Returns the number
+   of bindings removed. */
+size_t SymTable_intersect(SymTable_T dst, SymTable_T src,
+                          void (*removeFunction)
+                          (const char *key, void *value, void *extra),
+                          const void *extra) {
+   /* Ensuring that the input parameters are not null. */
+   assert(dst != NULL);
+   assert(src != NULL);
+   assert(dst != src);
+
+   return SymTable_filterBy(dst, src, 1, removeFunction, extra);
+}
+
+/* Removes from dst every binding whose key is bound in src, passing
+   each to removeFunction (if it is not NULL) with extra, so that its
+   value may be released. src is unchanged, except that expired
+   bindings of both are reclaimed first. Returns the number of
+   bindings removed. */
+size_t SymTable_difference(SymTable_T dst, SymTable_T src,
+                           void (*removeFunction)
+                           (const char *key, void *value, void *extra),
+                           const void *extra) {
+   /* Ensuring that the input parameters are not null. */
+   assert(dst != NULL);
+   assert(src != NULL);
+   assert(dst != src);
+
+   return SymTable_filterBy(dst, src, 0, removeFunction, extra);
+}
+
+/* Removes from symTable every binding for which
+   (*predicate)(key, value, extra) returns nonzero, passing each to
+   removeFunction (if it is not NULL) with extra, so that its value
+   may be released. The linked lists are walked once, each binding
+   being unlinked as it is found; expired bindings are reclaimed on
+   the way rather than passed to predicate. predicate must not change
+   symTable. Returns the number of bindings removed. */
+size_t SymTable_removeIf(SymTable_T symTable,
+                         int (*predicate)
+                         (const char *key, void *value, void *extra),
+                         void (*removeFunction)
+                         (const char *key, void *value, void *extra),
+                         const void *extra) {
+   struct STNode **nodeRef;
+   struct STNode *node;
+   struct STTimer *timer;
+   unsigned long long now;
+   size_t i, numRemoved = 0;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(predicate != NULL);
+
+   now = symTable->wheel != NULL ? SymTable_now() : 0;
+   for (i = 0; i < symTable->numBuckets; i++) {
+      nodeRef = &symTable->bucketsArray[i];
+      while (*nodeRef != NULL) {
+         node = *nodeRef;
+         timer = SymTable_timerOf(symTable, node);
+         if (timer != NULL && timer->expiry <= now) {
+            SymTable_reclaim(symTable, nodeRef);
+            continue;
+         }
+         if (!(*predicate)(node->key, (void *)node->value,
+                           (void *)extra)) {
+            nodeRef = &node->next;
+            continue;
+         }
+
+         /* Unlinking the node (which leaves nodeRef referring to
+            the next one), and freeing it and its key. */
+         (void)SymTable_detach(symTable, nodeRef);
+         numRemoved++;
+         if (removeFunction != NULL) {
+            (*removeFunction)(node->key, (void *)node->value,
+                              (void *)extra);
+         }
+         free((char *)node->key);
+         free(node);
+      }
+   }
+   return numRemoved;
+}
+
+/* Fills in *stats with the structure of symTable: its load, the
+   lengths of its linked lists and the number indexed by trees, the
+   rehashing done so far, and the bytes allocated for its STNodes,
+   keys, buckets, trees, Bloom filter and timers. Every linked list
+   is walked. */
+void SymTable_getStats(SymTable_T symTable, struct SymTable_Stats *stats) {
+   struct STNode *currentNode;
+   size_t i, chainLength, numEmpty = 0;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(stats != NULL);
+
+   memset(stats, 0, sizeof(*stats));
+   stats->numBindings = (size_t)symTable->numBindings;
+   stats->numBuckets = symTable->numBuckets;
+   stats->loadFactor = (double)symTable->numBindings /
+                       (double)symTable->numBuckets;
+
+   /* Counting the length of each linked list and the bytes of
+      the keys. */
+   for (i = 0; i < symTable->numBuckets; i++) {
+      chainLength = 0;
+      for (currentNode = symTable->bucketsArray[i]; currentNode != NULL;
+           currentNode = currentNode->next) {
+         chainLength++;
+         stats->keyBytes += strlen(currentNode->key) + 1;
+      }
+      if (chainLength == 0) {
+         numEmpty++;
+      }
+      if (chainLength > stats->maxChainLength) {
+         stats->maxChainLength = chainLength;
+      }
+      if (chainLength >= SYMTABLE_CHAIN_HISTOGRAM_SIZE) {
+         chainLength = SYMTABLE_CHAIN_HISTOGRAM_SIZE - 1;
+      }
+      stats->chainLengthCounts[chainLength]++;
+   }
+   stats->emptyBucketFraction = (double)numEmpty /
+                                (double)symTable->numBuckets;
+   stats->numTrees = symTable->numTrees;
+
+   stats->numRehashes = symTable->numRehashes;
+   stats->rehashSeconds = (double)symTable->rehashNanos / 1e9;
+
+   stats->nodeBytes = (size_t)symTable->numBindings *
+                      SymTable_nodeSize(symTable);
+   stats->bucketBytes = symTable->numBuckets * sizeof(struct STNode *);
+   if (symTable->trees != NULL) {
+      stats->treeBytes = symTable->numBuckets * sizeof(struct STTreeNode *);
+      for (i = 0; i < symTable->numBuckets; i++) {
+         stats->treeBytes += SymTable_treeSize(symTable->trees[i]) *
+                             sizeof(struct STTreeNode);
+      }
+   }
+   if (symTable->bloomMemory != NULL) {
+      stats->bloomBytes = (symTable->numBloomBlocks + 1) *
+                          BLOOM_BLOCK_BYTES;
+   }
+   if (symTable->wheel != NULL) {
+      stats->timerBytes = sizeof(struct STWheel) +
+         symTable->wheel->numTimers * sizeof(struct STTimer);
+   }
+}
+
+/* If enabled is nonzero, makes symTable record the latency of each
+   SymTable_put, SymTable_putWithTTL (as a put), SymTable_get,
+   SymTable_remove, SymTable_replace and SymTable_map, discarding any
+   latencies recorded before. If enabled is 0, stops recording and
+   discards them. Returns 1, or 0 (leaving symTable unchanged) if
+   there is insufficient memory available. */
+int SymTable_setInstrumentation(SymTable_T symTable, int enabled) {
+   LatencyHistogram_T *latencies;
+   int i;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   if (!enabled) {
+      if (symTable->latencies != NULL) {
+         for (i = 0; i < SYMTABLE_NUM_OPS; i++) {
+            LatencyHistogram_free(symTable->latencies[i]);
+         }
+         free(symTable->latencies);
+         symTable->latencies = NULL;
+      }
+      return 1;
+   }
+
+   if (symTable->latencies != NULL) {
+      for (i = 0; i < SYMTABLE_NUM_OPS; i++) {
+         LatencyHistogram_reset(symTable->latencies[i]);
+      }
+      return 1;
+   }
+
+   /* Allocating a histogram for each operation, freeing those
+      already allocated if there isn't enough memory. */
+   latencies = (LatencyHistogram_T *)calloc(SYMTABLE_NUM_OPS,
+                                            sizeof(LatencyHistogram_T));
+   if (latencies == NULL) {
+      return 0;
+   }
+   for (i = 0; i < SYMTABLE_NUM_OPS; i++) {
+      latencies[i] = LatencyHistogram_new();
+      if (latencies[i] == NULL) {
+         while (i > 0) {
+            LatencyHistogram_free(latencies[--i]);
+         }
+         free(latencies);
+         return 0;
+      }
+   }
+   symTable->latencies = latencies;
+   return 1;
+}
+
+/* Fills in *latency with the number of latencies recorded for
+   operation on symTable, their 50th, 99th and 99.9th percentiles and
+   their maximum, all 0 if symTable is not instrumented. */
+void SymTable_getLatency(SymTable_T symTable,
+                         enum SymTable_Operation operation,
+                         struct SymTable_Latency *latency) {
+   LatencyHistogram_T histogram;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(latency != NULL);
+   assert((int)operation >= 0 && operation < SYMTABLE_NUM_OPS);
+
+   memset(latency, 0, sizeof(*latency));
+   if (symTable->latencies == NULL) {
+      return;
+   }
+   histogram = symTable->latencies[operation];
+   latency->count = LatencyHistogram_getCount(histogram);
+   latency->p50 = LatencyHistogram_getPercentile(histogram, 50.0);
+   latency->p99 = LatencyHistogram_getPercentile(histogram, 99.0);
+   latency->p999 = LatencyHistogram_getPercentile(histogram, 99.9);
+   latency->max = LatencyHistogram_getMax(histogram);
+}
+
+/* Writes to stream a line for each operation recorded by
+   instrumented symTable, giving its count and latency percentiles
+   in nanoseconds. */
+void SymTable_dumpLatency(SymTable_T symTable, FILE *stream) {
+   static const char *operationNames[SYMTABLE_NUM_OPS] =
+      {"put", "get", "remove", "replace", "map"};
+   struct SymTable_Latency latency;
+   int i;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(stream != NULL);
+
+   for (i = 0; i < SYMTABLE_NUM_OPS; i++) {
+      SymTable_getLatency(symTable, (enum SymTable_Operation)i, &latency);
+      if (latency.count == 0) {
+         continue;
+      }
+      fprintf(stream, "%-8s count %10lu  p50 %8llu  p99 %8llu  "
+              "p999 %8llu  max %10llu ns\n", operationNames[i],
+              (unsigned long)latency.count, latency.p50, latency.p99,
+              latency.p999, latency.max);
+   }
+}
+
+/* Returns the usable bytes of the STTreeNodes of the tree rooted at
+   root, adding their allocator overhead to *overhead. */
+static size_t SymTable_treeUsage(const struct STTreeNode *root,
+                                 size_t *overhead) {
+   if (root == NULL) {
+      return 0;
+   }
+   return SymTable_blockBytes(root, sizeof(struct STTreeNode), overhead) +
+          SymTable_treeUsage(root->left, overhead) +
+          SymTable_treeUsage(root->right, overhead);
+}
+
+/* Returns the number of bytes of memory held by symTable, and fills
+   in *usage (unless usage is NULL) with those bytes split into
+   STNodes (and their timers), keys, the bucket array together with
+   the SymTable structure and its trees, Bloom filter, timer wheel
+   and latency histograms, and allocator overhead. Every linked list
+   and tree is walked. */
+size_t SymTable_memoryUsage(SymTable_T symTable,
+                            struct SymTable_MemoryUsage *usage) {
+   struct SymTable_MemoryUsage localUsage;
+   struct STNode *currentNode;
+   struct STTimer *timer;
+   size_t i, histogramBytes;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   if (usage == NULL) {
+      usage = &localUsage;
+   }
+   memset(usage, 0, sizeof(*usage));
+   for (i = 0; i < symTable->numBuckets; i++) {
+      for (currentNode = symTable->bucketsArray[i]; currentNode != NULL;
+           currentNode = currentNode->next) {
+         usage->nodeBytes += SymTable_blockBytes
+            (currentNode, SymTable_nodeSize(symTable),
+             &usage->overheadBytes);
+         usage->keyBytes += SymTable_blockBytes
+            (currentNode->key, strlen(currentNode->key) + 1,
+             &usage->overheadBytes);
+         timer = SymTable_timerOf(symTable, currentNode);
+         if (timer != NULL) {
+            usage->nodeBytes += SymTable_blockBytes
+               (timer, sizeof(struct STTimer),
+                &usage->overheadBytes);
+         }
+      }
+   }
+
+   usage->bucketBytes += SymTable_blockBytes
+      (symTable, sizeof(struct SymTable), &usage->overheadBytes);
+   usage->bucketBytes += SymTable_arrayBytes
+      (symTable->bucketsArray, symTable->numBuckets *
+       sizeof(struct STNode *), &usage->overheadBytes);
+   if (symTable->trees != NULL) {
+      usage->bucketBytes += SymTable_blockBytes
+         (symTable->trees, symTable->numBuckets *
+          sizeof(struct STTreeNode *), &usage->overheadBytes);
+      for (i = 0; i < symTable->numBuckets; i++) {
+         usage->bucketBytes += SymTable_treeUsage(symTable->trees[i],
+                                                  &usage->overheadBytes);
+      }
+   }
+   if (symTable->bloomMemory != NULL) {
+      usage->bucketBytes += SymTable_blockBytes
+         (symTable->bloomMemory, (symTable->numBloomBlocks + 1) *
+          BLOOM_BLOCK_BYTES, &usage->overheadBytes);
+   }
+   if (symTable->wheel != NULL) {
+      usage->bucketBytes += SymTable_blockBytes
+         (symTable->wheel, sizeof(struct STWheel), &usage->overheadBytes);
+   }
+
+   /* The latency histograms are opaque, so all their usable bytes
+      are counted. */
+   if (symTable->latencies != NULL) {
+      usage->bucketBytes += SymTable_blockBytes
+         (symTable->latencies, SYMTABLE_NUM_OPS *
+          sizeof(LatencyHistogram_T), &usage->overheadBytes);
+      for (i = 0; i < SYMTABLE_NUM_OPS; i++) {
+         histogramBytes = malloc_usable_size(symTable->latencies[i]);
+         usage->bucketBytes += SymTable_blockBytes
+            (symTable->latencies[i], histogramBytes,
+             &usage->overheadBytes);
+      }
+   }
+
+   usage->totalBytes = usage->nodeBytes + usage->keyBytes +
+                       usage->bucketBytes + usage->overheadBytes;
+   return usage->totalBytes;
 }
@@ -0,0 +1,115 @@
+#ifndef SYMTABLEHASH_INCLUDED
+#define SYMTABLEHASH_INCLUDED
+
+#include <stdio.h>
+#include "symtable.h"
+
+/* Extensions of the SymTable interface, provided by the hash table
+   implementation (symtablehash.c). */
+
+/* The number of chain lengths counted separately by
+   SymTable_getStats. The last count is of all longer chains. */
+enum{SYMTABLE_CHAIN_HISTOGRAM_SIZE = 8};
+
+/* The structure of a SymTable, as reported by SymTable_getStats. */
+struct SymTable_Stats {
+   size_t numBindings;
+   size_t numBuckets;
+   double loadFactor;
+   double emptyBucketFraction;
+
+   /* chainLengthCounts[i] is the number of buckets holding i
+      bindings, or at least i bindings for the last element. */
+   size_t chainLengthCounts[SYMTABLE_CHAIN_HISTOGRAM_SIZE];
+   size_t maxChainLength;
+
+   /* The number of chains indexed by balanced trees, having grown
+      long. */
+   size_t numTrees;
+
+   size_t numRehashes;
+   double rehashSeconds;
+
+   size_t nodeBytes;
+   size_t keyBytes;
+   size_t bucketBytes;
+   size_t bloomBytes;
+   size_t timerBytes;
+   size_t treeBytes;
+};
+
+SymTable_T SymTable_newBounded(size_t maxBindings, size_t maxBytes,
+                               void (*evictFunction)
+                               (const char *key, void *value,
+                                void *extra),
+                               const void *extra);
+
+SymTable_T SymTable_newLike(SymTable_T symTable);
+
+int SymTable_setBloomFilter(SymTable_T symTable, int enabled);
+
+int SymTable_putWithTTL(SymTable_T symTable, const char *key,
+                        const void *value, unsigned long ttlMillis);
+
+void SymTable_setExpireFunction(SymTable_T symTable,
+                                void (*expireFunction)
+                                (const char *key, void *value,
+                                 void *extra),
+                                const void *extra);
+
+size_t SymTable_expire(SymTable_T symTable);
+
+void SymTable_clear(SymTable_T symTable,
+                    void (*freeFunction)
+                    (const char *key, void *value, void *extra),
+                    const void *extra);
+
+void SymTable_getStats(SymTable_T symTable, struct SymTable_Stats *stats);
+
+size_t SymTable_removeIf(SymTable_T symTable,
+                         int (*predicate)
+                         (const char *key, void *value, void *extra),
+                         void (*removeFunction)
+                         (const char *key, void *value, void *extra),
+                         const void *extra);
+
+/* The operations whose latencies an instrumented SymTable records. */
+enum SymTable_Operation {SYMTABLE_OP_PUT, SYMTABLE_OP_GET,
+                         SYMTABLE_OP_REMOVE, SYMTABLE_OP_REPLACE,
+                         SYMTABLE_OP_MAP, SYMTABLE_NUM_OPS};
+
+/* The latencies (in nanoseconds) of one operation, as reported by
+   SymTable_getLatency. */
+struct SymTable_Latency {
+   size_t count;
+   unsigned long long p50;
+   unsigned long long p99;
+   unsigned long long p999;
+   unsigned long long max;
+};
+
+int SymTable_setInstrumentation(SymTable_T symTable, int enabled);
+
+void SymTable_getLatency(SymTable_T symTable,
+                         enum SymTable_Operation operation,
+                         struct SymTable_Latency *latency);
+
+void SymTable_dumpLatency(SymTable_T symTable, FILE *stream);
+
+int SymTable_merge(SymTable_T dst, SymTable_T src,
+                   void *(*conflictFunction)
+                   (const char *key, void *dstValue, void *srcValue,
+                    void *extra),
+                   const void *extra);
+
+size_t SymTable_intersect(SymTable_T dst, SymTable_T src,
+                          void (*removeFunction)
+                          (const char *key, void *value, void *extra),
+                          const void *extra);
+
+size_t SymTable_difference(SymTable_T dst, SymTable_T src,
+                           void (*removeFunction)
+                           (const char *key, void *value, void *extra),
+                           const void *extra);
+
+#endif
@@ -1,7 +1,7 @@
 #include <assert.h>
 #include <string.h>
-#include <malloc.h>
 #include "symtable.h"
+#include "symtableutil.h"
 
 enum{MAX_BUCKETS = 65521};
 static size_t bucketCounts[] = {509, 1021, 2039, 4093, 8191, 16381, 32749, 65521};
@@ -301,3 +301,40 @@ void SymTable_map(SymTable_T symTable,
       }
    }
 }
+
+size_t SymTable_memoryUsage(SymTable_T symTable,
+                            struct SymTable_MemoryUsage *usageOut) {
+   struct SymTable_MemoryUsage usage;
+   struct STNode *currentNode;
+   int hashCode;
+
+   assert(symTable != NULL);
+
+   memset(&usage, 0, sizeof(usage));
+   usage.bucketBytes += SymTable_blockBytes(symTable,
+                                            sizeof(struct SymTable),
+                                            &usage.overheadBytes);
+   usage.bucketBytes += SymTable_blockBytes(symTable->bucketsArray,
+                                            symTable->numBuckets *
+                                            sizeof(struct STNode *),
+                                            &usage.overheadBytes);
+   for (hashCode = 0; hashCode < symTable->numBuckets; hashCode++) {
+      for (currentNode = symTable->bucketsArray[hashCode];
+           currentNode != NULL;
+           currentNode = currentNode->next) {
+         usage.nodeBytes += SymTable_blockBytes(currentNode,
+                                                sizeof(struct STNode),
+                                                &usage.overheadBytes);
+         usage.keyBytes += SymTable_blockBytes(currentNode->key,
+                                               strlen(currentNode->key) + 1,
+                                               &usage.overheadBytes);
+      }
+   }
+
+   usage.totalBytes = usage.nodeBytes + usage.keyBytes +
+                      usage.bucketBytes + usage.overheadBytes;
+   if (usageOut != NULL) {
+      *usageOut = usage;
+   }
+   return usage.totalBytes;
+}
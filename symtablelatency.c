@@ -0,0 +1,174 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: symtablelatency.c
+ *
+ *  Description: Implements a LatencyHistogram data type, which counts
+ *  latencies in logarithmic buckets split into linear sub-buckets
+ *  (as an HDR histogram does), so that recording a latency takes a
+ *  few instructions and its percentiles can be reported to within a
+ *  small relative error. SymTable implementations use it to time
+ *  their operations.
+ ******************************************************************* */
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "symtablelatency.h"
+
+/* Declaring an enum to hold the number of bits of a latency that
+   select its counter (its highest set bit included), the number of
+   latencies below which each has a counter of its own, and the total
+   number of counters, which covers every 64-bit latency. */
+enum{SUB_BUCKET_BITS = 5, SUB_BUCKETS = 1 << SUB_BUCKET_BITS,
+     NUM_COUNTERS = (64 - SUB_BUCKET_BITS + 2) * (SUB_BUCKETS / 2)};
+
+/* A LatencyHistogram structure holds a counter per sub-bucket, the
+   number of latencies recorded and the largest of them. */
+struct LatencyHistogram {
+   /* The number of latencies recorded in each sub-bucket. */
+   size_t counters[NUM_COUNTERS];
+
+   /* The number of latencies recorded. */
+   size_t count;
+
+   /* The largest latency recorded. */
+   unsigned long long max;
+};
+
+/* Returns the index of the highest set bit of nonzero value. */
+static int LatencyHistogram_highestBit(unsigned long long value) {
+#if defined(__GNUC__)
+   return 63 - __builtin_clzll(value);
+#else
+   int bit = 0;
+
+   while (value >>= 1) {
+      bit++;
+   }
+   return bit;
+#endif
+}
+
+/* Returns the index of the counter for a latency of nanos. Latencies
+   below SUB_BUCKETS have a counter each; above, each power of two is
+   split into SUB_BUCKETS / 2 counters. */
+static size_t LatencyHistogram_index(unsigned long long nanos) {
+   int shift;
+
+   if (nanos < SUB_BUCKETS) {
+      return (size_t)nanos;
+   }
+   shift = LatencyHistogram_highestBit(nanos) - (SUB_BUCKET_BITS - 1);
+   return (size_t)shift * (SUB_BUCKETS / 2) + (size_t)(nanos >> shift);
+}
+
+/* Returns the largest latency counted by the counter at index. */
+static unsigned long long LatencyHistogram_highestValue(size_t index) {
+   int shift;
+   unsigned long long subBucket;
+
+   if (index < SUB_BUCKETS) {
+      return (unsigned long long)index;
+   }
+   shift = (int)(index / (SUB_BUCKETS / 2)) - 1;
+   subBucket = (unsigned long long)(index - (size_t)shift *
+                                    (SUB_BUCKETS / 2));
+   return ((subBucket + 1) << shift) - 1;
+}
+
+/* Returns a new LatencyHistogram with no latencies recorded, or NULL
+   if there is insufficient memory available. */
+LatencyHistogram_T LatencyHistogram_new(void) {
+   return (LatencyHistogram_T)calloc(1, sizeof(struct LatencyHistogram));
+}
+
+/* Frees all memory occupied by histogram. */
+void LatencyHistogram_free(LatencyHistogram_T histogram) {
+   free(histogram);
+}
+
+/* Records a latency of nanos nanoseconds in histogram. */
+void LatencyHistogram_record(LatencyHistogram_T histogram,
+                             unsigned long long nanos) {
+   /* Ensuring that the input parameters are not null. */
+   assert(histogram != NULL);
+
+   histogram->counters[LatencyHistogram_index(nanos)]++;
+   histogram->count++;
+   if (nanos > histogram->max) {
+      histogram->max = nanos;
+   }
+}
+
+/* Returns the number of latencies recorded in histogram. */
+size_t LatencyHistogram_getCount(LatencyHistogram_T histogram) {
+   /* Ensuring that the input parameters are not null. */
+   assert(histogram != NULL);
+   return histogram->count;
+}
+
+/* Returns the largest latency recorded in histogram, or 0 if none
+   has been. */
+unsigned long long LatencyHistogram_getMax(LatencyHistogram_T histogram) {
+   /* Ensuring that the input parameters are not null. */
+   assert(histogram != NULL);
+   return histogram->max;
+}
+
+/* Returns the latency that percentile percent (between 0 and 100) of
+   the latencies recorded in histogram do not exceed, rounded up to
+   the largest latency of its sub-bucket, or 0 if no latency has been
+   recorded. */
+unsigned long long LatencyHistogram_getPercentile
+   (LatencyHistogram_T histogram, double percentile) {
+   size_t target, seen = 0;
+   size_t index;
+   unsigned long long value;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(histogram != NULL);
+   assert(percentile >= 0.0 && percentile <= 100.0);
+
+   if (histogram->count == 0) {
+      return 0;
+   }
+
+   /* Finding the counter that holds the target-th smallest
+      latency. */
+   target = (size_t)(percentile / 100.0 * (double)histogram->count + 0.5);
+   if (target == 0) {
+      target = 1;
+   }
+   if (target > histogram->count) {
+      target = histogram->count;
+   }
+   for (index = 0; index < NUM_COUNTERS; index++) {
+      seen += histogram->counters[index];
+      if (seen >= target) {
+         break;
+      }
+   }
+
+   value = LatencyHistogram_highestValue(index);
+   return value < histogram->max ? value : histogram->max;
+}
+
+/* Discards all latencies recorded in histogram. */
+void LatencyHistogram_reset(LatencyHistogram_T histogram) {
+   /* Ensuring that the input parameters are not null. */
+   assert(histogram != NULL);
+   memset(histogram, 0, sizeof(*histogram));
+}
+
+/* Returns the present time in nanoseconds, from a clock that is
+   never set backwards, for timing an operation. */
+unsigned long long LatencyHistogram_now(void) {
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return (unsigned long long)now.tv_sec * 1000000000 +
+          (unsigned long long)now.tv_nsec;
+}
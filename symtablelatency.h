@@ -0,0 +1,30 @@
+#ifndef SYMTABLELATENCY_INCLUDED
+#define SYMTABLELATENCY_INCLUDED
+
+#include <stddef.h>
+
+/* A LatencyHistogram counts latencies (in nanoseconds) in
+   logarithmic buckets, each split into linear sub-buckets, so that
+   every latency is reported to within 1/16 of its value. */
+
+typedef struct LatencyHistogram *LatencyHistogram_T;
+
+LatencyHistogram_T LatencyHistogram_new(void);
+
+void LatencyHistogram_free(LatencyHistogram_T histogram);
+
+void LatencyHistogram_record(LatencyHistogram_T histogram,
+                             unsigned long long nanos);
+
+size_t LatencyHistogram_getCount(LatencyHistogram_T histogram);
+
+unsigned long long LatencyHistogram_getMax(LatencyHistogram_T histogram);
+
+unsigned long long LatencyHistogram_getPercentile
+   (LatencyHistogram_T histogram, double percentile);
+
+void LatencyHistogram_reset(LatencyHistogram_T histogram);
+
+unsigned long long LatencyHistogram_now(void);
+
+#endif
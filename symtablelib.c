@@ -0,0 +1,399 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: symtablelib.c
+ *
+ *  Description: Implements the SymTable interface for libsymtable,
+ *  which links every SymTable implementation into one library. Each
+ *  implementation is compiled with its public names prefixed (see
+ *  symtablebackend.h). A SymTable of the library holds a table of one
+ *  implementation, chosen when it is created, together with a table
+ *  of functions through which each operation is dispatched to that
+ *  implementation.
+ ******************************************************************* */
+#include <assert.h>
+#include <string.h>
+#include <malloc.h>
+#include "symtablelib.h"
+
+/* Declares the functions of the implementation whose public names
+   start with prefix, and defines functions calling them with the
+   address of its table passed as a void pointer, so that every
+   implementation can be reached through the same table of
+   functions. */
+#define SYMTABLE_ADAPT(prefix)                                         \
+   struct prefix;                                                      \
+   struct prefix *prefix##_new(void);                                  \
+   void prefix##_free(struct prefix *table);                           \
+   size_t prefix##_getLength(struct prefix *table);                    \
+   int prefix##_put(struct prefix *table, const char *key,             \
+                    const void *value);                                \
+   void *prefix##_replace(struct prefix *table, const char *key,       \
+                          const void *value);                          \
+   int prefix##_contains(struct prefix *table, const char *key);       \
+   void *prefix##_get(struct prefix *table, const char *key);          \
+   void *prefix##_remove(struct prefix *table, const char *key);       \
+   void prefix##_map(struct prefix *table, void (*functionApply)       \
+                     (const char *key, void *value, void *extra),      \
+                     const void *extra);                               \
+   size_t prefix##_memoryUsage(struct prefix *table,                   \
+                               struct SymTable_MemoryUsage *usage);    \
+                                                                       \
+   static void *prefix##_newTable(void) {                              \
+      return prefix##_new();                                           \
+   }                                                                   \
+   static void prefix##_freeTable(void *table) {                       \
+      prefix##_free((struct prefix *)table);                           \
+   }                                                                   \
+   static size_t prefix##_lengthOf(void *table) {                      \
+      return prefix##_getLength((struct prefix *)table);               \
+   }                                                                   \
+   static int prefix##_putIn(void *table, const char *key,             \
+                             const void *value) {                      \
+      return prefix##_put((struct prefix *)table, key, value);         \
+   }                                                                   \
+   static void *prefix##_replaceIn(void *table, const char *key,       \
+                                   const void *value) {                \
+      return prefix##_replace((struct prefix *)table, key, value);     \
+   }                                                                   \
+   static int prefix##_containedIn(void *table, const char *key) {     \
+      return prefix##_contains((struct prefix *)table, key);           \
+   }                                                                   \
+   static void *prefix##_getFrom(void *table, const char *key) {       \
+      return prefix##_get((struct prefix *)table, key);                \
+   }                                                                   \
+   static void *prefix##_removeFrom(void *table, const char *key) {    \
+      return prefix##_remove((struct prefix *)table, key);             \
+   }                                                                   \
+   static void prefix##_mapOver(void *table, void (*functionApply)     \
+                                (const char *key, void *value,         \
+                                 void *extra), const void *extra) {    \
+      prefix##_map((struct prefix *)table, functionApply, extra);      \
+   }                                                                   \
+   static size_t prefix##_usageOf(void *table,                         \
+                                  struct SymTable_MemoryUsage *usage) {\
+      return prefix##_memoryUsage((struct prefix *)table, usage);      \
+   }
+
+/* Declares SymTable_clear of the implementation whose public names
+   start with prefix, and defines a function calling it as
+   SYMTABLE_ADAPT does. */
+#define SYMTABLE_ADAPT_CLEAR(prefix)                                   \
+   void prefix##_clear(struct prefix *table, void (*freeFunction)      \
+                       (const char *key, void *value, void *extra),    \
+                       const void *extra);                             \
+                                                                       \
+   static void prefix##_clearTable(void *table, void (*freeFunction)   \
+                                   (const char *key, void *value,      \
+                                    void *extra), const void *extra) { \
+      prefix##_clear((struct prefix *)table, freeFunction, extra);     \
+   }
+
+/* Declares SymTable_removeIf of the implementation whose public names
+   start with prefix, and defines a function calling it as
+   SYMTABLE_ADAPT does. */
+#define SYMTABLE_ADAPT_REMOVE_IF(prefix)                               \
+   size_t prefix##_removeIf(struct prefix *table, int (*predicate)     \
+                            (const char *key, void *value,             \
+                             void *extra), void (*removeFunction)      \
+                            (const char *key, void *value,             \
+                             void *extra), const void *extra);         \
+                                                                       \
+   static size_t prefix##_removeIfFrom(void *table, int (*predicate)   \
+                                       (const char *key, void *value,  \
+                                        void *extra),                  \
+                                       void (*removeFunction)          \
+                                       (const char *key, void *value,  \
+                                        void *extra),                  \
+                                       const void *extra) {            \
+      return prefix##_removeIf((struct prefix *)table, predicate,      \
+                               removeFunction, extra);                 \
+   }
+
+/* Initializes the table of functions of the implementation whose
+   public names start with prefix, and whose name is name. clear and
+   removeIf are the functions adapted by SYMTABLE_ADAPT_CLEAR and
+   SYMTABLE_ADAPT_REMOVE_IF, or NULL if the implementation lacks that
+   extension. */
+#define SYMTABLE_BACKEND_ENTRY(prefix, name, clear, removeIf)          \
+   {name, prefix##_newTable, prefix##_freeTable, prefix##_lengthOf,    \
+    prefix##_putIn, prefix##_replaceIn, prefix##_containedIn,          \
+    prefix##_getFrom, prefix##_removeFrom, prefix##_mapOver,           \
+    prefix##_usageOf, clear, removeIf}
+
+/* The functions of one implementation, each taking the address of a
+   table of that implementation. */
+struct SymTable_Backend {
+   /* The name of the implementation. */
+   const char *name;
+
+   void *(*newTable)(void);
+   void (*freeTable)(void *table);
+   size_t (*getLength)(void *table);
+   int (*put)(void *table, const char *key, const void *value);
+   void *(*replace)(void *table, const char *key, const void *value);
+   int (*contains)(void *table, const char *key);
+   void *(*get)(void *table, const char *key);
+   void *(*remove)(void *table, const char *key);
+   void (*map)(void *table, void (*functionApply)
+               (const char *key, void *value, void *extra),
+               const void *extra);
+   size_t (*memoryUsage)(void *table, struct SymTable_MemoryUsage *usage);
+
+   /* The extensions shared by some implementations, or NULL for an
+      implementation that lacks one. */
+   void (*clear)(void *table, void (*freeFunction)
+                 (const char *key, void *value, void *extra),
+                 const void *extra);
+   size_t (*removeIf)(void *table, int (*predicate)
+                      (const char *key, void *value, void *extra),
+                      void (*removeFunction)
+                      (const char *key, void *value, void *extra),
+                      const void *extra);
+};
+
+SYMTABLE_ADAPT(SymTableList)
+SYMTABLE_ADAPT(SymTableHash)
+SYMTABLE_ADAPT(SymTableBTree)
+SYMTABLE_ADAPT(SymTableArt)
+SYMTABLE_ADAPT(SymTableCompact)
+SYMTABLE_ADAPT(SymTableCuckoo)
+SYMTABLE_ADAPT_CLEAR(SymTableList)
+SYMTABLE_ADAPT_CLEAR(SymTableHash)
+SYMTABLE_ADAPT_CLEAR(SymTableCompact)
+SYMTABLE_ADAPT_REMOVE_IF(SymTableList)
+SYMTABLE_ADAPT_REMOVE_IF(SymTableHash)
+
+/* The tables of functions of the implementations, in the order of
+   enum SymTable_Kind. */
+static const struct SymTable_Backend backends[SYMTABLE_NUM_KINDS] = {
+   SYMTABLE_BACKEND_ENTRY(SymTableList, "list", SymTableList_clearTable,
+                          SymTableList_removeIfFrom),
+   SYMTABLE_BACKEND_ENTRY(SymTableHash, "hash", SymTableHash_clearTable,
+                          SymTableHash_removeIfFrom),
+   SYMTABLE_BACKEND_ENTRY(SymTableBTree, "btree", NULL, NULL),
+   SYMTABLE_BACKEND_ENTRY(SymTableArt, "art", NULL, NULL),
+   SYMTABLE_BACKEND_ENTRY(SymTableCompact, "compact",
+                          SymTableCompact_clearTable, NULL),
+   SYMTABLE_BACKEND_ENTRY(SymTableCuckoo, "cuckoo", NULL, NULL)
+};
+
+/* A SymTable structure holds the table of functions of the
+   implementation it uses, and a table of that implementation. */
+struct SymTable {
+   /* The kind of implementation, and its table of functions. */
+   enum SymTable_Kind kind;
+   const struct SymTable_Backend *backend;
+
+   /* The address of the table of the implementation. */
+   void *table;
+};
+
+/* Returns a new SymTable object that contains no bindings and uses
+   the implementation kind, or NULL if there is insufficient memory
+   available. */
+SymTable_T SymTable_newWithBackend(enum SymTable_Kind kind) {
+   SymTable_T symTable;
+
+   /* Ensuring that the input parameters are valid. */
+   assert((int)kind >= 0 && kind < SYMTABLE_NUM_KINDS);
+
+   symTable = (SymTable_T)malloc(sizeof(struct SymTable));
+   if (symTable == NULL) {
+      return NULL;
+   }
+   symTable->kind = kind;
+   symTable->backend = &backends[kind];
+   symTable->table = (*symTable->backend->newTable)();
+   if (symTable->table == NULL) {
+      free(symTable);
+      return NULL;
+   }
+   return symTable;
+}
+
+/* Returns a new SymTable object that contains no bindings and uses
+   the implementation named by the environment variable
+   SYMTABLE_DEFAULT_BACKEND, or the hash table if it names none, or
+   NULL if there is insufficient memory available. */
+SymTable_T SymTable_new(void) {
+   const char *name = getenv("SYMTABLE_DEFAULT_BACKEND");
+   int kind;
+
+   if (name != NULL) {
+      for (kind = 0; kind < SYMTABLE_NUM_KINDS; kind++) {
+         if (strcmp(name, backends[kind].name) == 0) {
+            return SymTable_newWithBackend((enum SymTable_Kind)kind);
+         }
+      }
+   }
+   return SymTable_newWithBackend(SYMTABLE_HASH);
+}
+
+/* Returns the kind of implementation symTable uses. */
+enum SymTable_Kind SymTable_getBackend(SymTable_T symTable) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   return symTable->kind;
+}
+
+/* Returns the name of the implementation kind. */
+const char *SymTable_getBackendName(enum SymTable_Kind kind) {
+   /* Ensuring that the input parameters are valid. */
+   assert((int)kind >= 0 && kind < SYMTABLE_NUM_KINDS);
+   return backends[kind].name;
+}
+
+/* Frees all memory occupied by symTable. */
+void SymTable_free(SymTable_T symTable) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   (*symTable->backend->freeTable)(symTable->table);
+   free(symTable);
+}
+
+/* Returns number of bindings (key-value pairs) in symTable. */
+size_t SymTable_getLength(SymTable_T symTable) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   return (*symTable->backend->getLength)(symTable->table);
+}
+
+/* If key is already in symTable, leaves symTable unchanged
+   and returns 0. If insufficient memory is available,
+   returns 0. If symTable does not contain a binding
+   with key, then adds a new binding to symTable consisting
+   of key and value, and returns 1. */
+int SymTable_put(SymTable_T symTable, const char *key,
+                 const void *value) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+   return (*symTable->backend->put)(symTable->table, key, value);
+}
+
+/* If symTable contains a binding whose key is input parameter key, return
+   its corresponding value and replace the value with input parameter value.
+   Else if there is no binding whose key is input parameter key, leave
+   symTable unchanged and return NULL. */
+void *SymTable_replace(SymTable_T symTable, const char *key,
+                       const void *value) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+   return (*symTable->backend->replace)(symTable->table, key, value);
+}
+
+/* If symTable contains a binding whose key is input parameter key,
+   return 1. Else if there is no binding whose key is input
+   parameter key, return 0. symTable is unchanged. */
+int SymTable_contains(SymTable_T symTable, const char *key) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+   return (*symTable->backend->contains)(symTable->table, key);
+}
+
+/* If symTable contains a binding whose key is input parameter key,
+   return corresponding value. Else, return NULL. symTable is unchanged. */
+void *SymTable_get(SymTable_T symTable, const char *key) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+   return (*symTable->backend->get)(symTable->table, key);
+}
+
+/* If symTable contains a binding with input key, remove that
+   binding from symTable and return the binding's value. Else,
+   leave symTable unchanged and return NULL. */
+void *SymTable_remove(SymTable_T symTable, const char *key) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+   return (*symTable->backend->remove)(symTable->table, key);
+}
+
+/* Applying the function functionApply to each binding in symTable,
+   passing extra as an extra parameter. */
+void SymTable_map(SymTable_T symTable,
+                  void (*functionApply)(const char *key, void *value,
+                                        void *extra),
+                  const void *extra) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(functionApply != NULL);
+   (*symTable->backend->map)(symTable->table, functionApply, extra);
+}
+
+/* Returns the number of bytes of memory held by symTable, including
+   its SymTable structure, and fills in *usage (unless usage is NULL)
+   with those bytes split as the implementation splits them. */
+size_t SymTable_memoryUsage(SymTable_T symTable,
+                            struct SymTable_MemoryUsage *usage) {
+   struct SymTable_MemoryUsage localUsage;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   if (usage == NULL) {
+      usage = &localUsage;
+   }
+   (void)(*symTable->backend->memoryUsage)(symTable->table, usage);
+   usage->bucketBytes += sizeof(struct SymTable);
+   usage->overheadBytes += malloc_usable_size(symTable) -
+                           sizeof(struct SymTable) + sizeof(size_t);
+   usage->totalBytes = usage->nodeBytes + usage->keyBytes +
+                       usage->bucketBytes + usage->overheadBytes;
+   return usage->totalBytes;
+}
+
+/* If the implementation of symTable provides SymTable_clear, removes
+   every binding from symTable, first applying the function
+   freeFunction to each (if freeFunction is not NULL) so that its
+   value may be released, passing extra as an extra parameter, and
+   returns 1. Otherwise leaves symTable unchanged and returns 0. */
+int SymTable_clear(SymTable_T symTable,
+                   void (*freeFunction)
+                   (const char *key, void *value, void *extra),
+                   const void *extra) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   if (symTable->backend->clear == NULL) {
+      return 0;
+   }
+   (*symTable->backend->clear)(symTable->table, freeFunction, extra);
+   return 1;
+}
+
+/* If the implementation of symTable provides SymTable_removeIf,
+   removes each binding of symTable for which predicate returns
+   nonzero, first applying the function removeFunction to it (if
+   removeFunction is not NULL), passing extra as an extra parameter to
+   both, stores the number of bindings removed in *numRemoved (unless
+   numRemoved is NULL), and returns 1. Otherwise leaves symTable
+   unchanged and returns 0. */
+int SymTable_removeIf(SymTable_T symTable,
+                      int (*predicate)
+                      (const char *key, void *value, void *extra),
+                      void (*removeFunction)
+                      (const char *key, void *value, void *extra),
+                      const void *extra, size_t *numRemoved) {
+   size_t count;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(predicate != NULL);
+
+   if (symTable->backend->removeIf == NULL) {
+      return 0;
+   }
+   count = (*symTable->backend->removeIf)(symTable->table, predicate,
+                                          removeFunction, extra);
+   if (numRemoved != NULL) {
+      *numRemoved = count;
+   }
+   return 1;
+}
@@ -0,0 +1,41 @@
+#ifndef SYMTABLELIB_INCLUDED
+#define SYMTABLELIB_INCLUDED
+
+#include "symtable.h"
+
+/* Extensions of the SymTable interface, provided by libsymtable
+   (symtablelib.c), which holds every implementation and lets each
+   SymTable choose one. SymTable_new uses the implementation named by
+   the environment variable SYMTABLE_DEFAULT_BACKEND ("list", "hash",
+   "btree", "art", "compact" or "cuckoo"), or the hash table if it is
+   not set. */
+
+/* The implementations a SymTable may use. */
+enum SymTable_Kind {SYMTABLE_LIST, SYMTABLE_HASH, SYMTABLE_BTREE,
+                    SYMTABLE_ART, SYMTABLE_COMPACT, SYMTABLE_CUCKOO,
+                    SYMTABLE_NUM_KINDS};
+
+SymTable_T SymTable_newWithBackend(enum SymTable_Kind kind);
+
+enum SymTable_Kind SymTable_getBackend(SymTable_T symTable);
+
+const char *SymTable_getBackendName(enum SymTable_Kind kind);
+
+/* The extensions shared by some implementations. Each returns 0,
+   leaving symTable unchanged, if the implementation of symTable lacks
+   it: SymTable_clear is provided by the list, hash and compact
+   tables, and SymTable_removeIf by the list and hash tables. */
+
+int SymTable_clear(SymTable_T symTable,
+                   void (*freeFunction)
+                   (const char *key, void *value, void *extra),
+                   const void *extra);
+
+int SymTable_removeIf(SymTable_T symTable,
+                      int (*predicate)
+                      (const char *key, void *value, void *extra),
+                      void (*removeFunction)
+                      (const char *key, void *value, void *extra),
+                      const void *extra, size_t *numRemoved);
+
+#endif
@@ -12,14 +12,32 @@
  *  it is no longer to be used, for a function to be applied to all
  *  key-value pairs, for the value for a specified key to be replaced,
  *  and for checking if a SymTable contains a given key.
+ *
+ *  Small tables keep their bindings in flat arrays beside the SymTable
+ *  structure, and are searched by comparing a one-byte tag of each
+ *  key's hash, 16 tags at a time where SSE2 is available. A table
+ *  that outgrows the arrays is promoted to buckets of linked lists,
+ *  and the arrays are freed. A table may instead organize itself,
+ *  moving keys that are found towards the front so that frequently
+ *  accessed keys are found quickly: it is then promoted to a single
+ *  linked list, which is searched from the front.
  ******************************************************************* */
 
 #include <assert.h>
 #include <string.h>
-#include <malloc.h>
-#include "symtable.h"
-
-/* Each item is stored in an STNode. STNodes are linked to form a list.  */
+#include <limits.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "symtablelist.h"
+#include "symtableutil.h"
+
+/* Declaring an enum to hold the number of bindings kept in the flat
+   arrays, and the number of buckets a table is promoted to. */
+enum{FLAT_CAPACITY = 32, INITIAL_BUCKETS = 64};
+
+/* Once promoted, each item is stored in an STNode. STNodes are
+   linked to form a list for each bucket.  */
 struct STNode {
    /* The String key (array of chars). */
    const char *key;
@@ -27,22 +45,284 @@ struct STNode {
    /* The address of the value. */
    const void *value;
 
+   /* The hash code of the key, kept so that growing the buckets
+      and most failed comparisons need not look at the key. */
+   size_t hashCode;
+
    /* The address of the next STNode. */
    struct STNode *nextNode;
 };
 
-/* A SymTable structure is a 'manager' structure that contains
-   an array of linked lists, and the total number of bindings,
-   i.e. the length of the symTable. */
-struct SymTable {
-   /* The address of the firstNode in symTable. */
-   struct STNode *firstNode;
+/* While a table is flat, its bindings are held in an STFlat: the top
+   byte of each key's hash code, the length of each key, the
+   defensive copies of the keys and the addresses of the values, in
+   slots 0 to length - 1. */
+struct STFlat {
+   unsigned char tags[FLAT_CAPACITY];
+   size_t keyLengths[FLAT_CAPACITY];
+   const char *keys[FLAT_CAPACITY];
+   const void *values[FLAT_CAPACITY];
+};
 
-   /* The length of the linked list, i.e. the
-      number of bindings in symTable. */
+/* A SymTable structure is a 'manager' structure that contains the
+   number of bindings and either flat arrays holding up to
+   FLAT_CAPACITY bindings, or an array of linked lists. */
+struct SymTable {
+   /* The number of bindings in symTable. */
    int length;
+
+   /* How the linked lists are reordered when a key is found. */
+   enum SymTable_Organization organization;
+
+   /* The flat arrays, or NULL once the table is promoted. */
+   struct STFlat *flat;
+
+   /* Once promoted: the addresses of the first nodes of each
+      linked list, or NULL while the table is flat. */
+   struct STNode **buckets;
+
+   /* The number of buckets (a power of 2, and 1 for a table that
+      organizes itself), and the number of bits a hash code is
+      shifted right to find its bucket. */
+   size_t numBuckets;
+   int bucketShift;
 };
 
+/* Return a hash code for key, storing the length of key in
+   *keyLength. The bits of the hash code are mixed so that its top
+   byte makes a useful tag, and its top bits a bucket index. */
+static size_t SymTable_hash(const char *key, size_t *keyLength) {
+   assert(key != NULL);
+
+   return (size_t)SymTable_stringHash(key, keyLength);
+}
+
+/* Returns the bucket of promoted symTable for hashCode, given by its
+   top bits (none for a single bucket, since shifting a size_t by
+   its width is undefined). */
+static size_t SymTable_bucketOf(SymTable_T symTable, size_t hashCode) {
+   if (symTable->numBuckets == 1) {
+      return 0;
+   }
+   return hashCode >> symTable->bucketShift;
+}
+
+/* Returns the tag of hashCode, its top byte. */
+static unsigned char SymTable_tag(size_t hashCode) {
+   return (unsigned char)(hashCode >> (sizeof(size_t) * CHAR_BIT - 8));
+}
+
+/* Returns the slot of flat symTable holding key, whose hash code is
+   hashCode and whose length is keyLength, or -1 if there is none. */
+static int SymTable_findSlot(SymTable_T symTable, const char *key,
+                             size_t hashCode, size_t keyLength) {
+   unsigned char tag = SymTable_tag(hashCode);
+   unsigned int matches;
+   int slot, base;
+
+   for (base = 0; base < symTable->length; base += 16) {
+#ifdef __SSE2__
+      /* Comparing tag with 16 tags at once. */
+      matches = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(
+         _mm_set1_epi8((char)tag),
+         _mm_loadu_si128((const __m128i *)(symTable->flat->tags + base))));
+#else
+      matches = 0;
+      for (slot = 0; slot < 16; slot++) {
+         if (symTable->flat->tags[base + slot] == tag) {
+            matches |= 1u << slot;
+         }
+      }
+#endif
+      /* Ignoring the slots past the last binding. */
+      if (symTable->length - base < 16) {
+         matches &= (1u << (symTable->length - base)) - 1;
+      }
+
+      /* Comparing the keys whose tags matched. */
+      while (matches != 0) {
+         slot = base + __builtin_ctz(matches);
+         if (symTable->flat->keyLengths[slot] == keyLength &&
+             memcmp(symTable->flat->keys[slot], key, keyLength) == 0) {
+            return slot;
+         }
+         matches &= matches - 1;
+      }
+   }
+   return -1;
+}
+
+/* Moves the binding in slot from of flat to slot to. */
+static void SymTable_moveSlot(struct STFlat *flat, int from, int to) {
+   flat->tags[to] = flat->tags[from];
+   flat->keyLengths[to] = flat->keyLengths[from];
+   flat->keys[to] = flat->keys[from];
+   flat->values[to] = flat->values[from];
+}
+
+/* Returns the STNode of promoted symTable whose key is key and whose
+   hash code is hashCode, or NULL if there is none. If symTable
+   organizes itself, the STNode found is moved to the front of its
+   list, or one place towards it. */
+static struct STNode *SymTable_findNode(SymTable_T symTable,
+                                        const char *key,
+                                        size_t hashCode) {
+   struct STNode **bucket;
+   struct STNode *currentNode;
+   struct STNode *previousNode = NULL;
+   struct STNode *beforePreviousNode = NULL;
+
+   bucket = &symTable->buckets[SymTable_bucketOf(symTable, hashCode)];
+   for (currentNode = *bucket;
+        currentNode != NULL;
+        currentNode = currentNode->nextNode) {
+
+      if (currentNode->hashCode == hashCode &&
+          strcmp(currentNode->key, key) == 0) {
+         break;
+      }
+      beforePreviousNode = previousNode;
+      previousNode = currentNode;
+   }
+
+   /* Nothing is reordered if the key is missing or already at the
+      front of the list. */
+   if (currentNode == NULL || previousNode == NULL) {
+      return currentNode;
+   }
+
+   if (symTable->organization == SYMTABLE_MOVE_TO_FRONT) {
+      previousNode->nextNode = currentNode->nextNode;
+      currentNode->nextNode = *bucket;
+      *bucket = currentNode;
+   }
+   else if (symTable->organization == SYMTABLE_TRANSPOSE) {
+      previousNode->nextNode = currentNode->nextNode;
+      currentNode->nextNode = previousNode;
+      if (beforePreviousNode == NULL) {
+         *bucket = currentNode;
+      }
+      else {
+         beforePreviousNode->nextNode = currentNode;
+      }
+   }
+   return currentNode;
+}
+
+/* Finds the binding of symTable whose key is key, storing the
+   address of its value in *valueRef. Returns 1 if there is such a
+   binding, or 0 otherwise. */
+static int SymTable_find(SymTable_T symTable, const char *key,
+                         const void ***valueRef) {
+   struct STNode *currentNode;
+   size_t hashCode, keyLength;
+   int slot;
+
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   hashCode = SymTable_hash(key, &keyLength);
+   if (symTable->buckets == NULL) {
+      slot = SymTable_findSlot(symTable, key, hashCode, keyLength);
+      if (slot < 0) {
+         return 0;
+      }
+      *valueRef = &symTable->flat->values[slot];
+      return 1;
+   }
+
+   currentNode = SymTable_findNode(symTable, key, hashCode);
+   if (currentNode == NULL) {
+      return 0;
+   }
+   *valueRef = &currentNode->value;
+   return 1;
+}
+
+/* Doubles the number of buckets of promoted symTable and
+   repositions its STNodes. Leaves symTable unchanged if there is
+   insufficient memory available. */
+static void SymTable_grow(SymTable_T symTable) {
+   struct STNode **newBuckets;
+   struct STNode *currentNode, *nextNode;
+   size_t i, newBucket;
+
+   newBuckets = (struct STNode **)calloc(symTable->numBuckets * 2,
+                                         sizeof(struct STNode *));
+   if (newBuckets == NULL) {
+      return;
+   }
+
+   /* Relinking each STNode into the bucket given by one more bit of
+      its stored hash code. */
+   for (i = 0; i < symTable->numBuckets; i++) {
+      for (currentNode = symTable->buckets[i]; currentNode != NULL;
+           currentNode = nextNode) {
+         nextNode = currentNode->nextNode;
+         newBucket = currentNode->hashCode >> (symTable->bucketShift - 1);
+         currentNode->nextNode = newBuckets[newBucket];
+         newBuckets[newBucket] = currentNode;
+      }
+   }
+
+   free(symTable->buckets);
+   symTable->buckets = newBuckets;
+   symTable->numBuckets *= 2;
+   symTable->bucketShift--;
+}
+
+/* Moves the bindings of flat symTable into STNodes in a new array of
+   linked lists (a single one if symTable organizes itself), and
+   frees its flat arrays. Returns 1, or 0 (leaving symTable flat) if
+   there is insufficient memory available. */
+static int SymTable_promote(SymTable_T symTable) {
+   struct STNode *nodes[FLAT_CAPACITY];
+   struct STNode **buckets;
+   size_t keyLength, numBuckets;
+   int i, bucketBits = 0;
+
+   numBuckets = symTable->organization == SYMTABLE_STATIC ?
+                INITIAL_BUCKETS : 1;
+   buckets = (struct STNode **)calloc(numBuckets,
+                                      sizeof(struct STNode *));
+   if (buckets == NULL) {
+      return 0;
+   }
+
+   /* Allocating all the STNodes before changing anything. */
+   for (i = 0; i < symTable->length; i++) {
+      nodes[i] = (struct STNode *)malloc(sizeof(struct STNode));
+      if (nodes[i] == NULL) {
+         while (i > 0) {
+            free(nodes[--i]);
+         }
+         free(buckets);
+         return 0;
+      }
+   }
+
+   while (((size_t)1 << bucketBits) < numBuckets) {
+      bucketBits++;
+   }
+   symTable->buckets = buckets;
+   symTable->numBuckets = numBuckets;
+   symTable->bucketShift = (int)(sizeof(size_t) * CHAR_BIT) - bucketBits;
+
+   /* The STNodes take over the defensive copies of the keys. */
+   for (i = 0; i < symTable->length; i++) {
+      nodes[i]->key = symTable->flat->keys[i];
+      nodes[i]->value = symTable->flat->values[i];
+      nodes[i]->hashCode = SymTable_hash(symTable->flat->keys[i],
+                                         &keyLength);
+      nodes[i]->nextNode =
+         buckets[SymTable_bucketOf(symTable, nodes[i]->hashCode)];
+      buckets[SymTable_bucketOf(symTable, nodes[i]->hashCode)] = nodes[i];
+   }
+   free(symTable->flat);
+   symTable->flat = NULL;
+   return 1;
+}
+
 /* Returns a new SymTable object that contains no bindings,
    or NULL if there is insufficient memory available. */
 SymTable_T SymTable_new(void) {
@@ -54,38 +334,154 @@ SymTable_T SymTable_new(void) {
    if (symTable == NULL) {
       return NULL;
    }
+   symTable->flat = (struct STFlat *)malloc(sizeof(struct STFlat));
+   if (symTable->flat == NULL) {
+      free(symTable);
+      return NULL;
+   }
 
-   symTable->firstNode = NULL;
    symTable->length = 0;
+   symTable->organization = SYMTABLE_STATIC;
+   symTable->buckets = NULL;
+   symTable->numBuckets = 0;
+   symTable->bucketShift = 0;
    return symTable;
 }
 
+/* Sets how symTable reorders its bindings when SymTable_get,
+   SymTable_contains or SymTable_replace finds a key. Moving found
+   keys to the front suits skewed access patterns, in which a few
+   keys account for most lookups; transposing adapts more slowly but
+   is less disturbed by one-off accesses. A table that organizes
+   itself keeps its bindings, once it outgrows its flat arrays, in a
+   single linked list, so that the order decides how soon each key
+   is found; its buckets are merged into that list here, and grown
+   again when it returns to SYMTABLE_STATIC. Flat tables compare all
+   their tags at once, and are not reordered. */
+void SymTable_setOrganization(SymTable_T symTable,
+                              enum SymTable_Organization organization) {
+   struct STNode **newBuckets;
+   struct STNode *currentNode, *nextNode;
+   size_t i, numBuckets;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   symTable->organization = organization;
+   if (symTable->buckets == NULL) {
+      return;
+   }
+
+   /* Growing the buckets of a static table back along with its
+      bindings, as far as memory allows. */
+   if (organization == SYMTABLE_STATIC) {
+      while ((size_t)symTable->length > symTable->numBuckets) {
+         numBuckets = symTable->numBuckets;
+         SymTable_grow(symTable);
+         if (symTable->numBuckets == numBuckets) {
+            return;
+         }
+      }
+      return;
+   }
+
+   /* Linking the STNodes of every bucket into the first, and
+      shrinking the array to it. */
+   for (i = 1; i < symTable->numBuckets; i++) {
+      for (currentNode = symTable->buckets[i]; currentNode != NULL;
+           currentNode = nextNode) {
+         nextNode = currentNode->nextNode;
+         currentNode->nextNode = symTable->buckets[0];
+         symTable->buckets[0] = currentNode;
+      }
+   }
+   newBuckets = (struct STNode **)realloc(symTable->buckets,
+                                          sizeof(struct STNode *));
+   if (newBuckets != NULL) {
+      symTable->buckets = newBuckets;
+   }
+   symTable->numBuckets = 1;
+   symTable->bucketShift = (int)(sizeof(size_t) * CHAR_BIT);
+}
+
 /* Frees all memory occupied by symTable. */
 void SymTable_free(SymTable_T symTable) {
    struct STNode *currentNode, *temporaryNode;
+   size_t i;
+   int slot;
 
    /* Ensuring that the input parameters are not null. */
    assert(symTable != NULL);
 
-   /* Iterating over all nodes in symTable and
-      freeing memory occupied by defensive copies of
-      keys and by STNodes in symTable. */
-   currentNode = symTable->firstNode;
-   while (currentNode != NULL) {
-
-      if (currentNode->key != NULL) {
-         free((char *)currentNode->key);
+   /* Freeing the defensive copies of the keys, and the flat arrays
+      or (if symTable has been promoted) the STNodes. */
+   if (symTable->buckets == NULL) {
+      for (slot = 0; slot < symTable->length; slot++) {
+         free((char *)symTable->flat->keys[slot]);
       }
-
-      temporaryNode = currentNode;
-      currentNode = currentNode->nextNode;
-      free(temporaryNode);
+      free(symTable->flat);
+   }
+   else {
+      for (i = 0; i < symTable->numBuckets; i++) {
+         currentNode = symTable->buckets[i];
+         while (currentNode != NULL) {
+            free((char *)currentNode->key);
+            temporaryNode = currentNode;
+            currentNode = currentNode->nextNode;
+            free(temporaryNode);
+         }
+      }
+      free(symTable->buckets);
    }
 
    /* Frees symTable structure. */
    free(symTable);
 }
 
+/* Removes every binding from symTable, passing each to freeFunction
+   (if it is not NULL) with extra, so that its value may be released.
+   A promoted symTable keeps its buckets at their present number, so
+   that refilling it does not grow them again. */
+void SymTable_clear(SymTable_T symTable,
+                    void (*freeFunction)
+                    (const char *key, void *value, void *extra),
+                    const void *extra) {
+   struct STNode *currentNode, *temporaryNode;
+   size_t i;
+   int slot;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   if (symTable->buckets == NULL) {
+      for (slot = 0; slot < symTable->length; slot++) {
+         if (freeFunction != NULL) {
+            (*freeFunction)(symTable->flat->keys[slot],
+                            (void *)symTable->flat->values[slot],
+                            (void *)extra);
+         }
+         free((char *)symTable->flat->keys[slot]);
+      }
+   }
+   else {
+      for (i = 0; i < symTable->numBuckets; i++) {
+         currentNode = symTable->buckets[i];
+         symTable->buckets[i] = NULL;
+         while (currentNode != NULL) {
+            if (freeFunction != NULL) {
+               (*freeFunction)(currentNode->key,
+                               (void *)currentNode->value,
+                               (void *)extra);
+            }
+            free((char *)currentNode->key);
+            temporaryNode = currentNode;
+            currentNode = currentNode->nextNode;
+            free(temporaryNode);
+         }
+      }
+   }
+   symTable->length = 0;
+}
+
 /* Returns number of bindings (key-value pairs) in symTable. */
 size_t SymTable_getLength(SymTable_T symTable) {
    /* Ensuring that the input parameters are not null. */
@@ -100,54 +496,85 @@ size_t SymTable_getLength(SymTable_T symTable) {
    of key and value, and returns 1. */
 int SymTable_put(SymTable_T symTable, const char *key,
                  const void *value) {
-
    struct STNode *newNode;
-   struct STNode *currentNode;
+   struct STNode **bucket;
+   char *keyCopy;
+   size_t hashCode, keyLength;
+   int slot;
 
    /* Ensuring that the input parameters are not null. */
    assert(symTable != NULL);
    assert(key != NULL);
 
-   /* Iterating over the linked list of STNodes
-      to check if binding with key already exists. */
-   for (currentNode = (*symTable).firstNode;
-        currentNode != NULL;
-        currentNode = (*currentNode).nextNode) {
-      if (strcmp((*currentNode).key, key) == 0) {
+   /* Checking if binding with key already exists. */
+   hashCode = SymTable_hash(key, &keyLength);
+   if (symTable->buckets == NULL) {
+      if (SymTable_findSlot(symTable, key, hashCode, keyLength) >= 0) {
          return 0;
       }
    }
-
-   /* Dynamically allocating memory for the new node. */
-   newNode = (struct STNode*)malloc(sizeof(struct STNode));
-
-   if (newNode == NULL) {
-      return 0;
+   else {
+      for (newNode = symTable->buckets[SymTable_bucketOf(symTable,
+                                                         hashCode)];
+           newNode != NULL; newNode = newNode->nextNode) {
+         if (newNode->hashCode == hashCode &&
+             strcmp(newNode->key, key) == 0) {
+            return 0;
+         }
+      }
    }
 
    /* Dynamically allocating memory for the defensive
-      copy of the key of the new node. */
-   newNode->key = (const char*)malloc(strlen(key) + 1);
-
-   if (newNode->key == NULL) {
-      free(newNode);
+      copy of the key. */
+   keyCopy = (char *)malloc(keyLength + 1);
+   if (keyCopy == NULL) {
       return 0;
    }
+   memcpy(keyCopy, key, keyLength + 1);
 
-   /* Copying the input key into the key of the newNode
-      (defensive copy). */
-   strcpy((char *)(*newNode).key, key);
-   newNode->value = value;
+   /* Promoting a full flat table to linked lists. */
+   if (symTable->buckets == NULL && symTable->length == FLAT_CAPACITY) {
+      if (!SymTable_promote(symTable)) {
+         free(keyCopy);
+         return 0;
+      }
+   }
 
-   /* Adding the newNode to the beginning of the
-      linked list for that particular bucket. */
-   newNode->nextNode = symTable->firstNode;
-   symTable->firstNode = newNode;
+   if (symTable->buckets == NULL) {
+      /* Adding the binding to the next free slot. */
+      slot = symTable->length;
+      symTable->flat->tags[slot] = SymTable_tag(hashCode);
+      symTable->flat->keyLengths[slot] = keyLength;
+      symTable->flat->keys[slot] = keyCopy;
+      symTable->flat->values[slot] = value;
+   }
+   else {
+      /* Dynamically allocating memory for the new node. */
+      newNode = (struct STNode *)malloc(sizeof(struct STNode));
+      if (newNode == NULL) {
+         free(keyCopy);
+         return 0;
+      }
+      newNode->key = keyCopy;
+      newNode->value = value;
+      newNode->hashCode = hashCode;
+
+      /* Adding the newNode to the beginning of the
+         linked list for that particular bucket. */
+      bucket = &symTable->buckets[SymTable_bucketOf(symTable, hashCode)];
+      newNode->nextNode = *bucket;
+      *bucket = newNode;
+   }
 
-   /* Incrementing the number of bindings if the
-       key is not in symTable and if there is
-       sufficient memory. */
+   /* Incrementing the number of bindings, and keeping the
+      lists short by growing the buckets along with them, unless
+      symTable organizes its single list. */
    symTable->length++;
+   if (symTable->buckets != NULL &&
+       symTable->organization == SYMTABLE_STATIC &&
+       (size_t)symTable->length > symTable->numBuckets) {
+      SymTable_grow(symTable);
+   }
    return 1;
 }
 
@@ -157,28 +584,19 @@ int SymTable_put(SymTable_T symTable, const char *key,
    symTable unchanged and return NULL. */
 void *SymTable_replace(SymTable_T symTable, const char *key,
                        const void *value) {
-   struct STNode *currentNode;
+   const void **valueRef;
    const void *oldValue;
 
    /* Ensuring that the input parameters are not null. */
    assert(symTable != NULL);
    assert(key != NULL);
 
-   /* Iterating over linked list of STNodes to check if
-      binding with input key exists. If so, return
-      corresponding value, and replace it with
-      input value. */
-   for (currentNode = symTable->firstNode;
-        currentNode != NULL;
-        currentNode = currentNode->nextNode) {
-
-      if (strcmp(currentNode->key, key) == 0) {
-
-         oldValue = currentNode->value;
-         currentNode->value = value;
-         return (void *)oldValue;
-
-      }
+   /* Finding the binding with input key. If it exists, return
+      corresponding value, and replace it with input value. */
+   if (SymTable_find(symTable, key, &valueRef)) {
+      oldValue = *valueRef;
+      *valueRef = value;
+      return (void *)oldValue;
    }
 
    /* Else, return NULL. */
@@ -187,49 +605,34 @@ void *SymTable_replace(SymTable_T symTable, const char *key,
 
 /* If symTable contains a binding whose key is input parameter key,
    return 1. Else if there is no binding whose key is input
-   parameter key, return 0. symTable is unchanged. */
+   parameter key, return 0. symTable is unchanged, apart from the
+   order of its bindings if it organizes itself. */
 int SymTable_contains(SymTable_T symTable, const char *key) {
-   struct STNode *currentNode;
+   const void **valueRef;
 
    /* Ensuring that the input parameters are not null. */
    assert(symTable != NULL);
    assert(key != NULL);
 
-   /* Iterating over linked list of STNodes to check if
-      binding with input key exists. If so, return 1. */
-   for (currentNode = symTable->firstNode;
-        currentNode != NULL;
-        currentNode = currentNode->nextNode) {
-
-      if (strcmp(currentNode->key, key) == 0) {
-         return 1;
-      }
-
-   }
-
-   /* Else, return 0. */
-   return 0;
+   /* Finding the binding with input key. If it exists,
+      return 1. Else, return 0. */
+   return SymTable_find(symTable, key, &valueRef);
 }
 
 /* If symTable contains a binding whose key is input parameter key,
-   return corresponding value. Else, return NULL. symTable is unchanged. */
+   return corresponding value. Else, return NULL. symTable is unchanged,
+   apart from the order of its bindings if it organizes itself. */
 void *SymTable_get(SymTable_T symTable, const char *key) {
-   struct STNode *currentNode;
+   const void **valueRef;
 
    /* Ensuring that the input parameters are not null. */
    assert(symTable != NULL);
    assert(key != NULL);
 
-   /* Iterating over linked list of STNodes to check if
-      binding with input key exists. If so, return
-      corresponding value. */
-   for (currentNode = symTable->firstNode;
-        currentNode != NULL;
-        currentNode = currentNode->nextNode) {
-
-      if (strcmp(currentNode->key, key) == 0) {
-         return (void *)currentNode->value;
-      }
+   /* Finding the binding with input key. If it exists,
+      return corresponding value. */
+   if (SymTable_find(symTable, key, &valueRef)) {
+      return (void *)*valueRef;
    }
 
    /* Else, return NULL. */
@@ -240,60 +643,56 @@ void *SymTable_get(SymTable_T symTable, const char *key) {
    binding from symTable and return the binding's value. Else,
    leave symTable unchanged and return NULL. */
 void *SymTable_remove(SymTable_T symTable, const char *key) {
-
-   struct STNode *currentNode = (*symTable).firstNode;
-   struct STNode *previousNode;
-   struct STNode *temporaryNode;
+   struct STNode **nodeRef;
+   struct STNode *currentNode;
+   size_t hashCode, keyLength;
    void *value;
+   int slot, last;
 
    /* Ensuring that the input parameters are not null. */
    assert(symTable != NULL);
    assert(key != NULL);
 
-   /* If symTable is empty, return NULL. */
-   if (currentNode == NULL) {
-      return NULL;
-   }
+   hashCode = SymTable_hash(key, &keyLength);
+   if (symTable->buckets == NULL) {
+      /* If key is not present in symbol table. */
+      slot = SymTable_findSlot(symTable, key, hashCode, keyLength);
+      if (slot < 0) {
+         return NULL;
+      }
 
-   /* If firstNode contains key, removing the node, returning the
-      value, and setting the first node parameter of the symTable
-      to the next node. */
-   if (strcmp(currentNode->key, key) == 0) {
-      temporaryNode = currentNode;
-      value = (void *)temporaryNode->value;
-      symTable->firstNode = temporaryNode->nextNode;
+      /* Freeing the key, and moving the last binding into the
+         slot it leaves. */
+      value = (void *)symTable->flat->values[slot];
+      free((char *)symTable->flat->keys[slot]);
+      last = symTable->length - 1;
+      SymTable_moveSlot(symTable->flat, last, slot);
    }
-
-/* If symTable is not empty, and the firstNode does not contain
-      the key, traversing the list while key is not found and end
-      of the symTable is not reached. */
    else {
-      while (currentNode != NULL &&
-             (strcmp((*currentNode).key, key) != 0)) {
-         previousNode = currentNode;
-         currentNode = (*currentNode).nextNode;
+      /* Traversing the list while key is not found and end of
+         the list is not reached. */
+      nodeRef = &symTable->buckets[SymTable_bucketOf(symTable, hashCode)];
+      while (*nodeRef != NULL &&
+             ((*nodeRef)->hashCode != hashCode ||
+              strcmp((*nodeRef)->key, key) != 0)) {
+         nodeRef = &(*nodeRef)->nextNode;
       }
 
       /* If key is not present in symbol table. */
-      if (currentNode == NULL) {
+      if (*nodeRef == NULL) {
          return NULL;
       }
 
-      /* Freeing the currentNode and its key. */
-      temporaryNode = currentNode;
-
-      /* Assigning the value to be returned to the
-         value of the currentNode, and the next node for
-         currentNode to be the next node for its
-         previous node. */
-      value = (void *)temporaryNode->value;
-      free((char *)temporaryNode->key);
-      previousNode->nextNode = temporaryNode->nextNode;
-      free(temporaryNode);
+      /* Unlinking the node, and freeing it and its key. */
+      currentNode = *nodeRef;
+      value = (void *)currentNode->value;
+      *nodeRef = currentNode->nextNode;
+      free((char *)currentNode->key);
+      free(currentNode);
    }
 
    /* Decrementing the number of bindings in symTable. */
-   (*symTable).length--;
+   symTable->length--;
    return value;
 }
 
@@ -308,20 +707,156 @@ void SymTable_map(SymTable_T symTable, void (*functionApply)
                   const void *extra) {
 
    struct STNode *currentNode;
+   size_t i;
+   int slot;
 
    /* Ensuring that the input parameters are not null. */
    assert(symTable != NULL);
    assert(functionApply != NULL);
 
-   /* Iterating over all nodes in symTable and
+   /* Iterating over all bindings in symTable and
       applying the function to each key-value
       pair. */
-   for (currentNode = (*symTable).firstNode;
-        currentNode != NULL;
-        currentNode = (*currentNode).nextNode) {
+   if (symTable->buckets == NULL) {
+      for (slot = 0; slot < symTable->length; slot++) {
+         (*functionApply)(symTable->flat->keys[slot],
+                          (void *)symTable->flat->values[slot],
+                          (void *)extra);
+      }
+      return;
+   }
+
+   for (i = 0; i < symTable->numBuckets; i++) {
+      for (currentNode = symTable->buckets[i];
+           currentNode != NULL;
+           currentNode = (*currentNode).nextNode) {
+
+         (*functionApply)((const char*)(*currentNode).key,
+                          (void*)(*currentNode).value,
+                          (void*)extra);
+      }
+   }
+}
+
+/* Removes from symTable every binding for which
+   (*predicate)(key, value, extra) returns nonzero, passing each to
+   removeFunction (if it is not NULL) with extra, so that its value
+   may be released. The bindings are visited once, each being
+   unlinked as it is found. predicate must not change symTable.
+   Returns the number of bindings removed. */
+size_t SymTable_removeIf(SymTable_T symTable,
+                         int (*predicate)
+                         (const char *key, void *value, void *extra),
+                         void (*removeFunction)
+                         (const char *key, void *value, void *extra),
+                         const void *extra) {
+   struct STNode **nodeRef;
+   struct STNode *currentNode;
+   size_t i, numRemoved = 0;
+   int slot, last;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(predicate != NULL);
+
+   if (symTable->buckets == NULL) {
+      /* Moving the last binding into the slot of each binding
+         removed, and testing that slot again. */
+      slot = 0;
+      while (slot < symTable->length) {
+         if (!(*predicate)(symTable->flat->keys[slot],
+                           (void *)symTable->flat->values[slot],
+                           (void *)extra)) {
+            slot++;
+            continue;
+         }
+         if (removeFunction != NULL) {
+            (*removeFunction)(symTable->flat->keys[slot],
+                              (void *)symTable->flat->values[slot],
+                              (void *)extra);
+         }
+         free((char *)symTable->flat->keys[slot]);
+         last = --symTable->length;
+         SymTable_moveSlot(symTable->flat, last, slot);
+         numRemoved++;
+      }
+      return numRemoved;
+   }
+
+   for (i = 0; i < symTable->numBuckets; i++) {
+      nodeRef = &symTable->buckets[i];
+      while (*nodeRef != NULL) {
+         currentNode = *nodeRef;
+         if (!(*predicate)(currentNode->key, (void *)currentNode->value,
+                           (void *)extra)) {
+            nodeRef = &currentNode->nextNode;
+            continue;
+         }
+
+         /* Unlinking the node, and freeing it and its key. */
+         *nodeRef = currentNode->nextNode;
+         if (removeFunction != NULL) {
+            (*removeFunction)(currentNode->key,
+                              (void *)currentNode->value,
+                              (void *)extra);
+         }
+         free((char *)currentNode->key);
+         free(currentNode);
+         symTable->length--;
+         numRemoved++;
+      }
+   }
+   return numRemoved;
+}
+
+/* Returns the number of bytes of memory held by symTable, and fills
+   in *usage (unless usage is NULL) with those bytes split into
+   STNodes, keys, the buckets or the flat arrays together with the
+   SymTable structure, and allocator overhead. */
+size_t SymTable_memoryUsage(SymTable_T symTable,
+                            struct SymTable_MemoryUsage *usage) {
+   struct SymTable_MemoryUsage localUsage;
+   struct STNode *currentNode;
+   size_t i;
+   int slot;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
 
-      (*functionApply)((const char*)(*currentNode).key,
-                       (void*)(*currentNode).value,
-                       (void*)extra);
+   if (usage == NULL) {
+      usage = &localUsage;
    }
+   memset(usage, 0, sizeof(*usage));
+   usage->bucketBytes += SymTable_blockBytes
+      (symTable, sizeof(struct SymTable), &usage->overheadBytes);
+
+   if (symTable->buckets == NULL) {
+      for (slot = 0; slot < symTable->length; slot++) {
+         usage->keyBytes += SymTable_blockBytes
+            (symTable->flat->keys[slot],
+             symTable->flat->keyLengths[slot] + 1, &usage->overheadBytes);
+      }
+      usage->bucketBytes += SymTable_blockBytes
+         (symTable->flat, sizeof(struct STFlat), &usage->overheadBytes);
+   }
+   else {
+      usage->bucketBytes += SymTable_blockBytes
+         (symTable->buckets, symTable->numBuckets *
+          sizeof(struct STNode *), &usage->overheadBytes);
+      for (i = 0; i < symTable->numBuckets; i++) {
+         for (currentNode = symTable->buckets[i]; currentNode != NULL;
+              currentNode = currentNode->nextNode) {
+            usage->nodeBytes += SymTable_blockBytes
+               (currentNode, sizeof(struct STNode),
+                &usage->overheadBytes);
+            usage->keyBytes += SymTable_blockBytes
+               (currentNode->key, strlen(currentNode->key) + 1,
+                &usage->overheadBytes);
+         }
+      }
+   }
+
+   usage->totalBytes = usage->nodeBytes + usage->keyBytes +
+                       usage->bucketBytes + usage->overheadBytes;
+   return usage->totalBytes;
 }
@@ -0,0 +1,41 @@
+#ifndef SYMTABLELIST_INCLUDED
+#define SYMTABLELIST_INCLUDED
+
+#include "symtable.h"
+
+/* Extensions of the SymTable interface, provided by the linked list
+   implementation (symtablelist.c). */
+
+/* The ways in which a SymTable may reorder its bindings when
+   SymTable_get, SymTable_contains or SymTable_replace finds a key. A
+   table that reorders itself keeps more than 32 bindings in a single
+   linked list rather than in hashed buckets, so that a key is found
+   in time proportional to its place in the list; up to 32 bindings
+   are searched all at once, and not reordered. */
+enum SymTable_Organization {
+   /* Bindings stay in insertion order (the default). */
+   SYMTABLE_STATIC,
+
+   /* The binding found moves to the front of the list. */
+   SYMTABLE_MOVE_TO_FRONT,
+
+   /* The binding found swaps places with the one before it. */
+   SYMTABLE_TRANSPOSE
+};
+
+void SymTable_setOrganization(SymTable_T symTable,
+                              enum SymTable_Organization organization);
+
+void SymTable_clear(SymTable_T symTable,
+                    void (*freeFunction)
+                    (const char *key, void *value, void *extra),
+                    const void *extra);
+
+size_t SymTable_removeIf(SymTable_T symTable,
+                         int (*predicate)
+                         (const char *key, void *value, void *extra),
+                         void (*removeFunction)
+                         (const char *key, void *value, void *extra),
+                         const void *extra);
+
+#endif
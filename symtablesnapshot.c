@@ -0,0 +1,218 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: symtablesnapshot.c
+ *
+ *  Description: Writes snapshots of SymTables in the background. The
+ *  process forks, and the child walks its copy of the table with
+ *  SymTable_map and writes it out, while the parent returns at once.
+ *  The pages of the two processes are shared until the parent
+ *  changes one, which the kernel then copies, so that the child sees
+ *  a consistent table without the parent pausing for the walk. The
+ *  child writes to a temporary file beside the snapshot and renames
+ *  it over the snapshot once it is synced, so that a reader finds
+ *  either the old snapshot or the new one, never a partial one. The
+ *  child neither allocates memory nor uses stdio, whose locks another
+ *  thread of the parent may have held at the fork.
+ ******************************************************************* */
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "symtablesnapshot.h"
+
+/* Declaring an enum to hold the number of bytes the child gathers
+   before each write, and the most bytes a temporary file name adds
+   to the snapshot's. */
+enum{WRITE_BUFFER_SIZE = 65536, TEMP_SUFFIX_LENGTH = 64};
+
+/* The state of the child as it writes a snapshot. */
+struct STSnapshot {
+   /* The temporary file, and whether a write to it has failed. */
+   int fd;
+   int hasFailed;
+
+   /* The function giving the bytes of a value, and its extra
+      parameter. */
+   const void *(*valueBytes)(const void *value, size_t *length,
+                             void *extra);
+   void *extra;
+
+   /* The bytes not yet written, and their number. */
+   size_t numBuffered;
+   char buffer[WRITE_BUFFER_SIZE];
+};
+
+/* The snapshot being written, in the child. It is static rather
+   than on the stack, which may be a small one of a thread. */
+static struct STSnapshot snapshot;
+
+/* The number of snapshots started, which tells apart the temporary
+   files of snapshots being written at once. */
+static unsigned long numSnapshots;
+
+/* Writes the length bytes at bytes to fd. Returns 1, or 0 if a write
+   fails. */
+static int SymTable_writeAll(int fd, const char *bytes, size_t length) {
+   ssize_t numWritten;
+
+   while (length > 0) {
+      numWritten = write(fd, bytes, length);
+      if (numWritten < 0) {
+         if (errno == EINTR) {
+            continue;
+         }
+         return 0;
+      }
+      bytes += numWritten;
+      length -= (size_t)numWritten;
+   }
+   return 1;
+}
+
+/* Adds the length bytes at bytes to the file of *state, through its
+   buffer, recording in it whether a write fails. */
+static void SymTable_emit(struct STSnapshot *state, const void *bytes,
+                          size_t length) {
+   assert(state != NULL);
+
+   if (state->hasFailed) {
+      return;
+   }
+   if (state->numBuffered + length > WRITE_BUFFER_SIZE) {
+      if (!SymTable_writeAll(state->fd, state->buffer,
+                             state->numBuffered)) {
+         state->hasFailed = 1;
+         return;
+      }
+      state->numBuffered = 0;
+   }
+   if (length > WRITE_BUFFER_SIZE) {
+      if (!SymTable_writeAll(state->fd, (const char *)bytes, length)) {
+         state->hasFailed = 1;
+      }
+      return;
+   }
+   memcpy(state->buffer + state->numBuffered, bytes, length);
+   state->numBuffered += length;
+}
+
+/* Adds the record of the binding of key and value to the snapshot
+   *extra. */
+static void SymTable_emitBinding(const char *key, void *value,
+                                 void *extra) {
+   struct STSnapshot *state = (struct STSnapshot *)extra;
+   const void *bytes = NULL;
+   size_t length = 0;
+   uint32_t length32;
+
+   assert(key != NULL);
+   assert(state != NULL);
+
+   length32 = (uint32_t)strlen(key);
+   SymTable_emit(state, &length32, sizeof(length32));
+   SymTable_emit(state, key, length32);
+
+   if (state->valueBytes != NULL) {
+      bytes = (*state->valueBytes)(value, &length, state->extra);
+   }
+   if (bytes == NULL || length > UINT32_MAX) {
+      length = 0;
+   }
+   length32 = (uint32_t)length;
+   SymTable_emit(state, &length32, sizeof(length32));
+   if (length > 0) {
+      SymTable_emit(state, bytes, length);
+   }
+}
+
+/* Writes the snapshot of symTable to the file tempPath, and renames
+   it to path. Runs in the child, and ends it, with status 0 if the
+   snapshot was written or 1 otherwise. */
+static void SymTable_writeSnapshot(SymTable_T symTable, const char *path,
+                                   const char *tempPath,
+                                   const void *(*valueBytes)
+                                   (const void *value, size_t *length,
+                                    void *extra),
+                                   const void *extra) {
+   struct STSnapshot *state = &snapshot;
+
+   state->fd = open(tempPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+   if (state->fd < 0) {
+      _exit(1);
+   }
+   state->hasFailed = 0;
+   state->valueBytes = valueBytes;
+   state->extra = (void *)extra;
+   state->numBuffered = 0;
+
+   SymTable_emit(state, "SYMSNAP1", 8);
+   SymTable_map(symTable, SymTable_emitBinding, state);
+   if (!state->hasFailed &&
+       SymTable_writeAll(state->fd, state->buffer, state->numBuffered) &&
+       fsync(state->fd) == 0 && close(state->fd) == 0 &&
+       rename(tempPath, path) == 0) {
+      _exit(0);
+   }
+   (void)unlink(tempPath);
+   _exit(1);
+}
+
+/* Starts writing a snapshot of symTable to the file path, storing
+   for each value the bytes that (*valueBytes)(value, &length, extra)
+   returns (or none if valueBytes is NULL). The snapshot holds the
+   bindings of symTable at the time of the call. Returns the process
+   ID of the child writing it, or -1 if it cannot be started. */
+pid_t SymTable_snapshotAsync(SymTable_T symTable, const char *path,
+                             const void *(*valueBytes)
+                             (const void *value, size_t *length,
+                              void *extra),
+                             const void *extra) {
+   char *tempPath;
+   size_t length;
+   pid_t pid;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(path != NULL);
+
+   /* Naming the temporary file before forking, so that the child
+      need not allocate memory. */
+   length = strlen(path) + TEMP_SUFFIX_LENGTH;
+   tempPath = (char *)malloc(length);
+   if (tempPath == NULL) {
+      return -1;
+   }
+   (void)snprintf(tempPath, length, "%s.tmp.%ld.%lu", path,
+                  (long)getpid(), numSnapshots++);
+
+   pid = fork();
+   if (pid == 0) {
+      SymTable_writeSnapshot(symTable, path, tempPath, valueBytes,
+                             extra);
+   }
+   free(tempPath);
+   return pid;
+}
+
+/* Waits for the child pid, started by SymTable_snapshotAsync, to
+   finish. Returns 1 if it wrote its snapshot, or 0 otherwise. */
+int SymTable_snapshotWait(pid_t pid) {
+   int status;
+
+   assert(pid > 0);
+
+   while (waitpid(pid, &status, 0) < 0) {
+      if (errno != EINTR) {
+         return 0;
+      }
+   }
+   return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
@@ -0,0 +1,29 @@
+#ifndef SYMTABLESNAPSHOT_INCLUDED
+#define SYMTABLESNAPSHOT_INCLUDED
+
+#include <stddef.h>
+#include <sys/types.h>
+#include "symtable.h"
+
+/* SymTable_snapshotAsync writes a snapshot of a SymTable to a file
+   from a child process, which sees the table as it was when the
+   snapshot was asked for while the caller goes on changing it.
+   valueBytes (which may be NULL, to store keys only) gives the bytes
+   to store for a value, and their number in *length. The file
+   begins with the 8 bytes "SYMSNAP1", followed by a record per
+   binding: the key's length as a uint32_t, its bytes, the value's
+   length as a uint32_t and its bytes, in the byte order of the
+   host. It replaces the file at path only once it is complete.
+   SymTable_snapshotAsync returns the child's process ID, or -1 if it
+   cannot be started; SymTable_snapshotWait waits for the child, and
+   returns 1 if the snapshot was written, or 0 otherwise. */
+
+pid_t SymTable_snapshotAsync(SymTable_T symTable, const char *path,
+                             const void *(*valueBytes)
+                             (const void *value, size_t *length,
+                              void *extra),
+                             const void *extra);
+
+int SymTable_snapshotWait(pid_t pid);
+
+#endif
@@ -0,0 +1,701 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: symtablespill.c
+ *
+ *  Description: Implements a SymTableSpill data type, a SymTable
+ *  whose bindings are kept in a file and only partly in memory, so
+ *  that it may hold more bindings than fit in memory. The bindings
+ *  are stored in fixed-size pages of an extendible hash table: an
+ *  in-memory directory, indexed by the low bits of the hash code of
+ *  a key, gives the page holding the key, and a page that overflows
+ *  is split in two on one more bit of the hash code (doubling the
+ *  directory if needed), so that no page ever needs more than one
+ *  read. The most recently used pages are cached in a fixed number
+ *  of frames, sized by the memory budget of the symbol table, and a
+ *  changed page is written back to the file when its frame is
+ *  needed for another page.
+ ******************************************************************* */
+#define _POSIX_C_SOURCE 200809L
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "symtablespill.h"
+#include "symtableutil.h"
+
+/* Declaring an enum to hold the size of a page in bytes, the size of
+   the header of a page (its local depth, its number of records and
+   the number of bytes it uses, each a 32-bit integer), the size of
+   the header of a record (the lengths of its key and value), and the
+   largest global depth of the directory. */
+enum{PAGE_BYTES = 4096, PAGE_HEADER_BYTES = 12, RECORD_HEADER_BYTES = 8,
+     MAX_DEPTH = 30};
+
+/* Declaring an enum to hold the offsets of the fields of the header
+   of a page. */
+enum{LOCAL_DEPTH = 0, NUM_RECORDS = 4, USED_BYTES = 8};
+
+/* Declaring an enum to hold the frame index standing for no frame,
+   and the page number of an STFrame holding no page. */
+enum{NO_FRAME = -1};
+#define NO_PAGE UINT32_MAX
+
+/* An STFrame caches one page of the file in memory. STFrames are
+   linked, from the most to the least recently used, to choose the
+   STFrame whose page is replaced when another page is needed. */
+struct STFrame {
+   /* The number of the page held (or NO_PAGE), and whether it has
+      changed since it was read from the file. */
+   uint32_t page;
+   int dirty;
+
+   /* The indices of the STFrames used just after and just before
+      this one, or NO_FRAME. */
+   int newer;
+   int older;
+
+   /* The bytes of the page. */
+   unsigned char data[PAGE_BYTES];
+};
+
+/* A SymTableSpill structure is a 'manager' structure that contains
+   the file of pages, the directory, and the cache of pages. */
+struct SymTableSpill {
+   /* The file descriptor of the (already unlinked) file of pages, and
+      the number of pages in use in it. */
+   int fd;
+   uint32_t numPages;
+
+   /* The directory, holding 2^globalDepth page numbers. */
+   uint32_t *directory;
+   int globalDepth;
+
+   /* The STFrames, the number of them, and the number ever used. */
+   struct STFrame *frames;
+   int numFrames;
+   int numFramesUsed;
+
+   /* The most and least recently used STFrames, or NO_FRAME. */
+   int newest;
+   int oldest;
+
+   /* The index of the STFrame holding each page, or NO_FRAME, and the
+      number of pages this array has room for. */
+   int *frameOfPage;
+   size_t pageCapacity;
+
+   /* The number of bindings (key-value pairs) presently in the
+      symbol table. */
+   size_t numBindings;
+};
+
+/* Returns the 32-bit integer stored at bytes. */
+static uint32_t SymTableSpill_getU32(const unsigned char *bytes) {
+   uint32_t value;
+
+   memcpy(&value, bytes, sizeof(value));
+   return value;
+}
+
+/* Stores the 32-bit integer value at bytes. */
+static void SymTableSpill_setU32(unsigned char *bytes, uint32_t value) {
+   memcpy(bytes, &value, sizeof(value));
+}
+
+/* Returns a hash code for key, the low bits of which index the
+   directory. */
+static uint64_t SymTableSpill_hash(const char *key) {
+   return SymTable_stringHash(key, NULL);
+}
+
+/* Returns the number of bytes of a record with a key of keyLength
+   bytes (not counting its null byte) and a value of valueLength
+   bytes. */
+static size_t SymTableSpill_recordBytes(size_t keyLength,
+                                        size_t valueLength) {
+   return RECORD_HEADER_BYTES + keyLength + 1 + valueLength;
+}
+
+/* Returns the number of bytes of the record at offset in data. */
+static size_t SymTableSpill_recordAt(const unsigned char *data,
+                                     size_t offset) {
+   return SymTableSpill_recordBytes
+      (SymTableSpill_getU32(data + offset),
+       SymTableSpill_getU32(data + offset + 4));
+}
+
+/* Unlinks STFrame frame from the list of STFrames of symTable. */
+static void SymTableSpill_unlinkFrame(SymTableSpill_T symTable,
+                                      int frame) {
+   struct STFrame *current = &symTable->frames[frame];
+
+   if (current->newer != NO_FRAME) {
+      symTable->frames[current->newer].older = current->older;
+   }
+   else {
+      symTable->newest = current->older;
+   }
+   if (current->older != NO_FRAME) {
+      symTable->frames[current->older].newer = current->newer;
+   }
+   else {
+      symTable->oldest = current->newer;
+   }
+}
+
+/* Links STFrame frame into the list of STFrames of symTable as the
+   most recently used. */
+static void SymTableSpill_linkNewest(SymTableSpill_T symTable,
+                                     int frame) {
+   symTable->frames[frame].newer = NO_FRAME;
+   symTable->frames[frame].older = symTable->newest;
+   if (symTable->newest != NO_FRAME) {
+      symTable->frames[symTable->newest].newer = frame;
+   }
+   else {
+      symTable->oldest = frame;
+   }
+   symTable->newest = frame;
+}
+
+/* Writes the page held in STFrame frame of symTable to the file if
+   it has changed. Returns 1, or 0 if the write fails. */
+static int SymTableSpill_writeBack(SymTableSpill_T symTable, int frame) {
+   struct STFrame *current = &symTable->frames[frame];
+
+   if (!current->dirty) {
+      return 1;
+   }
+   if (pwrite(symTable->fd, current->data, PAGE_BYTES,
+              (off_t)current->page * PAGE_BYTES) != PAGE_BYTES) {
+      return 0;
+   }
+   current->dirty = 0;
+   return 1;
+}
+
+/* Returns the address of the bytes of page of symTable, reading it
+   into an STFrame (writing back the page held there first) if it is
+   not cached. If isNew is nonzero, the page is instead cleared and
+   marked as changed. The address remains valid until the next call.
+   Returns NULL if reading or writing the file fails. */
+static unsigned char *SymTableSpill_fetch(SymTableSpill_T symTable,
+                                          uint32_t page, int isNew) {
+   int frame = symTable->frameOfPage[page];
+
+   if (frame == NO_FRAME) {
+      /* Choosing an unused STFrame, or else the least recently used,
+         whose page is written back and forgotten. */
+      if (symTable->numFramesUsed < symTable->numFrames) {
+         frame = symTable->numFramesUsed++;
+      }
+      else {
+         frame = symTable->oldest;
+         if (!SymTableSpill_writeBack(symTable, frame)) {
+            return NULL;
+         }
+         if (symTable->frames[frame].page != NO_PAGE) {
+            symTable->frameOfPage[symTable->frames[frame].page] =
+               NO_FRAME;
+         }
+         SymTableSpill_unlinkFrame(symTable, frame);
+      }
+
+      /* Reading the page, leaving the STFrame holding no page if the
+         read fails. */
+      symTable->frames[frame].page = NO_PAGE;
+      symTable->frames[frame].dirty = 0;
+      if (!isNew &&
+          pread(symTable->fd, symTable->frames[frame].data, PAGE_BYTES,
+                (off_t)page * PAGE_BYTES) != PAGE_BYTES) {
+         SymTableSpill_linkNewest(symTable, frame);
+         return NULL;
+      }
+      symTable->frames[frame].page = page;
+      symTable->frameOfPage[page] = frame;
+   }
+   else {
+      SymTableSpill_unlinkFrame(symTable, frame);
+   }
+   SymTableSpill_linkNewest(symTable, frame);
+
+   if (isNew) {
+      memset(symTable->frames[frame].data, 0, PAGE_BYTES);
+      symTable->frames[frame].dirty = 1;
+   }
+   return symTable->frames[frame].data;
+}
+
+/* Marks the page of symTable last returned by SymTableSpill_fetch as
+   changed. */
+static void SymTableSpill_markDirty(SymTableSpill_T symTable) {
+   symTable->frames[symTable->newest].dirty = 1;
+}
+
+/* Returns the offset in data of the record with the keyLength-byte
+   key, or 0 if the page holds none. */
+static size_t SymTableSpill_findRecord(const unsigned char *data,
+                                       const char *key,
+                                       size_t keyLength) {
+   size_t offset = PAGE_HEADER_BYTES;
+   size_t end = SymTableSpill_getU32(data + USED_BYTES);
+
+   while (offset < end) {
+      if (SymTableSpill_getU32(data + offset) == keyLength &&
+          memcmp(data + offset + RECORD_HEADER_BYTES, key,
+                 keyLength) == 0) {
+         return offset;
+      }
+      offset += SymTableSpill_recordAt(data, offset);
+   }
+   return 0;
+}
+
+/* Appends a record of key (of keyLength bytes) and the valueLength
+   bytes of value to data, which must have room for it. */
+static void SymTableSpill_appendRecord(unsigned char *data,
+                                       const char *key, size_t keyLength,
+                                       const void *value,
+                                       size_t valueLength) {
+   size_t offset = SymTableSpill_getU32(data + USED_BYTES);
+
+   SymTableSpill_setU32(data + offset, (uint32_t)keyLength);
+   SymTableSpill_setU32(data + offset + 4, (uint32_t)valueLength);
+   memcpy(data + offset + RECORD_HEADER_BYTES, key, keyLength + 1);
+   if (valueLength > 0) {
+      memcpy(data + offset + RECORD_HEADER_BYTES + keyLength + 1, value,
+             valueLength);
+   }
+   SymTableSpill_setU32(data + NUM_RECORDS,
+                        SymTableSpill_getU32(data + NUM_RECORDS) + 1);
+   SymTableSpill_setU32(data + USED_BYTES, (uint32_t)
+                        (offset + SymTableSpill_recordBytes
+                         (keyLength, valueLength)));
+}
+
+/* Removes the record at offset from data. */
+static void SymTableSpill_deleteRecord(unsigned char *data,
+                                       size_t offset) {
+   size_t recordBytes = SymTableSpill_recordAt(data, offset);
+   size_t used = SymTableSpill_getU32(data + USED_BYTES);
+
+   memmove(data + offset, data + offset + recordBytes,
+           used - offset - recordBytes);
+   SymTableSpill_setU32(data + NUM_RECORDS,
+                        SymTableSpill_getU32(data + NUM_RECORDS) - 1);
+   SymTableSpill_setU32(data + USED_BYTES, (uint32_t)(used - recordBytes));
+}
+
+/* Copies into newPage the records of oldData whose hash codes have
+   the given bit equal to bitValue, as a page of localDepth. */
+static void SymTableSpill_copyRecords(unsigned char *newPage,
+                                      const unsigned char *oldData,
+                                      int bit, int bitValue,
+                                      int localDepth) {
+   size_t offset = PAGE_HEADER_BYTES;
+   size_t end = SymTableSpill_getU32(oldData + USED_BYTES);
+   size_t keyLength, valueLength;
+   const char *key;
+
+   memset(newPage, 0, PAGE_HEADER_BYTES);
+   SymTableSpill_setU32(newPage + LOCAL_DEPTH, (uint32_t)localDepth);
+   SymTableSpill_setU32(newPage + USED_BYTES, PAGE_HEADER_BYTES);
+   while (offset < end) {
+      keyLength = SymTableSpill_getU32(oldData + offset);
+      valueLength = SymTableSpill_getU32(oldData + offset + 4);
+      key = (const char *)oldData + offset + RECORD_HEADER_BYTES;
+      if ((int)((SymTableSpill_hash(key) >> bit) & 1) ==
+          bitValue) {
+         SymTableSpill_appendRecord(newPage, key, keyLength,
+                                    key + keyLength + 1, valueLength);
+      }
+      offset += SymTableSpill_recordBytes(keyLength, valueLength);
+   }
+}
+
+/* Splits page of symTable in two on the next bit of the hash codes of
+   its keys, doubling the directory first if the page is referred to
+   by a single entry. Returns 1, or 0 (leaving the bindings of
+   symTable unchanged) if the directory cannot grow or if there is
+   insufficient memory available or if reading or writing the file
+   fails. */
+static int SymTableSpill_split(SymTableSpill_T symTable, uint32_t page) {
+   unsigned char oldData[PAGE_BYTES];
+   unsigned char *data;
+   uint32_t *newDirectory;
+   int *newFrameOfPage;
+   uint32_t newPage;
+   size_t i, numEntries;
+   int localDepth;
+
+   data = SymTableSpill_fetch(symTable, page, 0);
+   if (data == NULL) {
+      return 0;
+   }
+   memcpy(oldData, data, PAGE_BYTES);
+   localDepth = (int)SymTableSpill_getU32(oldData + LOCAL_DEPTH);
+
+   /* Doubling the directory, each entry of the new half referring to
+      the same page as the corresponding entry of the old half. */
+   numEntries = (size_t)1 << symTable->globalDepth;
+   if (localDepth == symTable->globalDepth) {
+      if (symTable->globalDepth == MAX_DEPTH) {
+         return 0;
+      }
+      newDirectory = (uint32_t *)realloc(symTable->directory,
+                                         2 * numEntries *
+                                         sizeof(uint32_t));
+      if (newDirectory == NULL) {
+         return 0;
+      }
+      memcpy(newDirectory + numEntries, newDirectory,
+             numEntries * sizeof(uint32_t));
+      symTable->directory = newDirectory;
+      symTable->globalDepth++;
+      numEntries *= 2;
+   }
+
+   /* Making room for the new page in the array of STFrame indices. */
+   newPage = symTable->numPages;
+   if (newPage == symTable->pageCapacity) {
+      newFrameOfPage = (int *)realloc(symTable->frameOfPage,
+                                      2 * symTable->pageCapacity *
+                                      sizeof(int));
+      if (newFrameOfPage == NULL) {
+         return 0;
+      }
+      for (i = symTable->pageCapacity; i < 2 * symTable->pageCapacity;
+           i++) {
+         newFrameOfPage[i] = NO_FRAME;
+      }
+      symTable->frameOfPage = newFrameOfPage;
+      symTable->pageCapacity *= 2;
+   }
+
+   /* Filling the new page with the records whose next bit is 1, then
+      rewriting the old page with the rest. The new page is not
+      counted (so it is reused) unless both succeed. */
+   data = SymTableSpill_fetch(symTable, newPage, 1);
+   if (data == NULL) {
+      return 0;
+   }
+   SymTableSpill_copyRecords(data, oldData, localDepth, 1,
+                             localDepth + 1);
+   data = SymTableSpill_fetch(symTable, page, 0);
+   if (data == NULL) {
+      return 0;
+   }
+   SymTableSpill_copyRecords(data, oldData, localDepth, 0,
+                             localDepth + 1);
+   SymTableSpill_markDirty(symTable);
+   symTable->numPages++;
+
+   /* Pointing the entries of the directory for the records whose next
+      bit is 1 to the new page. */
+   for (i = 0; i < numEntries; i++) {
+      if (symTable->directory[i] == page && ((i >> localDepth) & 1)) {
+         symTable->directory[i] = newPage;
+      }
+   }
+   return 1;
+}
+
+/* Stores a binding of key and the valueLength bytes of value in
+   symTable, splitting pages until the page for key has room. If
+   replacing is 0, a binding with key must not exist; otherwise it
+   must, and is overwritten. Returns 1, or 0 (leaving symTable's
+   bindings unchanged) if that condition fails, if the binding cannot
+   fit in a page, if there is insufficient memory available, or if
+   reading or writing the file fails. */
+static int SymTableSpill_store(SymTableSpill_T symTable, const char *key,
+                               const void *value, size_t valueLength,
+                               int replacing) {
+   unsigned char *data;
+   size_t keyLength, recordBytes, oldBytes, offset;
+   uint64_t hashCode;
+   uint32_t page;
+
+   keyLength = strlen(key);
+   recordBytes = SymTableSpill_recordBytes(keyLength, valueLength);
+   if (recordBytes > PAGE_BYTES - PAGE_HEADER_BYTES) {
+      return 0;
+   }
+   hashCode = SymTableSpill_hash(key);
+
+   for (;;) {
+      page = symTable->directory[hashCode &
+                                 (((uint64_t)1 << symTable->globalDepth)
+                                  - 1)];
+      data = SymTableSpill_fetch(symTable, page, 0);
+      if (data == NULL) {
+         return 0;
+      }
+      offset = SymTableSpill_findRecord(data, key, keyLength);
+      if ((offset != 0) != (replacing != 0)) {
+         return 0;
+      }
+
+      oldBytes = offset != 0 ? SymTableSpill_recordAt(data, offset) : 0;
+      if (SymTableSpill_getU32(data + USED_BYTES) - oldBytes +
+          recordBytes <= PAGE_BYTES) {
+         if (offset != 0) {
+            SymTableSpill_deleteRecord(data, offset);
+         }
+         SymTableSpill_appendRecord(data, key, keyLength, value,
+                                    valueLength);
+         SymTableSpill_markDirty(symTable);
+         return 1;
+      }
+
+      if (!SymTableSpill_split(symTable, page)) {
+         return 0;
+      }
+   }
+}
+
+/* Returns the address of the bytes of the page of symTable that
+   should hold key, storing in *offset the offset of the record of
+   key in it (or 0), or NULL if reading or writing the file fails. */
+static unsigned char *SymTableSpill_lookup(SymTableSpill_T symTable,
+                                           const char *key,
+                                           size_t *offset) {
+   unsigned char *data;
+   size_t keyLength;
+   uint64_t hashCode;
+
+   keyLength = strlen(key);
+   hashCode = SymTableSpill_hash(key);
+   data = SymTableSpill_fetch(symTable,
+                              symTable->directory
+                              [hashCode &
+                               (((uint64_t)1 << symTable->globalDepth)
+                                - 1)], 0);
+   if (data == NULL) {
+      return NULL;
+   }
+   *offset = SymTableSpill_findRecord(data, key, keyLength);
+   return data;
+}
+
+/* Returns a new SymTableSpill object that contains no bindings, whose
+   pages are stored in a new file in directory and cached in at most
+   memoryBudget bytes (but at least one page), or NULL if the file
+   cannot be created or if there is insufficient memory available. */
+SymTableSpill_T SymTableSpill_new(const char *directory,
+                                  size_t memoryBudget) {
+   SymTableSpill_T symTable;
+   char *path;
+   unsigned char *data;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(directory != NULL);
+
+   symTable = (SymTableSpill_T)calloc(1, sizeof(struct SymTableSpill));
+   if (symTable == NULL) {
+      return NULL;
+   }
+
+   symTable->numFrames = (int)(memoryBudget / sizeof(struct STFrame));
+   if (memoryBudget / sizeof(struct STFrame) > INT32_MAX) {
+      symTable->numFrames = INT32_MAX;
+   }
+   if (symTable->numFrames < 1) {
+      symTable->numFrames = 1;
+   }
+   symTable->directory = (uint32_t *)malloc(sizeof(uint32_t));
+   symTable->frameOfPage = (int *)malloc(sizeof(int));
+   symTable->frames = (struct STFrame *)malloc
+      ((size_t)symTable->numFrames * sizeof(struct STFrame));
+   path = (char *)malloc(strlen(directory) +
+                         sizeof("/symtablespillXXXXXX"));
+   if (symTable->directory == NULL || symTable->frameOfPage == NULL ||
+       symTable->frames == NULL || path == NULL) {
+      free(symTable->directory);
+      free(symTable->frameOfPage);
+      free(symTable->frames);
+      free(path);
+      free(symTable);
+      return NULL;
+   }
+
+   /* Creating the file, and unlinking it at once so that it is
+      removed when it is closed. */
+   strcpy(path, directory);
+   strcat(path, "/symtablespillXXXXXX");
+   symTable->fd = mkstemp(path);
+   if (symTable->fd >= 0) {
+      (void)unlink(path);
+   }
+   free(path);
+   if (symTable->fd < 0) {
+      free(symTable->directory);
+      free(symTable->frameOfPage);
+      free(symTable->frames);
+      free(symTable);
+      return NULL;
+   }
+
+   /* Starting with one empty page, to which the directory's single
+      entry refers. */
+   symTable->newest = NO_FRAME;
+   symTable->oldest = NO_FRAME;
+   symTable->pageCapacity = 1;
+   symTable->frameOfPage[0] = NO_FRAME;
+   symTable->directory[0] = 0;
+   symTable->numPages = 1;
+   data = SymTableSpill_fetch(symTable, 0, 1);
+   SymTableSpill_setU32(data + USED_BYTES, PAGE_HEADER_BYTES);
+   return symTable;
+}
+
+/* Frees all memory occupied by symTable, and removes its file. */
+void SymTableSpill_free(SymTableSpill_T symTable) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   (void)close(symTable->fd);
+   free(symTable->directory);
+   free(symTable->frameOfPage);
+   free(symTable->frames);
+   free(symTable);
+}
+
+/* Returns number of bindings (key-value pairs) in symTable. */
+size_t SymTableSpill_getLength(SymTableSpill_T symTable) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   return symTable->numBindings;
+}
+
+/* If symTable does not contain a binding with key, adds a new
+   binding of key and a copy of the valueLength bytes of value to
+   symTable and returns 1. Else, leaves symTable unchanged and returns
+   0, as it also does if the binding does not fit in a page, if
+   insufficient memory is available, or if reading or writing the
+   file fails. */
+int SymTableSpill_put(SymTableSpill_T symTable, const char *key,
+                      const void *value, size_t valueLength) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+   assert(value != NULL || valueLength == 0);
+
+   if (!SymTableSpill_store(symTable, key, value, valueLength, 0)) {
+      return 0;
+   }
+   symTable->numBindings++;
+   return 1;
+}
+
+/* If symTable contains a binding with key, replaces its value with a
+   copy of the valueLength bytes of value and returns 1. Else, leaves
+   symTable unchanged and returns 0, as it also does if the binding
+   does not fit in a page, if insufficient memory is available, or if
+   reading or writing the file fails. */
+int SymTableSpill_replace(SymTableSpill_T symTable, const char *key,
+                          const void *value, size_t valueLength) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+   assert(value != NULL || valueLength == 0);
+
+   return SymTableSpill_store(symTable, key, value, valueLength, 1);
+}
+
+/* Returns 1 if symTable contains a binding with key, or 0 otherwise
+   (or if reading or writing the file fails). */
+int SymTableSpill_contains(SymTableSpill_T symTable, const char *key) {
+   size_t offset;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   return SymTableSpill_lookup(symTable, key, &offset) != NULL &&
+          offset != 0;
+}
+
+/* If symTable contains a binding with key, returns the address of
+   its copy of the value, valid until the next call on symTable, and
+   stores its length in *valueLength (unless valueLength is NULL).
+   Else (or if reading or writing the file fails), returns NULL. */
+const void *SymTableSpill_get(SymTableSpill_T symTable, const char *key,
+                              size_t *valueLength) {
+   unsigned char *data;
+   size_t offset;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   data = SymTableSpill_lookup(symTable, key, &offset);
+   if (data == NULL || offset == 0) {
+      return NULL;
+   }
+   if (valueLength != NULL) {
+      *valueLength = SymTableSpill_getU32(data + offset + 4);
+   }
+   return data + offset + RECORD_HEADER_BYTES +
+          SymTableSpill_getU32(data + offset) + 1;
+}
+
+/* If symTable contains a binding with key, removes it from symTable
+   and returns 1. Else (or if reading or writing the file fails),
+   leaves symTable unchanged and returns 0. Pages are not merged. */
+int SymTableSpill_remove(SymTableSpill_T symTable, const char *key) {
+   unsigned char *data;
+   size_t offset;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(key != NULL);
+
+   data = SymTableSpill_lookup(symTable, key, &offset);
+   if (data == NULL || offset == 0) {
+      return 0;
+   }
+   SymTableSpill_deleteRecord(data, offset);
+   SymTableSpill_markDirty(symTable);
+   symTable->numBindings--;
+   return 1;
+}
+
+/* Applies functionApply to each binding in symTable, passing extra
+   as an extra parameter, page by page in the order of the file.
+   functionApply must not call functions on symTable. Returns 1, or
+   0 if reading or writing the file fails, in which case only the
+   bindings of some pages have been visited. */
+int SymTableSpill_map(SymTableSpill_T symTable, void (*functionApply)
+                      (const char *key, const void *value,
+                       size_t valueLength, void *extra),
+                      const void *extra) {
+   const unsigned char *data;
+   size_t offset, end, keyLength;
+   uint32_t page;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(functionApply != NULL);
+
+   for (page = 0; page < symTable->numPages; page++) {
+      data = SymTableSpill_fetch(symTable, page, 0);
+      if (data == NULL) {
+         return 0;
+      }
+      end = SymTableSpill_getU32(data + USED_BYTES);
+      for (offset = PAGE_HEADER_BYTES; offset < end;
+           offset += SymTableSpill_recordAt(data, offset)) {
+         keyLength = SymTableSpill_getU32(data + offset);
+         (*functionApply)((const char *)data + offset +
+                          RECORD_HEADER_BYTES,
+                          data + offset + RECORD_HEADER_BYTES +
+                          keyLength + 1,
+                          SymTableSpill_getU32(data + offset + 4),
+                          (void *)extra);
+      }
+   }
+   return 1;
+}
@@ -0,0 +1,44 @@
+#ifndef SYMTABLESPILL_INCLUDED
+#define SYMTABLESPILL_INCLUDED
+
+#include <stddef.h>
+
+/* A SymTableSpill is a SymTable that may hold more bindings than fit
+   in memory. Its bindings are kept in pages of an extendible hash
+   table stored in a file, of which only the most recently used pages
+   (as many as fit in a memory budget) are held in memory. Since the
+   bindings outlive the memory they were given in, a SymTableSpill
+   stores a copy of the bytes of each value rather than its address.
+   SymTableSpill_get returns the address of its copy of a value,
+   which remains valid only until the next call on the same
+   SymTableSpill. The file is removed when the SymTableSpill is
+   freed (or its process ends). */
+
+typedef struct SymTableSpill *SymTableSpill_T;
+
+SymTableSpill_T SymTableSpill_new(const char *directory,
+                                  size_t memoryBudget);
+
+void SymTableSpill_free(SymTableSpill_T symTable);
+
+size_t SymTableSpill_getLength(SymTableSpill_T symTable);
+
+int SymTableSpill_put(SymTableSpill_T symTable, const char *key,
+                      const void *value, size_t valueLength);
+
+int SymTableSpill_replace(SymTableSpill_T symTable, const char *key,
+                          const void *value, size_t valueLength);
+
+int SymTableSpill_contains(SymTableSpill_T symTable, const char *key);
+
+const void *SymTableSpill_get(SymTableSpill_T symTable, const char *key,
+                              size_t *valueLength);
+
+int SymTableSpill_remove(SymTableSpill_T symTable, const char *key);
+
+int SymTableSpill_map(SymTableSpill_T symTable, void (*functionApply)
+                      (const char *key, const void *value,
+                       size_t valueLength, void *extra),
+                      const void *extra);
+
+#endif
@@ -0,0 +1,314 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: symtableu64.c
+ *
+ *  Description: Implements a SymTableU64 data type, a SymTable whose
+ *  keys are 64-bit integers. Bindings are held directly in an array
+ *  of slots (open addressing with linear probing), at the slot given
+ *  by a mix of the bits of the key, so that a lookup usually reads a
+ *  single cache line and no binding needs an allocation of its own.
+ *  Removal shifts later bindings of a run back into the freed slot,
+ *  so that no tombstones accumulate.
+ ******************************************************************* */
+#include <assert.h>
+#include <stdlib.h>
+#include "symtableu64.h"
+#include "symtableutil.h"
+
+/* Declaring an enum to hold the number of slots of a new symbol
+   table, and the largest fraction (in eighths) of the slots that may
+   hold bindings before the array of slots is doubled. */
+enum{INITIAL_SLOTS = 16, MAX_LOAD_EIGHTHS = 6};
+
+/* Each binding is stored in an STSlot. A slot whose key is 0 is
+   empty; the binding with key 0 is held in the SymTableU64 itself. */
+struct STSlot {
+   /* The key. */
+   uint64_t key;
+
+   /* The address of the value. */
+   const void *value;
+};
+
+/* A SymTableU64 structure is a 'manager' structure that contains
+   the array of slots, its length, and the number of bindings. */
+struct SymTableU64 {
+   /* The array of slots, whose length is a power of 2. */
+   struct STSlot *slots;
+
+   /* The number of slots, less 1, used to reduce a hash code to a
+      slot index. */
+   size_t slotMask;
+
+   /* The number of bindings in the array of slots. */
+   size_t numSlotBindings;
+
+   /* Whether there is a binding with key 0, and its value. */
+   int hasZeroKey;
+   const void *zeroValue;
+};
+
+/* Returns a hash code for key, mixing its bits with SymTable_mix so
+   that keys that differ in any bits (such as consecutive identifiers)
+   are spread over all slots. */
+static size_t SymTableU64_hash(uint64_t key) {
+   return (size_t)SymTable_mix(key);
+}
+
+/* Returns the index of the slot of symTable holding nonzero key, or
+   of the empty slot ending its run if there is none. */
+static size_t SymTableU64_find(SymTableU64_T symTable, uint64_t key) {
+   size_t index;
+
+   index = SymTableU64_hash(key) & symTable->slotMask;
+   while (symTable->slots[index].key != key &&
+          symTable->slots[index].key != 0) {
+      index = (index + 1) & symTable->slotMask;
+   }
+   return index;
+}
+
+/* Doubles the number of slots of symTable, moving every binding to
+   its slot in the new array. Returns 1, or 0 (leaving symTable
+   unchanged) if there is insufficient memory available. */
+static int SymTableU64_grow(SymTableU64_T symTable) {
+   struct STSlot *oldSlots;
+   size_t oldNumSlots, i, index;
+
+   oldSlots = symTable->slots;
+   oldNumSlots = symTable->slotMask + 1;
+   symTable->slots = (struct STSlot *)calloc(oldNumSlots * 2,
+                                             sizeof(struct STSlot));
+   if (symTable->slots == NULL) {
+      symTable->slots = oldSlots;
+      return 0;
+   }
+   symTable->slotMask = oldNumSlots * 2 - 1;
+
+   for (i = 0; i < oldNumSlots; i++) {
+      if (oldSlots[i].key != 0) {
+         index = SymTableU64_find(symTable, oldSlots[i].key);
+         symTable->slots[index] = oldSlots[i];
+      }
+   }
+   free(oldSlots);
+   return 1;
+}
+
+/* Returns a new SymTableU64 object that contains no bindings,
+   or NULL if there is insufficient memory available. */
+SymTableU64_T SymTableU64_new(void) {
+   SymTableU64_T symTable;
+
+   symTable = (SymTableU64_T)malloc(sizeof(struct SymTableU64));
+   if (symTable == NULL) {
+      return NULL;
+   }
+
+   symTable->slots = (struct STSlot *)calloc(INITIAL_SLOTS,
+                                             sizeof(struct STSlot));
+   if (symTable->slots == NULL) {
+      free(symTable);
+      return NULL;
+   }
+
+   symTable->slotMask = INITIAL_SLOTS - 1;
+   symTable->numSlotBindings = 0;
+   symTable->hasZeroKey = 0;
+   symTable->zeroValue = NULL;
+   return symTable;
+}
+
+/* Frees all memory occupied by symTable. */
+void SymTableU64_free(SymTableU64_T symTable) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   free(symTable->slots);
+   free(symTable);
+}
+
+/* Returns number of bindings (key-value pairs) in symTable. */
+size_t SymTableU64_getLength(SymTableU64_T symTable) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   return symTable->numSlotBindings + (size_t)symTable->hasZeroKey;
+}
+
+/* If symTable does not contain a binding with key, adds a new
+   binding of key and value to symTable and returns 1. Else, leaves
+   symTable unchanged and returns 0, as it also does if insufficient
+   memory is available. */
+int SymTableU64_put(SymTableU64_T symTable, uint64_t key,
+                    const void *value) {
+   size_t index;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   if (key == 0) {
+      if (symTable->hasZeroKey) {
+         return 0;
+      }
+      symTable->hasZeroKey = 1;
+      symTable->zeroValue = value;
+      return 1;
+   }
+
+   index = SymTableU64_find(symTable, key);
+   if (symTable->slots[index].key == key) {
+      return 0;
+   }
+
+   /* Doubling the array of slots first if the new binding would
+      load it past its maximum, and finding the key's slot in the
+      new array. */
+   if ((symTable->numSlotBindings + 1) * 8 >
+       (symTable->slotMask + 1) * MAX_LOAD_EIGHTHS) {
+      if (!SymTableU64_grow(symTable)) {
+         return 0;
+      }
+      index = SymTableU64_find(symTable, key);
+   }
+
+   symTable->slots[index].key = key;
+   symTable->slots[index].value = value;
+   symTable->numSlotBindings++;
+   return 1;
+}
+
+/* If symTable contains a binding with key, returns its value and
+   replaces it with value. Else, leaves symTable unchanged and
+   returns NULL. */
+void *SymTableU64_replace(SymTableU64_T symTable, uint64_t key,
+                          const void *value) {
+   size_t index;
+   void *oldValue;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   if (key == 0) {
+      if (!symTable->hasZeroKey) {
+         return NULL;
+      }
+      oldValue = (void *)symTable->zeroValue;
+      symTable->zeroValue = value;
+      return oldValue;
+   }
+
+   index = SymTableU64_find(symTable, key);
+   if (symTable->slots[index].key != key) {
+      return NULL;
+   }
+   oldValue = (void *)symTable->slots[index].value;
+   symTable->slots[index].value = value;
+   return oldValue;
+}
+
+/* Returns 1 if symTable contains a binding with key, or 0
+   otherwise. */
+int SymTableU64_contains(SymTableU64_T symTable, uint64_t key) {
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   if (key == 0) {
+      return symTable->hasZeroKey;
+   }
+   return symTable->slots[SymTableU64_find(symTable, key)].key == key;
+}
+
+/* If symTable contains a binding with key, returns its value. Else,
+   returns NULL. */
+void *SymTableU64_get(SymTableU64_T symTable, uint64_t key) {
+   size_t index;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   if (key == 0) {
+      return symTable->hasZeroKey ? (void *)symTable->zeroValue : NULL;
+   }
+
+   index = SymTableU64_find(symTable, key);
+   if (symTable->slots[index].key != key) {
+      return NULL;
+   }
+   return (void *)symTable->slots[index].value;
+}
+
+/* If symTable contains a binding with key, removes it from symTable
+   and returns its value. Else, leaves symTable unchanged and returns
+   NULL. */
+void *SymTableU64_remove(SymTableU64_T symTable, uint64_t key) {
+   size_t hole, index, home;
+   void *value;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+
+   if (key == 0) {
+      if (!symTable->hasZeroKey) {
+         return NULL;
+      }
+      symTable->hasZeroKey = 0;
+      return (void *)symTable->zeroValue;
+   }
+
+   hole = SymTableU64_find(symTable, key);
+   if (symTable->slots[hole].key != key) {
+      return NULL;
+   }
+   value = (void *)symTable->slots[hole].value;
+
+   /* Walking the rest of the run, moving back into the hole each
+      binding whose home slot does not lie between the hole and its
+      present slot (cyclically), so that every binding remains
+      reachable from its home slot without passing an empty slot. */
+   index = hole;
+   for (;;) {
+      index = (index + 1) & symTable->slotMask;
+      if (symTable->slots[index].key == 0) {
+         break;
+      }
+      home = SymTableU64_hash(symTable->slots[index].key) &
+             symTable->slotMask;
+      if (((index - home) & symTable->slotMask) >=
+          ((index - hole) & symTable->slotMask)) {
+         symTable->slots[hole] = symTable->slots[index];
+         hole = index;
+      }
+   }
+   symTable->slots[hole].key = 0;
+   symTable->slots[hole].value = NULL;
+   symTable->numSlotBindings--;
+   return value;
+}
+
+/* Applies functionApply to each binding in symTable, passing extra
+   as an extra parameter, that is, calls
+   (*functionApply)(key, (void*)value, (void*)extra) for each
+   key-value binding in symTable. */
+void SymTableU64_map(SymTableU64_T symTable, void (*functionApply)
+                     (uint64_t key, void *value, void *extra),
+                     const void *extra) {
+   size_t i;
+
+   /* Ensuring that the input parameters are not null. */
+   assert(symTable != NULL);
+   assert(functionApply != NULL);
+
+   if (symTable->hasZeroKey) {
+      (*functionApply)(0, (void *)symTable->zeroValue, (void *)extra);
+   }
+   for (i = 0; i <= symTable->slotMask; i++) {
+      if (symTable->slots[i].key != 0) {
+         (*functionApply)(symTable->slots[i].key,
+                          (void *)symTable->slots[i].value,
+                          (void *)extra);
+      }
+   }
+}
@@ -0,0 +1,35 @@
+#ifndef SYMTABLEU64_INCLUDED
+#define SYMTABLEU64_INCLUDED
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* A SymTableU64 is a SymTable whose keys are 64-bit integers rather
+   than strings, so that numeric identifiers need not be formatted
+   into strings (and the strings hashed) to be used as keys. */
+
+typedef struct SymTableU64 *SymTableU64_T;
+
+SymTableU64_T SymTableU64_new(void);
+
+void SymTableU64_free(SymTableU64_T symTable);
+
+size_t SymTableU64_getLength(SymTableU64_T symTable);
+
+int SymTableU64_put(SymTableU64_T symTable, uint64_t key,
+                    const void *value);
+
+void *SymTableU64_replace(SymTableU64_T symTable, uint64_t key,
+                          const void *value);
+
+int SymTableU64_contains(SymTableU64_T symTable, uint64_t key);
+
+void *SymTableU64_get(SymTableU64_T symTable, uint64_t key);
+
+void *SymTableU64_remove(SymTableU64_T symTable, uint64_t key);
+
+void SymTableU64_map(SymTableU64_T symTable, void (*functionApply)
+                     (uint64_t key, void *value, void *extra),
+                     const void *extra);
+
+#endif
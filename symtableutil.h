@@ -0,0 +1,65 @@
+#ifndef SYMTABLEUTIL_INCLUDED
+#define SYMTABLEUTIL_INCLUDED
+
+#include <stddef.h>
+#include <stdint.h>
+#include <malloc.h>
+
+/* Helpers shared by the implementations of the SymTable interface.
+   They are defined static in this header, so that each
+   implementation gets its own copy and the compiler may inline it;
+   they are not part of any interface. */
+
+/* SYMTABLE_INLINE asks for inlining where the language allows it:
+   inline in C99, __inline__ with gcc in C90, and nothing
+   otherwise. */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+#define SYMTABLE_INLINE inline
+#elif defined(__GNUC__)
+#define SYMTABLE_INLINE __inline__
+#else
+#define SYMTABLE_INLINE
+#endif
+
+/* Returns requested, the number of bytes asked for when block was
+   allocated, after adding to *overhead the bytes the allocator holds
+   for block beyond them: the unused tail of block and the size_t
+   header that precedes each block. */
+static SYMTABLE_INLINE size_t SymTable_blockBytes(const void *block,
+                                                  size_t requested,
+                                                  size_t *overhead) {
+   *overhead += malloc_usable_size((void *)block) - requested +
+                sizeof(size_t);
+   return requested;
+}
+
+/* Returns x with its bits mixed (the finalizer of splitmix64), so
+   that inputs differing in any bits differ in about half the bits of
+   the result, both high and low. */
+static SYMTABLE_INLINE uint64_t SymTable_mix(uint64_t x) {
+   x ^= x >> 30;
+   x *= UINT64_C(0xBF58476D1CE4E5B9);
+   x ^= x >> 27;
+   x *= UINT64_C(0x94D049BB133111EB);
+   return x ^ (x >> 31);
+}
+
+/* Returns a hash code for key, computed over its bytes with the
+   multiplier 65599 and mixed by SymTable_mix, storing the length of
+   key in *keyLength unless keyLength is NULL. */
+static SYMTABLE_INLINE uint64_t SymTable_stringHash(const char *key,
+                                                    size_t *keyLength) {
+   const uint64_t HASH_MULTIPLIER = 65599;
+   uint64_t uHash = 0;
+   size_t u;
+
+   for (u = 0; key[u] != '\0'; u++)
+      uHash = uHash * HASH_MULTIPLIER + (uint64_t)(unsigned char)key[u];
+
+   if (keyLength != NULL) {
+      *keyLength = u;
+   }
+   return SymTable_mix(uHash);
+}
+
+#endif
@@ -0,0 +1,222 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: testsymtableartext.c
+ *
+ *  Description: Tests the prefix extensions of the SymTable
+ *  interface provided by the adaptive radix tree implementation
+ *  (symtableart.h): SymTable_map, SymTable_mapPrefix and
+ *  SymTable_removePrefix, over keys that share long prefixes and
+ *  keys that are prefixes of others.
+ ******************************************************************* */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "symtableart.h"
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/* Declaring an enum to hold the largest number of keys recorded by a
+   visit. */
+enum{MAX_VISITED = 2000};
+
+/* The number of tests that have failed. */
+static int numFailures = 0;
+
+/* Copies of the keys visited, in the order they were visited. */
+struct Visit {
+   char keys[MAX_VISITED][32];
+   int numKeys;
+};
+
+/* If !iSuccessful, prints a message to stdout indicating that the
+   test at line iLineNum failed. */
+static void assure(int iSuccessful, int iLineNum) {
+   if (!iSuccessful) {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+      numFailures++;
+   }
+}
+
+/* Prints the heading of the test of what. */
+static void printHeading(const char *what) {
+   printf("------------------------------------------------------\n");
+   printf("Testing %s.\n", what);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+}
+
+/* Records key in the Visit whose address is extra. */
+static void recordKey(const char *key, void *value, void *extra) {
+   struct Visit *visit = (struct Visit *)extra;
+
+   (void)value;
+   if (visit->numKeys < MAX_VISITED) {
+      strcpy(visit->keys[visit->numKeys], key);
+   }
+   visit->numKeys++;
+}
+
+/* Records the address of key in the array of MAX_VISITED pointers
+   whose first element is at *extra, then advances *extra. */
+static void recordAddress(const char *key, void *value, void *extra) {
+   const char ***next = (const char ***)extra;
+
+   (void)value;
+   **next = key;
+   (*next)++;
+}
+
+/* Returns 1 if the keys of visit are in strictly ascending order and
+   all start with prefix, or 0 otherwise. */
+static int isOrdered(const struct Visit *visit, const char *prefix) {
+   int i;
+
+   for (i = 0; i < visit->numKeys && i < MAX_VISITED; i++) {
+      if (strncmp(visit->keys[i], prefix, strlen(prefix)) != 0 ||
+          (i > 0 && strcmp(visit->keys[i - 1], visit->keys[i]) >= 0)) {
+         return 0;
+      }
+   }
+   return 1;
+}
+
+/* Puts into symTable the keys "user:<n>" and "user:<n>:name" for n
+   from 0 to 499, the key "user" and the key "used". */
+static void putKeys(SymTable_T symTable, char *value) {
+   char key[32];
+   int i;
+
+   for (i = 0; i < 500; i++) {
+      sprintf(key, "user:%d", i);
+      ASSURE(SymTable_put(symTable, key, value));
+      sprintf(key, "user:%d:name", i);
+      ASSURE(SymTable_put(symTable, key, value));
+   }
+   ASSURE(SymTable_put(symTable, "user", value));
+   ASSURE(SymTable_put(symTable, "used", value));
+}
+
+/* Tests SymTable_map and SymTable_mapPrefix. */
+static void testMapPrefix(void) {
+   static struct Visit visit;
+   SymTable_T symTable;
+   char value;
+
+   printHeading("SymTable_map and SymTable_mapPrefix");
+
+   symTable = SymTable_new();
+   ASSURE(symTable != NULL);
+   putKeys(symTable, &value);
+
+   visit.numKeys = 0;
+   SymTable_map(symTable, recordKey, &visit);
+   ASSURE(visit.numKeys == 1002);
+   ASSURE(isOrdered(&visit, ""));
+
+   /* A prefix that is itself a key includes that key. */
+   visit.numKeys = 0;
+   SymTable_mapPrefix(symTable, "user", recordKey, &visit);
+   ASSURE(visit.numKeys == 1001);
+   ASSURE(strcmp(visit.keys[0], "user") == 0);
+   ASSURE(isOrdered(&visit, "user"));
+
+   visit.numKeys = 0;
+   SymTable_mapPrefix(symTable, "user:12", recordKey, &visit);
+   ASSURE(visit.numKeys == 22);
+   ASSURE(isOrdered(&visit, "user:12"));
+
+   visit.numKeys = 0;
+   SymTable_mapPrefix(symTable, "user:499:", recordKey, &visit);
+   ASSURE(visit.numKeys == 1);
+   ASSURE(strcmp(visit.keys[0], "user:499:name") == 0);
+
+   visit.numKeys = 0;
+   SymTable_mapPrefix(symTable, "users", recordKey, &visit);
+   ASSURE(visit.numKeys == 0);
+   visit.numKeys = 0;
+   SymTable_mapPrefix(symTable, "", recordKey, &visit);
+   ASSURE(visit.numKeys == 1002);
+   SymTable_free(symTable);
+}
+
+/* Tests that the keys passed by SymTable_map are those held by the
+   SymTable, which stay valid after SymTable_map returns. */
+static void testStoredKeys(void) {
+   static const char *addresses[MAX_VISITED];
+   const char **next = addresses;
+   SymTable_T symTable;
+   char value;
+   int i;
+
+   printHeading("the keys passed by SymTable_map");
+
+   symTable = SymTable_new();
+   ASSURE(symTable != NULL);
+   putKeys(symTable, &value);
+
+   SymTable_map(symTable, recordAddress, &next);
+   ASSURE(next - addresses == 1002);
+   for (i = 0; i < 1002; i++) {
+      ASSURE(SymTable_get(symTable, addresses[i]) == &value);
+      ASSURE(i == 0 || strcmp(addresses[i - 1], addresses[i]) < 0);
+   }
+
+   /* The keys of the bindings left in place, "used" and "user" (the
+      first two visited), survive the removal of the others. */
+   ASSURE(SymTable_removePrefix(symTable, "user:", NULL, NULL) == 1000);
+   ASSURE(strcmp(addresses[0], "used") == 0);
+   ASSURE(strcmp(addresses[1], "user") == 0);
+   ASSURE(SymTable_get(symTable, addresses[1]) == &value);
+   SymTable_free(symTable);
+}
+
+/* Tests SymTable_removePrefix. */
+static void testRemovePrefix(void) {
+   static struct Visit visit;
+   SymTable_T symTable;
+   char value;
+
+   printHeading("SymTable_removePrefix");
+
+   symTable = SymTable_new();
+   ASSURE(symTable != NULL);
+   putKeys(symTable, &value);
+
+   visit.numKeys = 0;
+   ASSURE(SymTable_removePrefix(symTable, "user:1", recordKey, &visit) ==
+          222);
+   ASSURE(visit.numKeys == 222);
+   ASSURE(isOrdered(&visit, "user:1"));
+   ASSURE(SymTable_getLength(symTable) == 780);
+   ASSURE(!SymTable_contains(symTable, "user:1"));
+   ASSURE(!SymTable_contains(symTable, "user:199:name"));
+   ASSURE(SymTable_contains(symTable, "user:2"));
+   ASSURE(SymTable_get(symTable, "user") == &value);
+
+   ASSURE(SymTable_removePrefix(symTable, "nobody", NULL, NULL) == 0);
+   ASSURE(SymTable_removePrefix(symTable, "user:", NULL, NULL) == 778);
+   ASSURE(SymTable_getLength(symTable) == 2);
+   ASSURE(SymTable_contains(symTable, "used"));
+
+   /* The table is still usable after whole subtrees are removed. */
+   ASSURE(SymTable_put(symTable, "user:1", &value));
+   ASSURE(SymTable_get(symTable, "user:1") == &value);
+   ASSURE(SymTable_removePrefix(symTable, "", NULL, NULL) == 3);
+   ASSURE(SymTable_getLength(symTable) == 0);
+   SymTable_free(symTable);
+}
+
+int main(int argc, char *argv[]) {
+   (void)argc;
+
+   testMapPrefix();
+   testStoredKeys();
+   testRemovePrefix();
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return numFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
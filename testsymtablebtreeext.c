@@ -0,0 +1,143 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: testsymtablebtreeext.c
+ *
+ *  Description: Tests the ordered extensions of the SymTable
+ *  interface provided by the B+tree implementation
+ *  (symtablebtree.h): SymTable_map and SymTable_mapRange visit
+ *  bindings in ascending order of their keys, over many leaves.
+ ******************************************************************* */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "symtablebtree.h"
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/* Declaring an enum to hold the number of bindings tested, enough
+   to fill many leaves. */
+enum{NUM_BINDINGS = 5000};
+
+/* The number of tests that have failed. */
+static int numFailures = 0;
+
+/* The keys visited, in the order they were visited. */
+struct Visit {
+   char keys[NUM_BINDINGS][16];
+   int numKeys;
+};
+
+/* If !iSuccessful, prints a message to stdout indicating that the
+   test at line iLineNum failed. */
+static void assure(int iSuccessful, int iLineNum) {
+   if (!iSuccessful) {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+      numFailures++;
+   }
+}
+
+/* Prints the heading of the test of what. */
+static void printHeading(const char *what) {
+   printf("------------------------------------------------------\n");
+   printf("Testing %s.\n", what);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+}
+
+/* Records key in the Visit whose address is extra. */
+static void recordKey(const char *key, void *value, void *extra) {
+   struct Visit *visit = (struct Visit *)extra;
+
+   (void)value;
+   if (visit->numKeys < NUM_BINDINGS) {
+      strcpy(visit->keys[visit->numKeys], key);
+   }
+   visit->numKeys++;
+}
+
+/* Returns 1 if the keys of visit are in strictly ascending order
+   and all lie in [lo, hi) (either bound may be NULL), or 0
+   otherwise. */
+static int isOrdered(const struct Visit *visit, const char *lo,
+                     const char *hi) {
+   int i;
+
+   for (i = 0; i < visit->numKeys; i++) {
+      if ((lo != NULL && strcmp(visit->keys[i], lo) < 0) ||
+          (hi != NULL && strcmp(visit->keys[i], hi) >= 0) ||
+          (i > 0 && strcmp(visit->keys[i - 1], visit->keys[i]) >= 0)) {
+         return 0;
+      }
+   }
+   return 1;
+}
+
+/* Tests SymTable_map and SymTable_mapRange. */
+static void testRanges(void) {
+   static struct Visit visit;
+   SymTable_T symTable;
+   char key[16];
+   char value;
+   int i;
+
+   printHeading("SymTable_map and SymTable_mapRange");
+
+   /* Putting the keys in an order unlike their sorted one. */
+   symTable = SymTable_new();
+   ASSURE(symTable != NULL);
+   for (i = 0; i < NUM_BINDINGS; i++) {
+      sprintf(key, "k%05d", (i * 7919) % NUM_BINDINGS);
+      ASSURE(SymTable_put(symTable, key, &value));
+   }
+
+   visit.numKeys = 0;
+   SymTable_map(symTable, recordKey, &visit);
+   ASSURE(visit.numKeys == NUM_BINDINGS);
+   ASSURE(isOrdered(&visit, NULL, NULL));
+
+   /* A range is closed below and open above. */
+   visit.numKeys = 0;
+   SymTable_mapRange(symTable, "k01000", "k02000", recordKey, &visit);
+   ASSURE(visit.numKeys == 1000);
+   ASSURE(isOrdered(&visit, "k01000", "k02000"));
+   ASSURE(strcmp(visit.keys[0], "k01000") == 0);
+
+   /* Bounds that are not keys, and unbounded sides. */
+   visit.numKeys = 0;
+   SymTable_mapRange(symTable, "k00999x", NULL, recordKey, &visit);
+   ASSURE(visit.numKeys == NUM_BINDINGS - 1000);
+   ASSURE(isOrdered(&visit, "k00999x", NULL));
+   visit.numKeys = 0;
+   SymTable_mapRange(symTable, NULL, "k00010", recordKey, &visit);
+   ASSURE(visit.numKeys == 10);
+   visit.numKeys = 0;
+   SymTable_mapRange(symTable, "k02000", "k01000", recordKey, &visit);
+   ASSURE(visit.numKeys == 0);
+   visit.numKeys = 0;
+   SymTable_mapRange(symTable, "z", NULL, recordKey, &visit);
+   ASSURE(visit.numKeys == 0);
+
+   /* Removing every other key leaves the rest in order. */
+   for (i = 0; i < NUM_BINDINGS; i += 2) {
+      sprintf(key, "k%05d", i);
+      ASSURE(SymTable_remove(symTable, key) == &value);
+   }
+   visit.numKeys = 0;
+   SymTable_mapRange(symTable, "k01000", "k02000", recordKey, &visit);
+   ASSURE(visit.numKeys == 500);
+   ASSURE(isOrdered(&visit, "k01000", "k02000"));
+   SymTable_free(symTable);
+}
+
+int main(int argc, char *argv[]) {
+   (void)argc;
+
+   testRanges();
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return numFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
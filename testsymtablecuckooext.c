@@ -0,0 +1,147 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: testsymtablecuckooext.c
+ *
+ *  Description: Tests the bucketized cuckoo hash table implementation
+ *  of the SymTable interface (symtablecuckoo.c) with keys chosen to
+ *  collide under an unkeyed polynomial hash function, and checks that
+ *  the bucket array stays in proportion to the number of bindings.
+ ******************************************************************* */
+#include <stdio.h>
+#include <stdlib.h>
+#include "symtable.h"
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/* Declaring an enum to hold the length (a power of 2) of the
+   Thue-Morse word making up the colliding keys, the number of such
+   words in each key, the number of slots in a bucket and its size in
+   bytes, and the number of ordinary keys tested. */
+enum{WORD_LENGTH = 2048, NUM_WORDS = 6, SLOTS = 4, BUCKET_BYTES = 64,
+     NUM_BINDINGS = 100000};
+
+/* The number of tests that have failed. */
+static int numFailures = 0;
+
+/* If !iSuccessful, prints a message to stdout indicating that the
+   test at line iLineNum failed. */
+static void assure(int iSuccessful, int iLineNum) {
+   if (!iSuccessful) {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+      numFailures++;
+   }
+}
+
+/* Prints the heading of the test of what. */
+static void printHeading(const char *what) {
+   printf("------------------------------------------------------\n");
+   printf("Testing %s.\n", what);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+}
+
+/* Writes into key the colliding key number n: NUM_WORDS words of
+   WORD_LENGTH characters, word i being the Thue-Morse word over 'a'
+   and 'b' if bit i of n is 0, or its complement if it is 1. All such
+   keys have the same hash code under any polynomial hash with an odd
+   multiplier modulo 2 to the 64th. */
+static void collidingKey(char *key, int n) {
+   int i, j, bit, isB;
+
+   for (i = 0; i < NUM_WORDS; i++) {
+      for (j = 0; j < WORD_LENGTH; j++) {
+         isB = 0;
+         for (bit = j; bit != 0; bit &= bit - 1) {
+            isB = !isB;
+         }
+         if ((n >> i) & 1) {
+            isB = !isB;
+         }
+         key[i * WORD_LENGTH + j] = isB ? 'b' : 'a';
+      }
+   }
+   key[NUM_WORDS * WORD_LENGTH] = '\0';
+}
+
+/* Tests keys built from Thue-Morse words. */
+static void testCollidingKeys(void) {
+   static char key[NUM_WORDS * WORD_LENGTH + 1];
+   static int values[1 << NUM_WORDS];
+   struct SymTable_MemoryUsage usage;
+   SymTable_T symTable;
+   int n;
+
+   printHeading("keys built from Thue-Morse words");
+
+   symTable = SymTable_new();
+   ASSURE(symTable != NULL);
+   for (n = 0; n < 1 << NUM_WORDS; n++) {
+      collidingKey(key, n);
+      ASSURE(SymTable_put(symTable, key, &values[n]));
+   }
+   ASSURE(SymTable_getLength(symTable) == 1 << NUM_WORDS);
+   for (n = 0; n < 1 << NUM_WORDS; n++) {
+      collidingKey(key, n);
+      ASSURE(SymTable_get(symTable, key) == &values[n]);
+      ASSURE(!SymTable_put(symTable, key, &values[0]));
+   }
+
+   /* The bucket array is no larger than it would be for any other
+      keys: at least a tenth of its slots are in use. */
+   (void)SymTable_memoryUsage(symTable, &usage);
+   ASSURE(usage.bucketBytes <=
+          ((1 << NUM_WORDS) * 10 / SLOTS + 16) * BUCKET_BYTES);
+
+   for (n = 0; n < 1 << NUM_WORDS; n += 2) {
+      collidingKey(key, n);
+      ASSURE(SymTable_remove(symTable, key) == &values[n]);
+   }
+   ASSURE(SymTable_getLength(symTable) == (1 << NUM_WORDS) / 2);
+   collidingKey(key, 1);
+   ASSURE(SymTable_contains(symTable, key));
+   SymTable_free(symTable);
+}
+
+/* Tests that the bucket array of a large table is in proportion to
+   its number of bindings. */
+static void testLargeTable(void) {
+   static int values[NUM_BINDINGS];
+   struct SymTable_MemoryUsage usage;
+   SymTable_T symTable;
+   char key[32];
+   int i;
+
+   printHeading("the size of the bucket array of a large table");
+
+   symTable = SymTable_new();
+   ASSURE(symTable != NULL);
+   for (i = 0; i < NUM_BINDINGS; i++) {
+      sprintf(key, "key%d", i);
+      ASSURE(SymTable_put(symTable, key, &values[i]));
+   }
+   for (i = 0; i < NUM_BINDINGS; i++) {
+      sprintf(key, "key%d", i);
+      ASSURE(SymTable_get(symTable, key) == &values[i]);
+   }
+
+   /* The array is doubled only when nine tenths of its slots are in
+      use, so at least four tenths of them are. */
+   (void)SymTable_memoryUsage(symTable, &usage);
+   ASSURE(usage.bucketBytes <=
+          (size_t)NUM_BINDINGS * 10 / (SLOTS * 4) * BUCKET_BYTES);
+   SymTable_free(symTable);
+}
+
+int main(int argc, char *argv[]) {
+   (void)argc;
+
+   testCollidingKeys();
+   testLargeTable();
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return numFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,147 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: testsymtablegen.c
+ *
+ *  Description: Tests the symbol tables defined by SYMTABLE_DEFINE
+ *  (symtablegen.h), instantiated with a scalar and with a structure
+ *  as the value type, so that the macro is compiled and its
+ *  functions run.
+ ******************************************************************* */
+#include <stdio.h>
+#include <stdlib.h>
+#include "symtablegen.h"
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/* A value stored by value in a PointTable. */
+struct Point {
+   double x;
+   double y;
+};
+
+SYMTABLE_DEFINE(IntTable, int)
+SYMTABLE_DEFINE(PointTable, struct Point)
+
+/* Declaring an enum to hold the number of bindings tested, enough
+   for the tables to grow several times. */
+enum{NUM_BINDINGS = 10000};
+
+/* The number of tests that have failed. */
+static int numFailures = 0;
+
+/* If !iSuccessful, prints a message to stdout indicating that the
+   test at line iLineNum failed. */
+static void assure(int iSuccessful, int iLineNum) {
+   if (!iSuccessful) {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+      numFailures++;
+   }
+}
+
+/* Prints the heading of the test of what. */
+static void printHeading(const char *what) {
+   printf("------------------------------------------------------\n");
+   printf("Testing %s.\n", what);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+}
+
+/* Adds *value to the sum whose address is extra, and doubles it. */
+static void sumAndDouble(const char *key, int *value, void *extra) {
+   (void)key;
+   *(long *)extra += *value;
+   *value *= 2;
+}
+
+/* Tests a table of ints. */
+static void testIntTable(void) {
+   IntTable_T table;
+   char key[32];
+   int i, oldValue;
+   long sum = 0;
+
+   printHeading("SYMTABLE_DEFINE(IntTable, int)");
+
+   table = IntTable_new();
+   ASSURE(table != NULL);
+   ASSURE(IntTable_getLength(table) == 0);
+   ASSURE(IntTable_get(table, "missing") == NULL);
+   for (i = 0; i < NUM_BINDINGS; i++) {
+      sprintf(key, "k%d", i);
+      ASSURE(IntTable_put(table, key, i));
+   }
+   ASSURE(!IntTable_put(table, "k0", 5));
+   ASSURE(IntTable_getLength(table) == NUM_BINDINGS);
+   for (i = 0; i < NUM_BINDINGS; i++) {
+      sprintf(key, "k%d", i);
+      ASSURE(IntTable_get(table, key) != NULL &&
+             *IntTable_get(table, key) == i);
+   }
+
+   ASSURE(IntTable_replace(table, "k1", 100, &oldValue));
+   ASSURE(oldValue == 1);
+   ASSURE(!IntTable_replace(table, "missing", 100, NULL));
+   ASSURE(IntTable_remove(table, "k1", &oldValue));
+   ASSURE(oldValue == 100);
+   ASSURE(!IntTable_remove(table, "k1", NULL));
+   ASSURE(!IntTable_contains(table, "k1"));
+   ASSURE(IntTable_contains(table, "k2"));
+   ASSURE(IntTable_put(table, "", -1));
+   ASSURE(*IntTable_get(table, "") == -1);
+   ASSURE(IntTable_remove(table, "", NULL));
+
+   /* A value may be changed in place through its address. */
+   IntTable_map(table, sumAndDouble, &sum);
+   ASSURE(sum == (long)NUM_BINDINGS * (NUM_BINDINGS - 1) / 2 - 1);
+   ASSURE(*IntTable_get(table, "k2") == 4);
+   IntTable_free(table);
+}
+
+/* Tests a table of structures. */
+static void testPointTable(void) {
+   PointTable_T table;
+   struct Point point, oldPoint;
+   char key[32];
+   int i;
+
+   printHeading("SYMTABLE_DEFINE(PointTable, struct Point)");
+
+   table = PointTable_new();
+   ASSURE(table != NULL);
+   for (i = 0; i < NUM_BINDINGS; i++) {
+      sprintf(key, "p%d", i);
+      point.x = i;
+      point.y = -i;
+      ASSURE(PointTable_put(table, key, point));
+   }
+   ASSURE(PointTable_get(table, "p7")->x == 7.0);
+   ASSURE(PointTable_get(table, "p7")->y == -7.0);
+   point.x = 0.5;
+   point.y = 0.25;
+   oldPoint.x = 0.0;
+   oldPoint.y = 0.0;
+   ASSURE(PointTable_replace(table, "p7", point, &oldPoint));
+   ASSURE(oldPoint.x == 7.0 && oldPoint.y == -7.0);
+   ASSURE(PointTable_get(table, "p7")->y == 0.25);
+   for (i = 0; i < NUM_BINDINGS; i += 2) {
+      sprintf(key, "p%d", i);
+      ASSURE(PointTable_remove(table, key, NULL));
+   }
+   ASSURE(PointTable_getLength(table) == NUM_BINDINGS / 2);
+   ASSURE(PointTable_get(table, "p9999")->x == 9999.0);
+   PointTable_free(table);
+}
+
+int main(int argc, char *argv[]) {
+   (void)argc;
+
+   testIntTable();
+   testPointTable();
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return numFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,555 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: testsymtablehashext.c
+ *
+ *  Description: Tests the extensions of the SymTable interface
+ *  provided by the hash table implementation (symtablehash.h): set
+ *  operations, clearing and filtering, bounded tables, times to
+ *  live, the Bloom filter, statistics and latency histograms. Built
+ *  with SYMTABLE_HASH_MASK defined (as testsymtablehashcollide), the
+ *  hash codes keep only a few bits, so that the same tests run with
+ *  every key colliding into a few tree-indexed buckets.
+ ******************************************************************* */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "symtablehash.h"
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/* Declaring an enum to hold the number of bindings of each table of
+   the large set operations, which is enough for them to be split
+   between threads, and the number of keys the two share. */
+enum{LARGE_COUNT = 40000, LARGE_SHARED = 10000};
+
+/* Declaring an enum to hold the number of bindings of the table whose
+   statistics are tested, which is enough for its bucket array to grow
+   past the size from which it is mapped from the system. */
+enum{STATS_COUNT = 300000};
+
+/* The number of tests that have failed. */
+static int numFailures = 0;
+
+/* If !iSuccessful, prints a message to stdout indicating that the
+   test at line iLineNum failed. */
+static void assure(int iSuccessful, int iLineNum) {
+   if (!iSuccessful) {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+      numFailures++;
+   }
+}
+
+/* Prints the heading of the test of what. */
+static void printHeading(const char *what) {
+   printf("------------------------------------------------------\n");
+   printf("Testing %s.\n", what);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+}
+
+/* Writes the key of binding number i with prefix prefix to key. */
+static void makeKey(char *key, const char *prefix, int i) {
+   sprintf(key, "%s%d", prefix, i);
+}
+
+/* Counts the binding in the int whose address is extra. */
+static void countBinding(const char *key, void *value, void *extra) {
+   (void)key;
+   (void)value;
+   (*(int *)extra)++;
+}
+
+/* Returns 1 if key ends with an odd digit, or 0 otherwise. */
+static int isOdd(const char *key, void *value, void *extra) {
+   (void)value;
+   (void)extra;
+   return (key[strlen(key) - 1] - '0') % 2 == 1;
+}
+
+/* Counts the conflict in the int whose address is extra, and keeps
+   the value of src. */
+static void *keepSource(const char *key, void *dstValue, void *srcValue,
+                        void *extra) {
+   (void)key;
+   (void)dstValue;
+   (*(int *)extra)++;
+   return srcValue;
+}
+
+/* Sleeps for millis milliseconds. */
+static void sleepMillis(long millis) {
+   struct timespec delay;
+
+   delay.tv_sec = millis / 1000;
+   delay.tv_nsec = (millis % 1000) * 1000000L;
+   (void)nanosleep(&delay, NULL);
+}
+
+/* Tests SymTable_merge, SymTable_intersect and SymTable_difference
+   on small tables with different hash keys. */
+static void testSetOperations(void) {
+   SymTable_T dst, src;
+   char values[8];
+   int numConflicts = 0, numRemoved = 0;
+
+   printHeading("SymTable_merge, SymTable_intersect and "
+                "SymTable_difference");
+
+   dst = SymTable_new();
+   src = SymTable_new();
+   ASSURE(dst != NULL && src != NULL);
+   ASSURE(SymTable_put(dst, "a", &values[0]));
+   ASSURE(SymTable_put(dst, "b", &values[1]));
+   ASSURE(SymTable_put(src, "b", &values[2]));
+   ASSURE(SymTable_put(src, "c", &values[3]));
+
+   /* Merging, with and without a conflict function. */
+   ASSURE(SymTable_merge(dst, src, keepSource, &numConflicts));
+   ASSURE(numConflicts == 1);
+   ASSURE(SymTable_getLength(dst) == 3);
+   ASSURE(SymTable_getLength(src) == 0);
+   ASSURE(SymTable_get(dst, "a") == &values[0]);
+   ASSURE(SymTable_get(dst, "b") == &values[2]);
+   ASSURE(SymTable_get(dst, "c") == &values[3]);
+   ASSURE(SymTable_put(src, "c", &values[4]));
+   ASSURE(SymTable_merge(dst, src, NULL, NULL));
+   ASSURE(SymTable_get(dst, "c") == &values[3]);
+
+   /* Keeping only the keys also in src, then removing them. */
+   ASSURE(SymTable_put(src, "a", &values[5]));
+   ASSURE(SymTable_put(src, "c", &values[6]));
+   ASSURE(SymTable_intersect(dst, src, countBinding, &numRemoved) == 1);
+   ASSURE(numRemoved == 1);
+   ASSURE(!SymTable_contains(dst, "b"));
+   ASSURE(SymTable_getLength(src) == 2);
+   ASSURE(SymTable_difference(dst, src, NULL, NULL) == 2);
+   ASSURE(SymTable_getLength(dst) == 0);
+
+   SymTable_free(dst);
+   SymTable_free(src);
+}
+
+/* Tests the set operations on tables large enough to be split
+   bucket by bucket between threads, made with SymTable_newLike so
+   that they share a hash key. */
+static void testLargeSetOperations(void) {
+   SymTable_T dst, src, empty;
+   char key[32];
+   char values[2];
+   int i, numConflicts = 0, numRemoved = 0;
+   struct SymTable_Stats dstStats, srcStats;
+
+   printHeading("set operations on large tables");
+
+   dst = SymTable_new();
+   src = SymTable_newLike(dst);
+   ASSURE(dst != NULL && src != NULL);
+   for (i = 0; i < LARGE_COUNT; i++) {
+      makeKey(key, "k", i);
+      ASSURE(SymTable_put(dst, key, &values[0]));
+      makeKey(key, "k", i + LARGE_COUNT - LARGE_SHARED);
+      ASSURE(SymTable_put(src, key, &values[1]));
+   }
+   SymTable_getStats(dst, &dstStats);
+   SymTable_getStats(src, &srcStats);
+   ASSURE(dstStats.numBuckets == srcStats.numBuckets);
+
+   ASSURE(SymTable_merge(dst, src, keepSource, &numConflicts));
+   ASSURE(numConflicts == LARGE_SHARED);
+   ASSURE(SymTable_getLength(dst) == 2 * LARGE_COUNT - LARGE_SHARED);
+   ASSURE(SymTable_getLength(src) == 0);
+   for (i = 0; i < 2 * LARGE_COUNT - LARGE_SHARED; i++) {
+      makeKey(key, "k", i);
+      ASSURE(SymTable_get(dst, key) ==
+             &values[i < LARGE_COUNT - LARGE_SHARED ? 0 : 1]);
+   }
+
+   /* An empty table takes the hash key of the table merged into
+      it. */
+   empty = SymTable_new();
+   ASSURE(empty != NULL);
+   ASSURE(SymTable_merge(empty, dst, NULL, NULL));
+   ASSURE(SymTable_getLength(empty) == 2 * LARGE_COUNT - LARGE_SHARED);
+   ASSURE(SymTable_getLength(dst) == 0);
+
+   /* Intersecting and differencing tables of the same size. */
+   for (i = 0; i < LARGE_COUNT; i++) {
+      makeKey(key, "k", i);
+      ASSURE(SymTable_put(dst, key, &values[0]));
+      makeKey(key, "k", i + LARGE_COUNT - LARGE_SHARED);
+      ASSURE(SymTable_put(src, key, &values[1]));
+   }
+   ASSURE(SymTable_intersect(dst, src, countBinding, &numRemoved) ==
+          LARGE_COUNT - LARGE_SHARED);
+   ASSURE(numRemoved == LARGE_COUNT - LARGE_SHARED);
+   ASSURE(SymTable_getLength(dst) == LARGE_SHARED);
+   ASSURE(!SymTable_contains(dst, "k0"));
+   makeKey(key, "k", LARGE_COUNT - 1);
+   ASSURE(SymTable_get(dst, key) == &values[0]);
+   ASSURE(SymTable_difference(src, dst, NULL, NULL) == LARGE_SHARED);
+   ASSURE(SymTable_getLength(src) == LARGE_COUNT - LARGE_SHARED);
+   ASSURE(SymTable_difference(empty, src, NULL, NULL) ==
+          LARGE_COUNT - LARGE_SHARED);
+   ASSURE(SymTable_getLength(empty) == LARGE_COUNT);
+
+   SymTable_free(dst);
+   SymTable_free(src);
+   SymTable_free(empty);
+
+   /* Intersecting and differencing a large table with a smaller one
+      that hashes keys differently. */
+   dst = SymTable_new();
+   src = SymTable_new();
+   ASSURE(dst != NULL && src != NULL);
+   for (i = 0; i < 2 * LARGE_COUNT; i++) {
+      makeKey(key, "k", i);
+      ASSURE(SymTable_put(dst, key, &values[0]));
+   }
+   for (i = 0; i < LARGE_SHARED; i++) {
+      makeKey(key, "k", 2 * i);
+      ASSURE(SymTable_put(src, key, &values[1]));
+   }
+   SymTable_getStats(dst, &dstStats);
+   SymTable_getStats(src, &srcStats);
+   ASSURE(dstStats.numBuckets > srcStats.numBuckets);
+   ASSURE(SymTable_difference(dst, src, NULL, NULL) == LARGE_SHARED);
+   ASSURE(SymTable_getLength(dst) == 2 * LARGE_COUNT - LARGE_SHARED);
+   ASSURE(!SymTable_contains(dst, "k0"));
+   ASSURE(SymTable_contains(dst, "k1"));
+   for (i = 0; i < LARGE_SHARED; i++) {
+      makeKey(key, "k", 2 * i + 1);
+      ASSURE(SymTable_put(src, key, &values[1]));
+   }
+   ASSURE(SymTable_intersect(dst, src, NULL, NULL) ==
+          2 * LARGE_COUNT - 2 * LARGE_SHARED);
+   ASSURE(SymTable_getLength(dst) == LARGE_SHARED);
+   makeKey(key, "k", 2 * LARGE_SHARED - 1);
+   ASSURE(SymTable_get(dst, key) == &values[0]);
+   SymTable_free(dst);
+   SymTable_free(src);
+}
+
+/* Tests SymTable_clear and SymTable_removeIf. */
+static void testClearAndRemoveIf(void) {
+   SymTable_T symTable;
+   char key[32];
+   char values[100];
+   int i, numFreed = 0, numRemoved = 0;
+
+   printHeading("SymTable_clear and SymTable_removeIf");
+
+   symTable = SymTable_new();
+   ASSURE(symTable != NULL);
+   for (i = 0; i < 100; i++) {
+      makeKey(key, "k", i);
+      ASSURE(SymTable_put(symTable, key, &values[i]));
+   }
+   ASSURE(SymTable_removeIf(symTable, isOdd, countBinding,
+                            &numRemoved) == 50);
+   ASSURE(numRemoved == 50);
+   ASSURE(SymTable_getLength(symTable) == 50);
+   ASSURE(SymTable_contains(symTable, "k0"));
+   ASSURE(!SymTable_contains(symTable, "k1"));
+
+   SymTable_clear(symTable, countBinding, &numFreed);
+   ASSURE(numFreed == 50);
+   ASSURE(SymTable_getLength(symTable) == 0);
+   ASSURE(!SymTable_contains(symTable, "k0"));
+   ASSURE(SymTable_put(symTable, "k0", &values[0]));
+   ASSURE(SymTable_get(symTable, "k0") == &values[0]);
+
+   SymTable_free(symTable);
+}
+
+/* Tests SymTable_newBounded and its eviction function. */
+static void testBounded(void) {
+   SymTable_T symTable;
+   char key[32];
+   char bigKey[1200];
+   char value;
+   int i, numEvicted = 0;
+
+   printHeading("SymTable_newBounded");
+
+   symTable = SymTable_newBounded(100, 0, countBinding, &numEvicted);
+   ASSURE(symTable != NULL);
+   for (i = 0; i < 150; i++) {
+      makeKey(key, "k", i);
+      ASSURE(SymTable_put(symTable, key, &value));
+   }
+   ASSURE(SymTable_getLength(symTable) == 100);
+   ASSURE(numEvicted == 50);
+   ASSURE(!SymTable_contains(symTable, "k49"));
+   ASSURE(SymTable_contains(symTable, "k50"));
+
+   /* Using k50 makes k51 the least recently used binding. */
+   ASSURE(SymTable_get(symTable, "k50") == &value);
+   ASSURE(SymTable_put(symTable, "new", &value));
+   ASSURE(numEvicted == 51);
+   ASSURE(SymTable_contains(symTable, "k50"));
+   ASSURE(!SymTable_contains(symTable, "k51"));
+   SymTable_free(symTable);
+
+   /* A byte bound evicts too, and rejects a binding that could
+      never fit. */
+   numEvicted = 0;
+   symTable = SymTable_newBounded(0, 1000, countBinding, &numEvicted);
+   ASSURE(symTable != NULL);
+   for (i = 0; i < 100; i++) {
+      makeKey(key, "k", i);
+      ASSURE(SymTable_put(symTable, key, &value));
+   }
+   ASSURE(numEvicted > 0);
+   ASSURE(SymTable_getLength(symTable) == (size_t)(100 - numEvicted));
+   ASSURE(SymTable_contains(symTable, "k99"));
+   memset(bigKey, 'x', sizeof(bigKey) - 1);
+   bigKey[sizeof(bigKey) - 1] = '\0';
+   ASSURE(!SymTable_put(symTable, bigKey, &value));
+   ASSURE(SymTable_contains(symTable, "k99"));
+   SymTable_free(symTable);
+}
+
+/* Tests SymTable_putWithTTL, SymTable_setExpireFunction and
+   SymTable_expire. */
+static void testTimeToLive(void) {
+   SymTable_T symTable;
+   char key[32];
+   char value;
+   int i, numExpired = 0, numLive = 0;
+
+   printHeading("SymTable_putWithTTL");
+
+   /* The first binding with a time to live is put into a table that
+      already holds others. */
+   symTable = SymTable_new();
+   ASSURE(symTable != NULL);
+   for (i = 0; i < 100; i++) {
+      makeKey(key, "plain", i);
+      ASSURE(SymTable_put(symTable, key, &value));
+   }
+   SymTable_setExpireFunction(symTable, countBinding, &numExpired);
+   for (i = 0; i < 100; i++) {
+      makeKey(key, "short", i);
+      ASSURE(SymTable_putWithTTL(symTable, key, &value, 1));
+      makeKey(key, "long", i);
+      ASSURE(SymTable_putWithTTL(symTable, key, &value, 3600000));
+   }
+   /* Some of the bindings may already have been reclaimed by the
+      puts that followed them. */
+   ASSURE(!SymTable_putWithTTL(symTable, "long0", &value, 1));
+   ASSURE(SymTable_getLength(symTable) + (size_t)numExpired == 300);
+   sleepMillis(20);
+   ASSURE(SymTable_expire(symTable) <= 100);
+   ASSURE(numExpired == 100);
+   ASSURE(SymTable_getLength(symTable) == 200);
+   ASSURE(!SymTable_contains(symTable, "short0"));
+   ASSURE(SymTable_contains(symTable, "long0"));
+   ASSURE(SymTable_get(symTable, "plain0") == &value);
+   SymTable_map(symTable, countBinding, &numLive);
+   ASSURE(numLive == 200);
+
+   /* An expired binding is gone before it is reclaimed, and its key
+      may be put again. */
+   ASSURE(SymTable_putWithTTL(symTable, "brief", &value, 1));
+   sleepMillis(20);
+   ASSURE(SymTable_get(symTable, "brief") == NULL);
+   ASSURE(SymTable_put(symTable, "brief", &value));
+   ASSURE(SymTable_remove(symTable, "long1") == &value);
+   SymTable_free(symTable);
+}
+
+/* Tests SymTable_setBloomFilter. */
+static void testBloomFilter(void) {
+   SymTable_T symTable;
+   char key[32];
+   char value;
+   int i;
+
+   printHeading("SymTable_setBloomFilter");
+
+   symTable = SymTable_new();
+   ASSURE(symTable != NULL);
+   ASSURE(SymTable_setBloomFilter(symTable, 1));
+   for (i = 0; i < 5000; i++) {
+      makeKey(key, "k", i);
+      ASSURE(SymTable_put(symTable, key, &value));
+   }
+   for (i = 0; i < 5000; i++) {
+      makeKey(key, "k", i);
+      ASSURE(SymTable_contains(symTable, key));
+      makeKey(key, "missing", i);
+      ASSURE(!SymTable_contains(symTable, key));
+   }
+   ASSURE(SymTable_remove(symTable, "k0") == &value);
+   ASSURE(!SymTable_contains(symTable, "k0"));
+   ASSURE(SymTable_setBloomFilter(symTable, 0));
+   ASSURE(SymTable_contains(symTable, "k1"));
+   SymTable_free(symTable);
+}
+
+/* Tests SymTable_getStats and SymTable_memoryUsage on a table with
+   more bindings than the old limit of 65521 buckets. */
+static void testStats(void) {
+   SymTable_T symTable;
+   struct SymTable_Stats stats;
+   struct SymTable_MemoryUsage usage;
+   char key[32];
+   char value;
+   size_t numBuckets = 0;
+   int i;
+
+   printHeading("SymTable_getStats and SymTable_memoryUsage");
+
+   symTable = SymTable_new();
+   ASSURE(symTable != NULL);
+   for (i = 0; i < STATS_COUNT; i++) {
+      makeKey(key, "k", i);
+      ASSURE(SymTable_put(symTable, key, &value));
+   }
+   for (i = 0; i < STATS_COUNT; i++) {
+      makeKey(key, "k", i);
+      ASSURE(SymTable_get(symTable, key) == &value);
+   }
+   SymTable_getStats(symTable, &stats);
+   ASSURE(stats.numBindings == STATS_COUNT);
+   ASSURE(stats.numBuckets >= STATS_COUNT);
+   ASSURE((stats.numBuckets & (stats.numBuckets - 1)) == 0);
+   ASSURE(stats.loadFactor <= 1.0);
+   for (i = 0; i < SYMTABLE_CHAIN_HISTOGRAM_SIZE; i++) {
+      numBuckets += stats.chainLengthCounts[i];
+   }
+   ASSURE(numBuckets == stats.numBuckets);
+#ifdef SYMTABLE_HASH_MASK
+   ASSURE(stats.numTrees > 0);
+   ASSURE(stats.treeBytes > 0);
+#else
+   ASSURE(stats.numTrees == 0);
+   ASSURE(stats.maxChainLength < 12);
+#endif
+   ASSURE(stats.numRehashes > 0);
+
+   ASSURE(SymTable_memoryUsage(symTable, &usage) == usage.totalBytes);
+   ASSURE(usage.nodeBytes >= stats.nodeBytes);
+   ASSURE(usage.bucketBytes >= stats.numBuckets * sizeof(void *));
+   ASSURE(usage.totalBytes > usage.nodeBytes + usage.keyBytes);
+   SymTable_free(symTable);
+}
+
+/* Tests SymTable_setInstrumentation, SymTable_getLatency and
+   SymTable_dumpLatency. */
+static void testLatency(void) {
+   SymTable_T symTable;
+   struct SymTable_Latency latency;
+   FILE *stream;
+   char key[32];
+   char value;
+   int i;
+
+   printHeading("SymTable_getLatency");
+
+   symTable = SymTable_new();
+   ASSURE(symTable != NULL);
+   ASSURE(SymTable_setInstrumentation(symTable, 1));
+   for (i = 0; i < 1000; i++) {
+      makeKey(key, "k", i);
+      ASSURE(SymTable_put(symTable, key, &value));
+      ASSURE(SymTable_get(symTable, key) == &value);
+   }
+   ASSURE(SymTable_remove(symTable, "k0") == &value);
+
+   SymTable_getLatency(symTable, SYMTABLE_OP_PUT, &latency);
+   ASSURE(latency.count == 1000);
+   ASSURE(latency.p50 <= latency.p99 && latency.p99 <= latency.p999);
+   ASSURE(latency.p999 <= latency.max);
+   SymTable_getLatency(symTable, SYMTABLE_OP_REMOVE, &latency);
+   ASSURE(latency.count == 1);
+   SymTable_getLatency(symTable, SYMTABLE_OP_MAP, &latency);
+   ASSURE(latency.count == 0);
+
+   stream = tmpfile();
+   ASSURE(stream != NULL);
+   if (stream != NULL) {
+      SymTable_dumpLatency(symTable, stream);
+      ASSURE(ftell(stream) > 0);
+      fclose(stream);
+   }
+
+   ASSURE(SymTable_setInstrumentation(symTable, 0));
+   SymTable_getLatency(symTable, SYMTABLE_OP_PUT, &latency);
+   ASSURE(latency.count == 0);
+   SymTable_free(symTable);
+}
+
+/* Tests that bindings stay correct while their buckets are indexed
+   by trees and the trees are discarded again, with a bound and
+   times to live. Every key collides only in the build with
+   SYMTABLE_HASH_MASK defined. */
+static void testCollisions(void) {
+   SymTable_T symTable;
+   char key[32];
+   char values[2000];
+   int i, numEvicted = 0, numExpired = 0;
+
+   printHeading("colliding keys");
+
+   symTable = SymTable_newBounded(1500, 0, countBinding, &numEvicted);
+   ASSURE(symTable != NULL);
+   SymTable_setExpireFunction(symTable, countBinding, &numExpired);
+   for (i = 0; i < 2000; i++) {
+      makeKey(key, "k", i);
+      ASSURE(SymTable_put(symTable, key, &values[i]));
+   }
+   ASSURE(numEvicted == 500);
+   for (i = 500; i < 2000; i++) {
+      makeKey(key, "k", i);
+      ASSURE(SymTable_get(symTable, key) == &values[i]);
+   }
+
+   /* Removing all but a few bindings, in an order unlike the one
+      they were put in. */
+   for (i = 1999; i >= 503; i -= 2) {
+      makeKey(key, "k", i);
+      ASSURE(SymTable_remove(symTable, key) == &values[i]);
+   }
+   for (i = 1998; i >= 506; i -= 2) {
+      makeKey(key, "k", i);
+      ASSURE(SymTable_remove(symTable, key) == &values[i]);
+   }
+   ASSURE(SymTable_getLength(symTable) == 4);
+   ASSURE(SymTable_get(symTable, "k500") == &values[500]);
+   ASSURE(SymTable_get(symTable, "k504") == &values[504]);
+
+   for (i = 0; i < 1000; i++) {
+      makeKey(key, "t", i);
+      ASSURE(SymTable_putWithTTL(symTable, key, &values[i], 1));
+   }
+   sleepMillis(20);
+   (void)SymTable_expire(symTable);
+   ASSURE(numExpired == 1000);
+   ASSURE(numEvicted == 500);
+   ASSURE(SymTable_getLength(symTable) == 4);
+   SymTable_free(symTable);
+}
+
+int main(int argc, char *argv[]) {
+   (void)argc;
+
+   testSetOperations();
+   testLargeSetOperations();
+   testClearAndRemoveIf();
+   testBounded();
+   testTimeToLive();
+   testBloomFilter();
+   testStats();
+   testLatency();
+   testCollisions();
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return numFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,118 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: testsymtablelibext.c
+ *
+ *  Description: Tests the extensions of the SymTable interface
+ *  provided by libsymtable (symtablelib.h): choosing an implementation
+ *  per table, and SymTable_clear and SymTable_removeIf, which succeed
+ *  on the implementations that provide them and fail, leaving the
+ *  table unchanged, on the others.
+ ******************************************************************* */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "symtablelib.h"
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/* Declaring an enum to hold the number of bindings of each table. */
+enum{NUM_BINDINGS = 100};
+
+/* The number of tests that have failed. */
+static int numFailures = 0;
+
+/* If !iSuccessful, prints a message to stdout indicating that the
+   test at line iLineNum failed. */
+static void assure(int iSuccessful, int iLineNum) {
+   if (!iSuccessful) {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+      numFailures++;
+   }
+}
+
+/* Prints the heading of the test of what. */
+static void printHeading(const char *what) {
+   printf("------------------------------------------------------\n");
+   printf("Testing %s.\n", what);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+}
+
+/* Counts the binding in the int whose address is extra. */
+static void countBinding(const char *key, void *value, void *extra) {
+   (void)key;
+   (void)value;
+   (*(int *)extra)++;
+}
+
+/* Returns 1 if key ends with an odd digit, or 0 otherwise. */
+static int isOdd(const char *key, void *value, void *extra) {
+   (void)value;
+   (void)extra;
+   return (key[strlen(key) - 1] - '0') % 2 == 1;
+}
+
+/* Tests SymTable_clear and SymTable_removeIf on a table of kind,
+   which provides them if hasClear and hasRemoveIf. */
+static void testKind(enum SymTable_Kind kind, int hasClear,
+                     int hasRemoveIf) {
+   SymTable_T symTable;
+   char key[32];
+   char value;
+   size_t numRemoved = 0;
+   int i, numFreed = 0, numVisited = 0;
+
+   symTable = SymTable_newWithBackend(kind);
+   ASSURE(symTable != NULL);
+   ASSURE(SymTable_getBackend(symTable) == kind);
+   for (i = 0; i < NUM_BINDINGS; i++) {
+      sprintf(key, "k%d", i);
+      ASSURE(SymTable_put(symTable, key, &value));
+   }
+
+   ASSURE(SymTable_removeIf(symTable, isOdd, countBinding, &numVisited,
+                            &numRemoved) == hasRemoveIf);
+   if (hasRemoveIf) {
+      ASSURE(numRemoved == NUM_BINDINGS / 2);
+      ASSURE(numVisited == NUM_BINDINGS / 2);
+      ASSURE(!SymTable_contains(symTable, "k1"));
+   }
+   else {
+      ASSURE(numVisited == 0);
+      ASSURE(SymTable_contains(symTable, "k1"));
+   }
+   ASSURE(SymTable_contains(symTable, "k0"));
+
+   ASSURE(SymTable_clear(symTable, countBinding, &numFreed) == hasClear);
+   if (hasClear) {
+      ASSURE(numFreed == NUM_BINDINGS - (int)numRemoved);
+      ASSURE(SymTable_getLength(symTable) == 0);
+      ASSURE(SymTable_put(symTable, "k0", &value));
+   }
+   else {
+      ASSURE(numFreed == 0);
+      ASSURE(SymTable_getLength(symTable) ==
+             (size_t)NUM_BINDINGS - numRemoved);
+   }
+   ASSURE(SymTable_get(symTable, "k0") == &value);
+   SymTable_free(symTable);
+}
+
+int main(int argc, char *argv[]) {
+   (void)argc;
+
+   printHeading("SymTable_clear and SymTable_removeIf");
+   testKind(SYMTABLE_LIST, 1, 1);
+   testKind(SYMTABLE_HASH, 1, 1);
+   testKind(SYMTABLE_BTREE, 0, 0);
+   testKind(SYMTABLE_ART, 0, 0);
+   testKind(SYMTABLE_COMPACT, 1, 0);
+   testKind(SYMTABLE_CUCKOO, 0, 0);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return numFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,149 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: testsymtablelistext.c
+ *
+ *  Description: Tests the extensions of the SymTable interface
+ *  provided by the linked list implementation (symtablelist.h):
+ *  self-organizing tables, clearing and filtering, both while the
+ *  bindings fit in the flat arrays and after the table has outgrown
+ *  them.
+ ******************************************************************* */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "symtablelist.h"
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/* The number of tests that have failed. */
+static int numFailures = 0;
+
+/* If !iSuccessful, prints a message to stdout indicating that the
+   test at line iLineNum failed. */
+static void assure(int iSuccessful, int iLineNum) {
+   if (!iSuccessful) {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+      numFailures++;
+   }
+}
+
+/* Prints the heading of the test of what. */
+static void printHeading(const char *what) {
+   printf("------------------------------------------------------\n");
+   printf("Testing %s.\n", what);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+}
+
+/* Counts the binding in the int whose address is extra. */
+static void countBinding(const char *key, void *value, void *extra) {
+   (void)key;
+   (void)value;
+   (*(int *)extra)++;
+}
+
+/* Returns 1 if key ends with an odd digit, or 0 otherwise. */
+static int isOdd(const char *key, void *value, void *extra) {
+   (void)value;
+   (void)extra;
+   return (key[strlen(key) - 1] - '0') % 2 == 1;
+}
+
+/* Fills a new SymTable with numBindings bindings of the keys k0,
+   k1, ..., each bound to its element of values, under organization,
+   and checks that each is found (repeatedly, so that the table
+   reorders itself) and that none is lost. */
+static void testOrganization(enum SymTable_Organization organization,
+                             int numBindings, char *values) {
+   SymTable_T symTable;
+   char key[32];
+   int i, round, numVisited = 0;
+
+   symTable = SymTable_new();
+   ASSURE(symTable != NULL);
+   SymTable_setOrganization(symTable, organization);
+   for (i = 0; i < numBindings; i++) {
+      sprintf(key, "k%d", i);
+      ASSURE(SymTable_put(symTable, key, &values[i]));
+   }
+   for (round = 0; round < 3; round++) {
+      for (i = numBindings - 1; i >= 0; i -= 3) {
+         sprintf(key, "k%d", i);
+         ASSURE(SymTable_get(symTable, key) == &values[i]);
+         ASSURE(SymTable_contains(symTable, key));
+      }
+   }
+   ASSURE(!SymTable_contains(symTable, "missing"));
+   ASSURE(SymTable_replace(symTable, "k0", &values[1]) == &values[0]);
+   ASSURE(SymTable_remove(symTable, "k1") == &values[1]);
+   SymTable_map(symTable, countBinding, &numVisited);
+   ASSURE(numVisited == numBindings - 1);
+   ASSURE(SymTable_getLength(symTable) == (size_t)numBindings - 1);
+
+   /* Going back to insertion order keeps every binding. */
+   SymTable_setOrganization(symTable, SYMTABLE_STATIC);
+   for (i = 2; i < numBindings; i++) {
+      sprintf(key, "k%d", i);
+      ASSURE(SymTable_get(symTable, key) == &values[i]);
+   }
+   SymTable_free(symTable);
+}
+
+/* Tests SymTable_setOrganization with few and with many bindings. */
+static void testOrganizations(void) {
+   char values[500];
+
+   printHeading("SymTable_setOrganization");
+
+   testOrganization(SYMTABLE_STATIC, 20, values);
+   testOrganization(SYMTABLE_MOVE_TO_FRONT, 20, values);
+   testOrganization(SYMTABLE_TRANSPOSE, 20, values);
+   testOrganization(SYMTABLE_STATIC, 500, values);
+   testOrganization(SYMTABLE_MOVE_TO_FRONT, 500, values);
+   testOrganization(SYMTABLE_TRANSPOSE, 500, values);
+}
+
+/* Tests SymTable_clear and SymTable_removeIf on a table of
+   numBindings bindings. */
+static void testClearAndRemoveIf(int numBindings) {
+   SymTable_T symTable;
+   char key[32];
+   char value;
+   int i, numFreed = 0, numRemoved = 0;
+
+   symTable = SymTable_new();
+   ASSURE(symTable != NULL);
+   for (i = 0; i < numBindings; i++) {
+      sprintf(key, "k%d", i);
+      ASSURE(SymTable_put(symTable, key, &value));
+   }
+   ASSURE(SymTable_removeIf(symTable, isOdd, countBinding,
+                            &numRemoved) == (size_t)numBindings / 2);
+   ASSURE(numRemoved == numBindings / 2);
+   ASSURE(SymTable_contains(symTable, "k0"));
+   ASSURE(!SymTable_contains(symTable, "k1"));
+
+   SymTable_clear(symTable, countBinding, &numFreed);
+   ASSURE(numFreed == numBindings - numBindings / 2);
+   ASSURE(SymTable_getLength(symTable) == 0);
+   ASSURE(!SymTable_contains(symTable, "k0"));
+   ASSURE(SymTable_put(symTable, "k0", &value));
+   ASSURE(SymTable_get(symTable, "k0") == &value);
+   SymTable_free(symTable);
+}
+
+int main(int argc, char *argv[]) {
+   (void)argc;
+
+   testOrganizations();
+   printHeading("SymTable_clear and SymTable_removeIf");
+   testClearAndRemoveIf(20);
+   testClearAndRemoveIf(1000);
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return numFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
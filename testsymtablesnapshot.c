@@ -0,0 +1,165 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: testsymtablesnapshot.c
+ *
+ *  Description: Tests SymTable_snapshotAsync and
+ *  SymTable_snapshotWait (symtablesnapshot.h): a snapshot is parsed
+ *  back record by record and compared with the table as it was when
+ *  the snapshot was asked for, although the table changes while the
+ *  child writes it.
+ ******************************************************************* */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "symtablesnapshot.h"
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/* Declaring an enum to hold the number of bindings tested. */
+enum{NUM_BINDINGS = 3000};
+
+/* The file the snapshots are written to. */
+static const char SNAPSHOT_PATH[] = "testsymtablesnapshot.snap";
+
+/* The number of tests that have failed. */
+static int numFailures = 0;
+
+/* If !iSuccessful, prints a message to stdout indicating that the
+   test at line iLineNum failed. */
+static void assure(int iSuccessful, int iLineNum) {
+   if (!iSuccessful) {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+      numFailures++;
+   }
+}
+
+/* Prints the heading of the test of what. */
+static void printHeading(const char *what) {
+   printf("------------------------------------------------------\n");
+   printf("Testing %s.\n", what);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+}
+
+/* Returns the bytes of value, a string, storing their number
+   (including the terminating null) in *length. */
+static const void *stringBytes(const void *value, size_t *length,
+                               void *extra) {
+   (void)extra;
+   *length = strlen((const char *)value) + 1;
+   return value;
+}
+
+/* Reads a uint32_t from stream into *number. Returns 1, or 0 at the
+   end of stream. */
+static int readU32(FILE *stream, uint32_t *number) {
+   return fread(number, sizeof(*number), 1, stream) == 1;
+}
+
+/* Parses the snapshot at path, checking each record against
+   symTable: its key must be bound there, to a string equal to the
+   value stored (or, if hasValues is 0, no value must be stored).
+   Returns the number of records that match, or -1 if the file
+   cannot be read or is malformed. */
+static int parseSnapshot(const char *path, SymTable_T symTable,
+                         int hasValues) {
+   FILE *stream;
+   char magic[8];
+   char key[64], value[64];
+   uint32_t keyLength, valueLength;
+   const char *expected;
+   int numMatched = 0;
+
+   stream = fopen(path, "rb");
+   if (stream == NULL) {
+      return -1;
+   }
+   if (fread(magic, 1, sizeof(magic), stream) != sizeof(magic) ||
+       memcmp(magic, "SYMSNAP1", sizeof(magic)) != 0) {
+      fclose(stream);
+      return -1;
+   }
+   while (readU32(stream, &keyLength)) {
+      if (keyLength >= sizeof(key) ||
+          fread(key, 1, keyLength, stream) != keyLength ||
+          !readU32(stream, &valueLength) ||
+          valueLength > sizeof(value) ||
+          fread(value, 1, valueLength, stream) != valueLength) {
+         fclose(stream);
+         return -1;
+      }
+      key[keyLength] = '\0';
+      expected = (const char *)SymTable_get(symTable, key);
+      if (expected != NULL &&
+          (hasValues ? valueLength == strlen(expected) + 1 &&
+                       memcmp(value, expected, valueLength) == 0 :
+                       valueLength == 0)) {
+         numMatched++;
+      }
+   }
+   fclose(stream);
+   return numMatched;
+}
+
+/* Tests writing a snapshot with values while the table changes, and
+   without values. */
+static void testRoundTrip(void) {
+   static char values[NUM_BINDINGS][32];
+   SymTable_T symTable, expected;
+   char key[32];
+   pid_t pid;
+   int i;
+
+   printHeading("SymTable_snapshotAsync");
+
+   symTable = SymTable_new();
+   expected = SymTable_new();
+   ASSURE(symTable != NULL && expected != NULL);
+   for (i = 0; i < NUM_BINDINGS; i++) {
+      sprintf(key, "key%d", i);
+      sprintf(values[i], "value %d", i);
+      ASSURE(SymTable_put(symTable, key, values[i]));
+      ASSURE(SymTable_put(expected, key, values[i]));
+   }
+
+   /* Changing the table after asking for the snapshot does not
+      change the snapshot. */
+   pid = SymTable_snapshotAsync(symTable, SNAPSHOT_PATH, stringBytes,
+                                NULL);
+   ASSURE(pid != -1);
+   ASSURE(SymTable_put(symTable, "added later", "x"));
+   ASSURE(SymTable_remove(symTable, "key0") == values[0]);
+   ASSURE(SymTable_snapshotWait(pid));
+   ASSURE(parseSnapshot(SNAPSHOT_PATH, expected, 1) == NUM_BINDINGS);
+   ASSURE(parseSnapshot(SNAPSHOT_PATH, symTable, 1) == NUM_BINDINGS - 1);
+
+   /* A snapshot of keys only replaces the last one. */
+   pid = SymTable_snapshotAsync(symTable, SNAPSHOT_PATH, NULL, NULL);
+   ASSURE(pid != -1);
+   ASSURE(SymTable_snapshotWait(pid));
+   ASSURE(parseSnapshot(SNAPSHOT_PATH, symTable, 0) == NUM_BINDINGS);
+   ASSURE(parseSnapshot(SNAPSHOT_PATH, expected, 0) == NUM_BINDINGS - 1);
+
+   /* A snapshot that cannot be written is reported. */
+   pid = SymTable_snapshotAsync(symTable, "no such directory/snapshot",
+                                NULL, NULL);
+   ASSURE(pid == -1 || !SymTable_snapshotWait(pid));
+
+   (void)remove(SNAPSHOT_PATH);
+   SymTable_free(symTable);
+   SymTable_free(expected);
+}
+
+int main(int argc, char *argv[]) {
+   (void)argc;
+
+   testRoundTrip();
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return numFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
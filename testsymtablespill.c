@@ -0,0 +1,129 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: testsymtablespill.c
+ *
+ *  Description: Tests the SymTableSpill data type (symtablespill.h)
+ *  with a memory budget of a single page frame, so that nearly every
+ *  operation writes a page back to the file and reads another.
+ ******************************************************************* */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "symtablespill.h"
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/* Declaring an enum to hold the number of bindings tested, enough
+   to fill many pages. */
+enum{NUM_BINDINGS = 5000};
+
+/* The number of tests that have failed. */
+static int numFailures = 0;
+
+/* If !iSuccessful, prints a message to stdout indicating that the
+   test at line iLineNum failed. */
+static void assure(int iSuccessful, int iLineNum) {
+   if (!iSuccessful) {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+      numFailures++;
+   }
+}
+
+/* Prints the heading of the test of what. */
+static void printHeading(const char *what) {
+   printf("------------------------------------------------------\n");
+   printf("Testing %s.\n", what);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+}
+
+/* Counts the binding in the int whose address is extra, if its value
+   is the string it should be. */
+static void checkBinding(const char *key, const void *value,
+                         size_t valueLength, void *extra) {
+   char expected[64];
+
+   sprintf(expected, "value of %s", key);
+   if (valueLength == strlen(expected) + 1 &&
+       memcmp(value, expected, valueLength) == 0) {
+      (*(int *)extra)++;
+   }
+}
+
+/* Returns 1 if the value of key in symTable is the string value, or
+   0 otherwise. */
+static int hasValue(SymTableSpill_T symTable, const char *key,
+                    const char *value) {
+   const void *found;
+   size_t valueLength;
+
+   found = SymTableSpill_get(symTable, key, &valueLength);
+   return found != NULL && valueLength == strlen(value) + 1 &&
+          memcmp(found, value, valueLength) == 0;
+}
+
+/* Tests a SymTableSpill that holds one page in memory. */
+static void testOneFrame(void) {
+   SymTableSpill_T symTable;
+   char key[32], value[64];
+   int i, numChecked = 0;
+
+   printHeading("a SymTableSpill with a budget of one frame");
+
+   symTable = SymTableSpill_new(".", 0);
+   ASSURE(symTable != NULL);
+   if (symTable == NULL) {
+      return;
+   }
+   for (i = 0; i < NUM_BINDINGS; i++) {
+      sprintf(key, "key%d", i);
+      sprintf(value, "value of %s", key);
+      ASSURE(SymTableSpill_put(symTable, key, value, strlen(value) + 1));
+   }
+   ASSURE(!SymTableSpill_put(symTable, "key0", "x", 2));
+   ASSURE(SymTableSpill_getLength(symTable) == NUM_BINDINGS);
+
+   /* Reading the keys back in an order unlike the one they were put
+      in, so that pages are evicted and read again. */
+   for (i = NUM_BINDINGS - 1; i >= 0; i -= 7) {
+      sprintf(key, "key%d", i);
+      sprintf(value, "value of %s", key);
+      ASSURE(hasValue(symTable, key, value));
+   }
+   ASSURE(!SymTableSpill_contains(symTable, "missing"));
+   ASSURE(SymTableSpill_get(symTable, "missing", NULL) == NULL);
+
+   /* Replacing values by longer and shorter ones, and removing. */
+   ASSURE(SymTableSpill_replace(symTable, "key1",
+                                "a much longer value than before", 32));
+   ASSURE(hasValue(symTable, "key1", "a much longer value than before"));
+   ASSURE(SymTableSpill_replace(symTable, "key2", "", 1));
+   ASSURE(hasValue(symTable, "key2", ""));
+   ASSURE(!SymTableSpill_replace(symTable, "missing", "", 1));
+   for (i = 3; i < NUM_BINDINGS; i += 2) {
+      sprintf(key, "key%d", i);
+      ASSURE(SymTableSpill_remove(symTable, key));
+   }
+   ASSURE(!SymTableSpill_remove(symTable, "key3"));
+   ASSURE(SymTableSpill_getLength(symTable) == NUM_BINDINGS / 2 + 1);
+
+   /* Visiting every binding, of which all but key1 and key2 keep
+      their values. */
+   ASSURE(SymTableSpill_map(symTable, checkBinding, &numChecked));
+   ASSURE(numChecked == NUM_BINDINGS / 2 - 1);
+   ASSURE(hasValue(symTable, "key4", "value of key4"));
+   SymTableSpill_free(symTable);
+}
+
+int main(int argc, char *argv[]) {
+   (void)argc;
+
+   testOneFrame();
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return numFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,137 @@
+/* *******************************************************************
+ *  Name:    Eesha Agarwal
+ *  NetID:   eagarwal
+ *  Precept: P08
+ *  Filename: testsymtableu64.c
+ *
+ *  Description: Tests the SymTableU64 data type (symtableu64.h),
+ *  including the extreme keys, growth, and removals that shift later
+ *  bindings of a run back.
+ ******************************************************************* */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "symtableu64.h"
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/* Declaring an enum to hold the number of bindings tested. */
+enum{NUM_BINDINGS = 20000};
+
+/* The number of tests that have failed. */
+static int numFailures = 0;
+
+/* If !iSuccessful, prints a message to stdout indicating that the
+   test at line iLineNum failed. */
+static void assure(int iSuccessful, int iLineNum) {
+   if (!iSuccessful) {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+      numFailures++;
+   }
+}
+
+/* Prints the heading of the test of what. */
+static void printHeading(const char *what) {
+   printf("------------------------------------------------------\n");
+   printf("Testing %s.\n", what);
+   printf("No output should appear here:\n");
+   fflush(stdout);
+}
+
+/* Adds key to the sum whose address is extra. */
+static void sumKey(uint64_t key, void *value, void *extra) {
+   (void)value;
+   *(uint64_t *)extra += key;
+}
+
+/* Returns the key of binding number i, spread over the whole range
+   of keys. */
+static uint64_t keyOf(int i) {
+   return (uint64_t)i * 0x9E3779B97F4A7C15ULL;
+}
+
+/* Tests the basic operations, with the keys 0 and UINT64_MAX. */
+static void testBasics(void) {
+   SymTableU64_T symTable;
+   char values[3];
+
+   printHeading("the basic SymTableU64 operations");
+
+   symTable = SymTableU64_new();
+   ASSURE(symTable != NULL);
+   ASSURE(SymTableU64_getLength(symTable) == 0);
+   ASSURE(SymTableU64_put(symTable, 0, &values[0]));
+   ASSURE(SymTableU64_put(symTable, UINT64_MAX, &values[1]));
+   ASSURE(!SymTableU64_put(symTable, 0, &values[2]));
+   ASSURE(SymTableU64_getLength(symTable) == 2);
+   ASSURE(SymTableU64_contains(symTable, 0));
+   ASSURE(!SymTableU64_contains(symTable, 1));
+   ASSURE(SymTableU64_get(symTable, UINT64_MAX) == &values[1]);
+   ASSURE(SymTableU64_replace(symTable, 0, &values[2]) == &values[0]);
+   ASSURE(SymTableU64_replace(symTable, 1, &values[2]) == NULL);
+   ASSURE(SymTableU64_get(symTable, 0) == &values[2]);
+   ASSURE(SymTableU64_remove(symTable, 0) == &values[2]);
+   ASSURE(SymTableU64_remove(symTable, 0) == NULL);
+   ASSURE(SymTableU64_put(symTable, 1, NULL));
+   ASSURE(SymTableU64_contains(symTable, 1));
+   ASSURE(SymTableU64_get(symTable, 1) == NULL);
+   ASSURE(SymTableU64_getLength(symTable) == 2);
+   SymTableU64_free(symTable);
+}
+
+/* Tests a table that grows, and removals in the middle of runs. */
+static void testLargeTable(void) {
+   SymTableU64_T symTable;
+   static char values[NUM_BINDINGS];
+   uint64_t sum = 0, expectedSum = 0;
+   int i;
+
+   printHeading("a large SymTableU64");
+
+   symTable = SymTableU64_new();
+   ASSURE(symTable != NULL);
+   for (i = 0; i < NUM_BINDINGS; i++) {
+      ASSURE(SymTableU64_put(symTable, keyOf(i), &values[i]));
+   }
+   ASSURE(SymTableU64_getLength(symTable) == NUM_BINDINGS);
+   for (i = 0; i < NUM_BINDINGS; i += 3) {
+      ASSURE(SymTableU64_remove(symTable, keyOf(i)) == &values[i]);
+   }
+   for (i = 0; i < NUM_BINDINGS; i++) {
+      if (i % 3 == 0) {
+         ASSURE(!SymTableU64_contains(symTable, keyOf(i)));
+      }
+      else {
+         ASSURE(SymTableU64_get(symTable, keyOf(i)) == &values[i]);
+         expectedSum += keyOf(i);
+      }
+   }
+   SymTableU64_map(symTable, sumKey, &sum);
+   ASSURE(sum == expectedSum);
+   ASSURE(SymTableU64_getLength(symTable) ==
+          NUM_BINDINGS - (NUM_BINDINGS + 2) / 3);
+
+   /* Dense keys, which fall into long runs of adjacent slots. */
+   for (i = 0; i < NUM_BINDINGS; i++) {
+      (void)SymTableU64_put(symTable, (uint64_t)i, &values[i]);
+   }
+   for (i = 0; i < NUM_BINDINGS; i += 2) {
+      ASSURE(SymTableU64_remove(symTable, (uint64_t)i) == &values[i]);
+   }
+   for (i = 1; i < NUM_BINDINGS; i += 2) {
+      ASSURE(SymTableU64_get(symTable, (uint64_t)i) == &values[i]);
+   }
+   SymTableU64_free(symTable);
+}
+
+int main(int argc, char *argv[]) {
+   (void)argc;
+
+   testBasics();
+   testLargeTable();
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return numFailures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}